@@ -0,0 +1,84 @@
+#include "batch.h"
+
+namespace lcp {
+
+	batch::batch(int lcp_level, size_t thread_number, bool use_map) : threads(thread_number) {
+		this->lcp_level = lcp_level;
+		this->use_map = use_map;
+		this->workers.resize(this->threads.size());
+	};
+
+	void batch::push(const char *begin, const char *end) {
+		this->begins.push_back(begin);
+		this->ends.push_back(end);
+	};
+
+	void batch::push(const std::string &read) {
+		this->push(read.data(), read.data() + read.size());
+	};
+
+	void batch::run(std::function<void(size_t, struct worker &)> fn) {
+
+		size_t read_count = this->size();
+		size_t slice_count = this->workers.size();
+
+		// one contiguous slice per worker, so that every buffer is used by a single thread
+		this->threads.run(slice_count, [&](size_t slice_index) {
+			struct worker &curr = this->workers[slice_index];
+
+			size_t first = read_count * slice_index / slice_count;
+			size_t last = read_count * (slice_index + 1) / slice_count;
+
+			for (size_t index = first; index < last; index++) {
+				curr.cores.parse(this->begins[index], this->ends[index], this->use_map);
+				curr.cores.deepen(this->lcp_level, curr.buffer, this->use_map);
+				fn(index, curr);
+			}
+		});
+	};
+
+	void batch::process(callback fn) {
+		this->run([&](size_t index, struct worker &curr) {
+			fn(index, curr.cores);
+		});
+	};
+
+	void batch::serialize() {
+
+		for (std::vector<struct worker>::iterator it = this->workers.begin(); it != this->workers.end(); it++) {
+			it->output.clear();
+		}
+
+		this->run([](size_t index, struct worker &curr) {
+			(void)index;
+			curr.cores.write(curr.output);
+		});
+	};
+
+	void batch::write(std::ofstream &out) {
+		this->serialize();
+
+		// slices are contiguous, so writing them in turn keeps the order of the reads
+		for (std::vector<struct worker>::iterator it = this->workers.begin(); it != this->workers.end(); it++) {
+			out.write(it->output.data(), it->output.size());
+		}
+	};
+
+	void batch::write(struct writer &out) {
+		this->serialize();
+
+		for (std::vector<struct worker>::iterator it = this->workers.begin(); it != this->workers.end(); it++) {
+			out.write(it->output);
+		}
+	};
+
+	void batch::clear() {
+		this->begins.clear();
+		this->ends.clear();
+	};
+
+	size_t batch::size() const {
+		return this->begins.size();
+	};
+
+}; // namespace lcp
@@ -0,0 +1,147 @@
+/**
+ * @file batch.h
+ * @brief Batched parsing of many short sequences, such as sequencing reads.
+ *
+ * The `batch` struct parses a set of reads to a target level without creating
+ * an `lps` object per read. Reads are split into one contiguous slice per
+ * thread, and every thread parses its slice into its own pair of `core_array`
+ * buffers, which are reused from read to read and from batch to batch. Once the
+ * buffers have grown to the size of the largest read, parsing a read does not
+ * allocate, and no shared state is touched unless the label dictionary is used.
+ *
+ * The threads are kept in a `parallel::pool`, so consecutive batches do not
+ * spawn threads again.
+ *
+ * Example usage:
+ * @code
+ *   lcp::batch reads(3, 8);
+ *   reads.push(read1);
+ *   reads.push(read2);
+ *   reads.process([&](size_t index, const lcp::core_array &cores) {
+ *       // use the cores of the read at index, called from a worker thread
+ *   });
+ *   reads.clear();
+ * @endcode
+ *
+ * @see core_array.h
+ * @see parallel.h
+ *
+ * @namespace lcp
+ * @struct batch
+ *
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "constant.h"
+#include "core_array.h"
+#include "parallel.h"
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lcp {
+
+	struct batch {
+	  public:
+		typedef std::function<void(size_t, const core_array &)> callback;
+
+		/**
+		 * @brief Constructs an empty batch.
+		 *
+		 * @param lcp_level The level the cores of every read are deepened to.
+		 * @param thread_number The number of threads parsing the reads (default is 1).
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 */
+		batch(int lcp_level, size_t thread_number = LCP_THREAD_NUMBER, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Adds a read to the batch.
+		 *
+		 * The characters are not copied and must stay valid until the batch is processed.
+		 *
+		 * @param begin Pointer to the first character of the read.
+		 * @param end Pointer past the last character of the read.
+		 */
+		void push(const char *begin, const char *end);
+
+		/**
+		 * @brief Adds a read held in a string to the batch, without copying it.
+		 *
+		 * @param read The read, which must stay valid until the batch is processed.
+		 */
+		void push(const std::string &read);
+
+		/**
+		 * @brief Parses every read and calls `fn` with its cores.
+		 *
+		 * `fn` is called from the thread that parsed the read, with the buffer of that
+		 * thread, which is overwritten by the next read. Reads of the same thread are
+		 * passed in order.
+		 *
+		 * @param fn Function receiving the index of the read and its cores.
+		 */
+		void process(callback fn);
+
+		/**
+		 * @brief Parses every read and writes one .lcpt record per read, in the order of the reads.
+		 *
+		 * Each thread serializes its records into its own reusable buffer, and the buffers
+		 * are written out one after another.
+		 *
+		 * @param out The output file stream to write to.
+		 */
+		void write(std::ofstream &out);
+
+		/**
+		 * @brief Parses every read and hands one .lcpt record per read to an asynchronous writer.
+		 *
+		 * Same as above, the buffers are copied into the writer, which writes them out while
+		 * the next batch is parsed.
+		 *
+		 * @param out The writer.
+		 */
+		void write(struct writer &out);
+
+		/**
+		 * @brief Removes every read while keeping the buffers for the next batch.
+		 */
+		void clear();
+
+		/**
+		 * @brief Returns the number of reads in the batch.
+		 *
+		 * @return size_t Number of reads.
+		 */
+		size_t size() const;
+
+	  private:
+		struct worker {
+			core_array cores;
+			core_array buffer;
+			std::string output;
+		};
+
+		int lcp_level;
+		bool use_map;
+		std::vector<const char *> begins;
+		std::vector<const char *> ends;
+		std::vector<struct worker> workers;
+		parallel::pool threads;
+
+		/**
+		 * @brief Parses the reads of every slice, calling `fn` with the worker of the slice.
+		 */
+		void run(std::function<void(size_t, struct worker &)> fn);
+
+		/**
+		 * @brief Parses the reads and serializes the records of every slice into its buffer.
+		 */
+		void serialize();
+	};
+
+}; // namespace lcp
+
+#endif
@@ -0,0 +1,210 @@
+/**
+ * @file bench.h
+ * @brief Minimal microbenchmark harness used by the programs in bench/.
+ *
+ * A benchmark is a function receiving a `bench::state`. It prepares its input,
+ * then repeats the measured work while `keep_running()` returns true:
+ *
+ * @code
+ *   void bm_example(lcp::bench::state &state) {
+ *       std::string sequence = lcp::bench::generate(state.input, state.size);
+ *       while (state.keep_running()) {
+ *           lcp::bench::keep(work(sequence));
+ *       }
+ *       state.items = sequence.size();
+ *   }
+ * @endcode
+ *
+ * The harness runs a benchmark with 1, 10, 100, ... iterations until a run takes
+ * at least the minimum time (the first program argument, 0.5 seconds by default),
+ * and prints that run as one JSON object per line:
+ *
+ *   {"name": ..., "input": ..., "size": ..., "iterations": ..., "ns_per_iteration": ...,
+ *    "items_per_second": ..., "bytes_per_second": ...}
+ *
+ * Inputs are generated from fixed seeds by the generator of tests/common.h, so
+ * every run measures the same data:
+ *
+ *   - `random`: uniformly random nucleotides,
+ *   - `repetitive`: copies of a 64 character unit with 1% point mutations.
+ *
+ * @namespace lcp::bench
+ *
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "../tests/common.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lcp {
+
+	namespace bench {
+
+		struct state {
+		  public:
+			std::string input;
+			size_t size;
+			size_t iterations;
+			size_t remaining;
+
+			// work done by a single iteration, used to report throughput
+			size_t items;
+			size_t bytes;
+
+			state(const std::string &input, size_t size, size_t iterations) : input(input), size(size), iterations(iterations), remaining(iterations), items(0), bytes(0), started(false) {};
+
+			/**
+			 * @brief Starts the clock on the first call and returns false once every iteration ran.
+			 */
+			inline bool keep_running() {
+				if (!this->started) {
+					this->started = true;
+					this->begin = std::chrono::steady_clock::now();
+				}
+
+				if (this->remaining == 0) {
+					this->finish = std::chrono::steady_clock::now();
+					return false;
+				}
+
+				this->remaining--;
+				return true;
+			};
+
+			/**
+			 * @brief Returns the measured time in seconds.
+			 */
+			inline double elapsed() const {
+				return std::chrono::duration<double>(this->finish - this->begin).count();
+			};
+
+		  private:
+			bool started;
+			std::chrono::steady_clock::time_point begin;
+			std::chrono::steady_clock::time_point finish;
+		};
+
+		typedef std::function<void(struct state &)> function;
+
+		/**
+		 * @brief Prevents the compiler from optimizing away a computed value.
+		 */
+		template <typename T>
+		inline void keep(const T &value) {
+			asm volatile("" : : "r,m"(value) : "memory");
+		};
+
+		/**
+		 * @brief Generates a deterministic nucleotide sequence.
+		 *
+		 * @param input Either "random" or "repetitive".
+		 * @param size The length of the sequence.
+		 * @return The generated sequence.
+		 */
+		inline std::string generate(const std::string &input, size_t size) {
+			if (input == "random") {
+				return generate_sequence(size, 42);
+			}
+
+			std::string sequence;
+			sequence.reserve(size);
+
+			lcg random(42);
+			auto next = [&random]() {
+				return random.next() >> 16;
+			};
+
+			std::string unit;
+			for (size_t i = 0; i < 64; i++) {
+				unit.push_back("ACGT"[next() % 4]);
+			}
+
+			for (size_t i = 0; i < size; i++) {
+				sequence.push_back(next() % 100 == 0 ? "ACGT"[next() % 4] : unit[i % unit.size()]);
+			}
+
+			return sequence;
+		};
+
+		/**
+		 * @brief Runs a benchmark and prints its fastest sufficient run as a JSON line.
+		 *
+		 * @param name The name of the benchmark.
+		 * @param input The input kind passed to the benchmark.
+		 * @param size The input size passed to the benchmark.
+		 * @param fn The benchmark.
+		 * @param min_time The minimum duration of the reported run, in seconds.
+		 */
+		inline void run(const std::string &name, const std::string &input, size_t size, function fn, double min_time) {
+
+			for (size_t iterations = 1;; iterations *= 10) {
+				struct state curr(input, size, iterations);
+				fn(curr);
+
+				if (curr.elapsed() < min_time && iterations < 1000000000) {
+					continue;
+				}
+
+				double seconds = curr.elapsed();
+				double total = static_cast<double>(curr.iterations);
+
+				printf("{\"name\": \"%s\", \"input\": \"%s\", \"size\": %zu, \"iterations\": %zu, \"ns_per_iteration\": %.1f, \"items_per_second\": %.1f, \"bytes_per_second\": %.1f}\n",
+					   name.c_str(), input.c_str(), size, curr.iterations, seconds * 1e9 / total,
+					   curr.items * total / seconds, curr.bytes * total / seconds);
+				fflush(stdout);
+
+				return;
+			}
+		};
+
+		/**
+		 * @brief Runs a benchmark for every input kind and size.
+		 */
+		inline void run(const std::string &name, const std::vector<size_t> &sizes, function fn, double min_time) {
+			const char *inputs[] = {"random", "repetitive"};
+
+			for (size_t input = 0; input < 2; input++) {
+				for (std::vector<size_t>::const_iterator it = sizes.begin(); it != sizes.end(); it++) {
+					run(name, inputs[input], *it, fn, min_time);
+				}
+			}
+		};
+
+		/**
+		 * @brief Returns the minimum run time given on the command line, 0.5 seconds by default.
+		 */
+		inline double min_time(int argc, char **argv) {
+			return argc > 1 ? atof(argv[1]) : 0.5;
+		};
+
+		/**
+		 * @brief Returns the input sizes given on the command line, 10^4, 10^5 and 10^6 by default.
+		 */
+		inline std::vector<size_t> sizes(int argc, char **argv) {
+			std::vector<size_t> result;
+
+			for (int i = 2; i < argc; i++) {
+				result.push_back(strtoull(argv[i], nullptr, 10));
+			}
+
+			if (result.empty()) {
+				result.push_back(10000);
+				result.push_back(100000);
+				result.push_back(1000000);
+			}
+
+			return result;
+		};
+
+	}; // namespace bench
+
+}; // namespace lcp
+
+#endif
@@ -0,0 +1,143 @@
+#include "bench.h"
+#include "core.h"
+#include "encoding.h"
+#include "hash.h"
+#include "lps.h"
+#include "rules.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Level 1 cores of the generated input, with their level 2 compressed neighbours.
+ */
+struct input {
+	std::string sequence;
+	lcp::lps *level1;
+	lcp::lps *level2;
+
+	input(const lcp::bench::state &state) : sequence(lcp::bench::generate(state.input, state.size)) {
+		this->level1 = new lcp::lps(this->sequence);
+		this->level2 = new lcp::lps(this->sequence);
+		this->level2->deepen(2);
+	};
+
+	~input() {
+		delete this->level1;
+		delete this->level2;
+	};
+};
+
+void bm_core_construction(lcp::bench::state &state) {
+	std::string sequence = lcp::bench::generate(state.input, state.size);
+	const char *begin = sequence.data();
+
+	// windows of 3 to 6 characters, the lengths of most level 1 cores
+	size_t count = 0;
+	while (state.keep_running()) {
+		count = 0;
+		for (const char *it = begin; it + 6 <= begin + sequence.size(); it += 2, count++) {
+			const char *end = it + 3 + count % 4;
+			lcp::core temp(it, end, lcp::char_index(begin, it, end), lcp::char_size, lcp::char_rep, lcp::char_data, false);
+			lcp::bench::keep(temp.label);
+		}
+	}
+
+	state.items = count;
+};
+
+void bm_core_compress(lcp::bench::state &state) {
+	struct input in(state);
+	const std::vector<lcp::core> &cores = *in.level2->cores;
+
+	// `core::compress` without the copy of the core, which it modifies
+	while (state.keep_running()) {
+		for (size_t index = 1; index < cores.size(); index++) {
+			ublock result;
+			lcp::bench::keep(lcp::compress_rep(cores[index].bit_rep, cores[index].bit_size, cores[index - 1].bit_rep, cores[index - 1].bit_size, result));
+			lcp::bench::keep(result);
+		}
+	}
+
+	state.items = cores.size() - 1;
+};
+
+void bm_core_compare(lcp::bench::state &state) {
+	struct input in(state);
+	const std::vector<lcp::core> &cores = *in.level1->cores;
+
+	// the three comparisons made by the parser for every pair of neighbours
+	while (state.keep_running()) {
+		size_t count = 0;
+		for (size_t index = 1; index < cores.size(); index++) {
+			count += cores[index - 1] == cores[index];
+			count += cores[index - 1] < cores[index];
+			count += cores[index - 1] > cores[index];
+		}
+		lcp::bench::keep(count);
+	}
+
+	state.items = 3 * (cores.size() - 1);
+};
+
+void bm_hash_emplace_string(lcp::bench::state &state) {
+	struct input in(state);
+	const char *begin = in.sequence.data();
+
+	std::vector<ulabel> keys;
+	for (const char *it = begin; it + 6 <= begin + in.sequence.size(); it += 2) {
+		keys.push_back(lcp::char_data(it, it + 3 + keys.size() % 4));
+	}
+
+	// every key is inserted before the clock starts, as in a warm dictionary
+	for (size_t index = 0; index < keys.size(); index++) {
+		lcp::hash::emplace(keys[index]);
+	}
+
+	while (state.keep_running()) {
+		for (size_t index = 0; index < keys.size(); index++) {
+			lcp::bench::keep(lcp::hash::emplace(keys[index]));
+		}
+	}
+
+	state.items = keys.size();
+};
+
+void bm_hash_emplace_core(lcp::bench::state &state) {
+	struct input in(state);
+	std::vector<lcp::core> &cores = *in.level1->cores;
+
+	std::vector<ulabel> keys;
+	for (std::vector<lcp::core>::iterator it = cores.begin() + 1; it + 3 <= cores.end(); it++) {
+		ulabel *data = lcp::core_data(it - 1, it + 3);
+		keys.insert(keys.end(), data, data + 4);
+	}
+
+	for (size_t index = 0; index < keys.size(); index += 4) {
+		lcp::hash::emplace(&keys[index]);
+	}
+
+	while (state.keep_running()) {
+		for (size_t index = 0; index < keys.size(); index += 4) {
+			lcp::bench::keep(lcp::hash::emplace(&keys[index]));
+		}
+	}
+
+	state.items = keys.size() / 4;
+};
+
+int main(int argc, char **argv) {
+
+	double min_time = lcp::bench::min_time(argc, argv);
+	std::vector<size_t> sizes = lcp::bench::sizes(argc, argv);
+
+	lcp::encoding::init(false);
+	lcp::hash::init();
+
+	lcp::bench::run("core_construction", sizes, bm_core_construction, min_time);
+	lcp::bench::run("core_compress", sizes, bm_core_compress, min_time);
+	lcp::bench::run("core_compare", sizes, bm_core_compare, min_time);
+	lcp::bench::run("hash_emplace_string", sizes, bm_hash_emplace_string, min_time);
+	lcp::bench::run("hash_emplace_core", sizes, bm_hash_emplace_core, min_time);
+
+	return 0;
+};
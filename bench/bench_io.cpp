@@ -0,0 +1,131 @@
+#include "bench.h"
+#include "core_array.h"
+#include "encoding.h"
+#include "hash.h"
+#include "lcpt.h"
+#include "lps.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+const char *filename = "bench_io.lcpt";
+
+/**
+ * @brief Returns the size of the file the benchmarks write, in bytes.
+ */
+size_t file_size() {
+	std::ifstream in(filename, std::ios::binary | std::ios::ate);
+	return static_cast<size_t>(in.tellg());
+};
+
+lcp::bench::function bm_lps_round_trip(int lcp_level) {
+	return [lcp_level](lcp::bench::state &state) {
+		std::string sequence = lcp::bench::generate(state.input, state.size);
+		lcp::lps cores(sequence);
+		cores.deepen(lcp_level);
+
+		while (state.keep_running()) {
+			std::ofstream out(filename, std::ios::binary);
+			cores.write(out);
+			out.close();
+
+			std::ifstream in(filename, std::ios::binary);
+			lcp::lps temp(in);
+			lcp::bench::keep(temp.size());
+		}
+
+		state.items = cores.size();
+		state.bytes = file_size();
+	};
+};
+
+lcp::bench::function bm_core_array_round_trip(int lcp_level) {
+	return [lcp_level](lcp::bench::state &state) {
+		std::string sequence = lcp::bench::generate(state.input, state.size);
+		lcp::core_array cores(sequence);
+		cores.deepen(lcp_level);
+
+		lcp::core_array temp;
+
+		while (state.keep_running()) {
+			std::ofstream out(filename, std::ios::binary);
+			cores.write(out);
+			out.close();
+
+			std::ifstream in(filename, std::ios::binary);
+			temp.read(in);
+			lcp::bench::keep(temp.size());
+		}
+
+		state.items = cores.size();
+		state.bytes = file_size();
+	};
+};
+
+lcp::bench::function bm_lcpt_buffer(int lcp_level) {
+	return [lcp_level](lcp::bench::state &state) {
+		std::string sequence = lcp::bench::generate(state.input, state.size);
+		lcp::core_array cores(sequence);
+		cores.deepen(lcp_level);
+
+		// serialization into a reused buffer, without the file system
+		std::string buffer;
+
+		while (state.keep_running()) {
+			buffer.clear();
+			cores.write(buffer);
+			lcp::bench::keep(buffer.size());
+		}
+
+		state.items = cores.size();
+		state.bytes = buffer.size();
+	};
+};
+
+lcp::bench::function bm_lcpt_view(int lcp_level) {
+	return [lcp_level](lcp::bench::state &state) {
+		std::string sequence = lcp::bench::generate(state.input, state.size);
+		lcp::core_array cores(sequence);
+		cores.deepen(lcp_level);
+
+		std::ofstream out(filename, std::ios::binary);
+		cores.write(out);
+		out.close();
+
+		// mapping the file and reading every label
+		while (state.keep_running()) {
+			lcp::lcpt::view file(filename);
+			ulabel sum = 0;
+			for (size_t index = 0; index < file.records[0].size(); index++) {
+				sum += file.records[0].labels[index];
+			}
+			lcp::bench::keep(sum);
+		}
+
+		state.items = cores.size();
+		state.bytes = file_size();
+	};
+};
+
+int main(int argc, char **argv) {
+
+	double min_time = lcp::bench::min_time(argc, argv);
+	std::vector<size_t> sizes = lcp::bench::sizes(argc, argv);
+
+	lcp::encoding::init(false);
+	lcp::hash::init();
+
+	for (int lcp_level = 1; lcp_level <= 4; lcp_level += 3) {
+		std::string suffix = "_level" + std::to_string(lcp_level);
+
+		lcp::bench::run("lps_round_trip" + suffix, sizes, bm_lps_round_trip(lcp_level), min_time);
+		lcp::bench::run("core_array_round_trip" + suffix, sizes, bm_core_array_round_trip(lcp_level), min_time);
+		lcp::bench::run("lcpt_buffer_write" + suffix, sizes, bm_lcpt_buffer(lcp_level), min_time);
+		lcp::bench::run("lcpt_view" + suffix, sizes, bm_lcpt_view(lcp_level), min_time);
+	}
+
+	remove(filename);
+
+	return 0;
+};
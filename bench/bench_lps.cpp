@@ -0,0 +1,67 @@
+#include "bench.h"
+#include "core_array.h"
+#include "encoding.h"
+#include "hash.h"
+#include "lps.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Parses the sequence and deepens it to the given level, so the cost of
+ * a single level is the difference between neighbouring levels.
+ */
+lcp::bench::function bm_lps_parse(int lcp_level, bool use_map) {
+	return [lcp_level, use_map](lcp::bench::state &state) {
+		std::string sequence = lcp::bench::generate(state.input, state.size);
+
+		while (state.keep_running()) {
+			lcp::lps temp(sequence, use_map);
+			temp.deepen(lcp_level, use_map);
+			lcp::bench::keep(temp.size());
+		}
+
+		state.items = sequence.size();
+		state.bytes = sequence.size();
+	};
+};
+
+lcp::bench::function bm_core_array_parse(int lcp_level) {
+	return [lcp_level](lcp::bench::state &state) {
+		std::string sequence = lcp::bench::generate(state.input, state.size);
+
+		// the buffers are reused by every iteration, as when parsing many reads
+		lcp::core_array cores, buffer;
+
+		while (state.keep_running()) {
+			cores.parse(sequence.data(), sequence.data() + sequence.size());
+			cores.deepen(lcp_level, buffer);
+			lcp::bench::keep(cores.size());
+		}
+
+		state.items = sequence.size();
+		state.bytes = sequence.size();
+	};
+};
+
+int main(int argc, char **argv) {
+
+	double min_time = lcp::bench::min_time(argc, argv);
+	std::vector<size_t> sizes = lcp::bench::sizes(argc, argv);
+
+	lcp::encoding::init(false);
+	lcp::hash::init();
+
+	for (int lcp_level = 1; lcp_level <= 5; lcp_level++) {
+		lcp::bench::run("lps_parse_level" + std::to_string(lcp_level), sizes, bm_lps_parse(lcp_level, false), min_time);
+	}
+
+	for (int lcp_level = 1; lcp_level <= 5; lcp_level++) {
+		lcp::bench::run("lps_parse_map_level" + std::to_string(lcp_level), sizes, bm_lps_parse(lcp_level, true), min_time);
+	}
+
+	for (int lcp_level = 1; lcp_level <= 5; lcp_level++) {
+		lcp::bench::run("core_array_parse_level" + std::to_string(lcp_level), sizes, bm_core_array_parse(lcp_level), min_time);
+	}
+
+	return 0;
+};
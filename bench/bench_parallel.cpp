@@ -0,0 +1,72 @@
+#include "batch.h"
+#include "bench.h"
+#include "constant.h"
+#include "encoding.h"
+#include "hash.h"
+#include "lps.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+lcp::bench::function bm_lps_split(int lcp_level, size_t thread_number) {
+	return [lcp_level, thread_number](lcp::bench::state &state) {
+		std::string sequence = lcp::bench::generate(state.input, state.size);
+
+		// segments small enough that every thread has several of them
+		size_t split = std::max(static_cast<size_t>(10000), sequence.size() / 16);
+
+		while (state.keep_running()) {
+			lcp::lps temp(sequence, lcp_level, split, OVERLAP_MARGIN, thread_number, false);
+			lcp::bench::keep(temp.size());
+		}
+
+		state.items = sequence.size();
+		state.bytes = sequence.size();
+	};
+};
+
+lcp::bench::function bm_batch(int lcp_level, size_t thread_number) {
+	return [lcp_level, thread_number](lcp::bench::state &state) {
+		std::string sequence = lcp::bench::generate(state.input, state.size);
+
+		// the sequence cut into reads of 150 characters
+		lcp::batch reads(lcp_level, thread_number);
+		for (size_t index = 0; index + 150 <= sequence.size(); index += 150) {
+			reads.push(sequence.data() + index, sequence.data() + index + 150);
+		}
+
+		while (state.keep_running()) {
+			reads.process([](size_t index, const lcp::core_array &cores) {
+				(void)index;
+				lcp::bench::keep(cores.size());
+			});
+		}
+
+		state.items = reads.size();
+		state.bytes = reads.size() * 150;
+	};
+};
+
+int main(int argc, char **argv) {
+
+	double min_time = lcp::bench::min_time(argc, argv);
+	std::vector<size_t> sizes = lcp::bench::sizes(argc, argv);
+
+	lcp::encoding::init(false);
+	lcp::hash::init();
+
+	std::vector<size_t> thread_numbers(1, 1);
+	for (size_t thread_number = 2; thread_number <= std::max(std::thread::hardware_concurrency(), 2u); thread_number *= 2) {
+		thread_numbers.push_back(thread_number);
+	}
+
+	for (std::vector<size_t>::iterator it = thread_numbers.begin(); it != thread_numbers.end(); it++) {
+		std::string suffix = "_threads" + std::to_string(*it);
+
+		lcp::bench::run("lps_split_level4" + suffix, sizes, bm_lps_split(4, *it), min_time);
+		lcp::bench::run("batch_level4" + suffix, sizes, bm_batch(4, *it), min_time);
+	}
+
+	return 0;
+};
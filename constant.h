@@ -3,8 +3,16 @@
 
 #include <cstdint>
 
+// blocks and labels are 64-bit wide when built with -DLCP_64BIT
+#ifdef LCP_64BIT
+typedef uint64_t ublock;
+typedef uint64_t ulabel;
+#define UBLOCK_BIT_SIZE         64
+#else
 typedef unsigned int ublock;
 typedef uint32_t ulabel;
+#define UBLOCK_BIT_SIZE         32
+#endif
 typedef uint32_t ubit_size;
 
 #define ASCII_SIZE              128
@@ -12,14 +20,26 @@ typedef uint32_t ubit_size;
 #define LCP_USE_MAP             false
 #define LCP_REV_COMP            false
 #define LCP_SHRINK_VECTOR       false
-#define UBLOCK_BIT_SIZE         32
 #define DCT_ITERATION_COUNT     1
 #define CONSTANT_FACTOR         1.5
 #define DICT_BIT_SIZE           2
 #define STR_HASH_TABLE_SIZE     1000
 #define CORE_HASH_TABLE_SIZE    10000
+#define DICT_SHARD_COUNT        64
+#define LABEL_BATCH_SIZE        256
 #define MAX_STR_LENGTH          1000000
 #define OVERLAP_MARGIN          10000
-#define MEMCOMP_CORES_SIZE      4 * sizeof(ublock)
+#define PIPELINE_BUFFER_SIZE    100000
+#define SIMD_CHUNK_SIZE         4096
+#define UPDATE_ANCHOR_SIZE      4
+#define UPDATE_MARGIN_CORES     32
+#define SKETCH_SIZE             1000
+#define LCP_THREAD_NUMBER       1
+#define DEEPEN_RANGE_SIZE       100000
+#define STATS_LEVEL_COUNT       16
+#define GAP_MIN_LENGTH          1
+#define WRITER_BUFFER_SIZE      (1 << 23)
+#define WRITER_BUFFER_COUNT     4
+#define MEMCOMP_CORES_SIZE      4 * sizeof(ulabel)
 
 #endif
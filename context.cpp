@@ -0,0 +1,59 @@
+#include "context.h"
+#include <algorithm>
+
+namespace lcp {
+
+	struct context context::instance;
+	thread_local struct context *context::bound = &context::instance;
+
+	context::context() : alphabet_bit_size(0), dna_alphabet(false), size(0), cores_size(0), next_id(0), labelling(LCP_HASH_BACKEND) {
+		std::fill(this->alphabet, this->alphabet + 256, 0);
+		std::fill(this->rc_alphabet, this->rc_alphabet + 256, 0);
+		std::fill(this->characters, this->characters + 128, 0);
+	};
+
+	void context::clear() {
+		this->str_map.clear();
+		this->cores_map.clear();
+		this->size = 0;
+		this->cores_size = 0;
+		this->next_id = 0;
+	};
+
+	void context::copy_encoding(const struct context &other) {
+		std::copy(other.alphabet, other.alphabet + 256, this->alphabet);
+		std::copy(other.rc_alphabet, other.rc_alphabet + 256, this->rc_alphabet);
+		std::copy(other.characters, other.characters + 128, this->characters);
+		this->alphabet_bit_size = other.alphabet_bit_size;
+		this->dna_alphabet = other.dna_alphabet;
+		this->labelling = other.labelling;
+	};
+
+	context::scope::scope(struct context &bound) : previous(context::bound) {
+		context::bound = &bound;
+	};
+
+	context::scope::~scope() {
+		context::bound = this->previous;
+	};
+
+	// state of earlier releases, the one of the global context
+
+	int (&alphabet)[256] = context::instance.alphabet;
+	int (&rc_alphabet)[256] = context::instance.rc_alphabet;
+	char (&characters)[128] = context::instance.characters;
+	int &alphabet_bit_size = context::instance.alphabet_bit_size;
+	bool &dna_alphabet = context::instance.dna_alphabet;
+
+	namespace hash {
+
+		dictionary<1> &str_map = context::instance.str_map;
+		dictionary<4> &cores_map = context::instance.cores_map;
+		std::atomic<size_t> &size = context::instance.size;
+		std::atomic<size_t> &cores_size = context::instance.cores_size;
+		std::atomic<ulabel> &next_id = context::instance.next_id;
+		enum backend &labelling = context::instance.labelling;
+
+	}; // namespace hash
+
+}; // namespace lcp
@@ -0,0 +1,132 @@
+/**
+ * @file context.h
+ * @brief Encoding and dictionary state of independent parsing workloads.
+ *
+ * A context owns everything a parse reads or updates besides its input: the
+ * alphabet tables set by `encoding::init`, the label dictionaries and their ID
+ * counter, and the label function selected by `hash::set_backend`. Workloads
+ * parsing in different contexts use their own alphabets and ID spaces, and do
+ * not contend on each other's dictionary locks.
+ *
+ * Every thread parses in its current context, the process-wide default one
+ * unless another context is bound to the thread with a `context::scope`. The
+ * alphabet tables, e.g. `lcp::alphabet`, and dictionaries, e.g.
+ * `lcp::hash::cores_map`, of earlier releases are the ones of the default
+ * context, so programs that never bind a context work as before. Worker threads
+ * of `lcp::parallel`, and hence of every parallel parsing mode, parse in the
+ * context of the thread that started them.
+ *
+ * Example usage:
+ * @code
+ *   lcp::context tenant;
+ *   {
+ *       lcp::context::scope bind(tenant);
+ *       lcp::encoding::init(map, rc_map);
+ *       lcp::lps str(sequence, 4, true);   // labels from the IDs of tenant
+ *   }
+ *   tenant.clear();                        // frees the dictionaries of tenant
+ * @endcode
+ *
+ * @namespace lcp
+ * @struct context
+ *
+ * @note A context must outlive the threads it is bound to, and cores labelled
+ * with its dictionaries are only comparable to cores of the same context.
+ *
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "constant.h"
+#include "hash.h"
+#include <atomic>
+#include <cstddef>
+
+namespace lcp {
+
+	struct context {
+	  public:
+		// encoding, see encoding.h
+		int alphabet[256];
+		int rc_alphabet[256];
+		char characters[128];
+		int alphabet_bit_size;
+		bool dna_alphabet;
+
+		// dictionaries, see hash.h
+		hash::dictionary<1> str_map;
+		hash::dictionary<4> cores_map;
+		std::atomic<size_t> size;
+		std::atomic<size_t> cores_size;
+		std::atomic<ulabel> next_id;
+
+		// label function, see hash::set_backend
+		enum hash::backend labelling;
+
+		/**
+		 * @brief Binds a context to the calling thread until the scope is left.
+		 *
+		 * Scopes nest, leaving a scope binds the context that was current before it.
+		 */
+		struct scope {
+		  public:
+			scope(struct context &bound);
+			~scope();
+
+			scope(const struct scope &other) = delete;
+			struct scope &operator=(const struct scope &other) = delete;
+
+		  private:
+			struct context *previous;
+		};
+
+		/**
+		 * @brief Constructs a context with empty dictionaries and no alphabet.
+		 *
+		 * Like the process before `encoding::init`, the alphabet has to be initialized
+		 * with one of the `encoding::init` functions while the context is bound. The
+		 * label function is `LCP_HASH_BACKEND` of the build.
+		 */
+		context();
+
+		context(const struct context &other) = delete;
+		struct context &operator=(const struct context &other) = delete;
+
+		/**
+		 * @brief Frees the dictionaries and restarts IDs at 0, keeping the alphabet.
+		 *
+		 * No thread may parse in the context meanwhile, and labels assigned before are
+		 * reassigned to other cores afterwards.
+		 */
+		void clear();
+
+		/**
+		 * @brief Takes the alphabet and the label function of another context, keeping the dictionaries.
+		 *
+		 * @param other The context whose encoding is copied.
+		 */
+		void copy_encoding(const struct context &other);
+
+		/**
+		 * @brief Returns the context of the calling thread.
+		 */
+		static inline struct context &current() {
+			return *bound;
+		};
+
+		/**
+		 * @brief Returns the process-wide context threads parse in unless another is bound.
+		 */
+		static inline struct context &global() {
+			return instance;
+		};
+
+		// the global context and the context of the thread, use the functions above
+		static struct context instance;
+		static thread_local struct context *bound;
+	};
+
+}; // namespace lcp
+
+#endif
@@ -28,6 +28,30 @@ namespace lcp {
 		this->bit_rep = bit_rep;
 		this->label = label;
 
+		if (bit_size <= UBLOCK_BIT_SIZE && bit_rep != nullptr) {
+			this->inline_rep = bit_size ? bit_rep[0] : 0;
+			this->bit_rep = &this->inline_rep;
+			delete[] bit_rep;
+		}
+
+#ifdef STATS
+		this->start = start;
+		this->end = end;
+#else
+		(void)start;
+		(void)end;
+#endif
+	};
+
+	core::core(const ublock *bit_rep, ubit_size bit_size, ulabel label, size_t start, size_t end) {
+		size_t block_number = (bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+
+		this->bit_size = bit_size;
+		this->inline_rep = 0;
+		this->bit_rep = block_number <= 1 ? &this->inline_rep : new ublock[block_number];
+		std::copy(bit_rep, bit_rep + block_number, this->bit_rep);
+		this->label = label;
+
 #ifdef STATS
 		this->start = start;
 		this->end = end;
@@ -44,54 +68,149 @@ namespace lcp {
 #endif
 		in.read(reinterpret_cast<char *>(&bit_size), sizeof(bit_size));
 		size_t block_number = (bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
-		this->bit_rep = new ublock[block_number];
+		this->inline_rep = 0;
+		this->bit_rep = block_number <= 1 ? &this->inline_rep : new ublock[block_number];
 		in.read(reinterpret_cast<char *>(bit_rep), block_number * sizeof(ublock));
 		in.read(reinterpret_cast<char *>(&label), sizeof(label));
 	};
 
+	core::core(const struct core &other) {
+		size_t block_number = (other.bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+
+		this->bit_size = other.bit_size;
+		this->inline_rep = 0;
+		this->bit_rep = nullptr;
+
+		if (other.bit_rep != nullptr) {
+			this->bit_rep = block_number <= 1 ? &this->inline_rep : new ublock[block_number];
+			std::copy(other.bit_rep, other.bit_rep + block_number, this->bit_rep);
+		}
+
+		this->label = other.label;
+
+#ifdef STATS
+		this->start = other.start;
+		this->end = other.end;
+#endif
+	};
+
+	core::core(struct core &&other) noexcept {
+		this->take(other);
+	};
+
 	core::~core() {
-		if (this->bit_rep != nullptr) {
+		if (this->bit_rep != nullptr && !this->is_inline()) {
 			delete[] this->bit_rep;
 		}
 	};
 
-	void core::compress(const struct core &other) {
+	void core::take(struct core &other) {
+		this->bit_size = other.bit_size;
+		this->inline_rep = other.inline_rep;
+		this->bit_rep = other.is_inline() ? &this->inline_rep : other.bit_rep;
+		this->label = other.label;
 
-		ubit_size index = std::min(this->bit_size, other.bit_size);
-		ubit_size t_block = (this->bit_size - 1) / UBLOCK_BIT_SIZE,
-				 o_block = (other.bit_size - 1) / UBLOCK_BIT_SIZE;
+#ifdef STATS
+		this->start = other.start;
+		this->end = other.end;
+#endif
+
+		other.bit_size = 0;
+		other.bit_rep = nullptr;
+	};
+
+	static inline ubit_size trailing_zeros(ublock block) {
+#ifdef LCP_64BIT
+		return __builtin_ctzll(block);
+#else
+		return __builtin_ctz(block);
+#endif
+	};
+
+	static inline ubit_size bit_length(ublock block) {
+#ifdef LCP_64BIT
+		return UBLOCK_BIT_SIZE - __builtin_clzll(block);
+#else
+		return UBLOCK_BIT_SIZE - __builtin_clz(block);
+#endif
+	};
+
+	// first differing bit of two blocks within the lowest `index` bits, and the bit of `block` there
+	static inline ubit_size compress_block(ublock block, ublock other_block, ubit_size index, ubit_size offset, ublock &result) {
+
+		ublock difference = block ^ other_block;
+		ubit_size shift = difference == 0 ? index : std::min(trailing_zeros(difference), index);
+
+		// shift left by 1 bit and set last bit to difference
+		result = 2 * static_cast<ublock>(offset + shift) + (shift < UBLOCK_BIT_SIZE ? (block >> shift) & 1 : 0);
+
+		ubit_size result_size = result > 0 ? bit_length(result) : 0;
+		return result_size > 1 ? result_size : 2;
+	};
+
+	ubit_size compress_rep(const ublock *bit_rep, ubit_size bit_size, const ublock *other_bit_rep, ubit_size other_bit_size, ublock &result) {
+
+		ubit_size index = std::min(bit_size, other_bit_size);
+		ubit_size t_block = (bit_size - 1) / UBLOCK_BIT_SIZE,
+				  o_block = (other_bit_size - 1) / UBLOCK_BIT_SIZE;
+
+		// only the highest block of a sequence is partially used, so the shorter
+		// sequence ends up with a single block in most cases
+		if (t_block == 0 && o_block == 0 && index < UBLOCK_BIT_SIZE) {
+			return compress_block(bit_rep[0], other_bit_rep[0], index, 0, result);
+		}
 
-		while (index >= UBLOCK_BIT_SIZE && this->bit_rep[t_block] == other.bit_rep[o_block]) {
+		while (index >= UBLOCK_BIT_SIZE && bit_rep[t_block] == other_bit_rep[o_block]) {
 			t_block--;
 			o_block--;
 			index -= UBLOCK_BIT_SIZE;
 		}
 
-		t_block = this->bit_rep[t_block];
-		o_block = other.bit_rep[o_block];
+		// a block index wraps around only if every block of a sequence is equal
+		ublock block = t_block <= (bit_size - 1) / UBLOCK_BIT_SIZE ? bit_rep[t_block] : 0;
+		ublock other_block = o_block <= (other_bit_size - 1) / UBLOCK_BIT_SIZE ? other_bit_rep[o_block] : 0;
 
-		while (index > 0 && t_block % 2 == o_block % 2) {
-			t_block /= 2;
-			o_block /= 2;
-			index--;
+		return compress_block(block, other_block, index, std::min(bit_size, other_bit_size) - index, result);
+	};
+
+	void compress_reps(const ublock *reps, const ubit_size *bit_sizes, size_t count, ublock *results, ubit_size *result_sizes) {
+
+		if (count < 2) {
+			return;
 		}
 
-		if (this->bit_size > UBLOCK_BIT_SIZE) {
-			delete[] this->bit_rep;
-			this->bit_rep = new ublock[1];
+		// the left neighbour is kept in registers, so the results may overwrite the input
+		ublock left = reps[0];
+		ubit_size left_size = bit_sizes[0];
+
+		for (size_t index = 1; index < count; index++) {
+			ublock curr = reps[index];
+			ubit_size curr_size = bit_sizes[index];
+			ubit_size size = std::min(curr_size, left_size);
+
+			// two equal full blocks leave no bit to compare, as after the block loop of `compress_rep`
+			ublock result;
+			result_sizes[index] = size < UBLOCK_BIT_SIZE || curr != left ? compress_block(curr, left, size, 0, result) : compress_block(0, 0, 0, size, result);
+			results[index] = result;
+
+			left = curr;
+			left_size = curr_size;
 		}
+	};
 
-		this->bit_rep[0] = 0;
+	void core::compress(const struct core &other) {
 
-		// shift left by 1 bit and set last bit to difference
-		this->bit_rep[0] = 2 * (std::min(this->bit_size, other.bit_size) - index) + (t_block % 2);
-		this->bit_size = 0;
+		ublock result;
+		ubit_size result_size = compress_rep(this->bit_rep, this->bit_size, other.bit_rep, other.bit_size, result);
 
-		if (this->bit_rep[0] > 0) {
-			this->bit_size = (32 - __builtin_clz(this->bit_rep[0]));
+		// compressed representation always fits into the inline block
+		if (!this->is_inline()) {
+			delete[] this->bit_rep;
+			this->bit_rep = &this->inline_rep;
 		}
 
-		this->bit_size = this->bit_size > 1 ? this->bit_size : 2;
+		this->bit_rep[0] = result;
+		this->bit_size = result_size;
 	};
 
 	void core::write(std::ofstream &out) const {
@@ -105,15 +224,18 @@ namespace lcp {
 	};
 
 	size_t core::memsize() const {
+		if (this->is_inline()) {
+			return sizeof(*this);
+		}
 		return sizeof(*this) + sizeof(ublock) * ((this->bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE);
 	};
 
 	struct core &core::operator=(const struct core &other) {
-		if (*this == other) {
+		if (this == &other) {
 			return *this;
 		}
 
-		if (this->bit_rep) {
+		if (this->bit_rep != nullptr && !this->is_inline()) {
 			delete[] this->bit_rep;
 		}
 
@@ -126,9 +248,10 @@ namespace lcp {
 
 		this->bit_size = other.bit_size;
 
-		if (this->bit_size) {
-			this->bit_rep = new ublock[(other.bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE];
-			std::copy(other.bit_rep, other.bit_rep + ((other.bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE) * sizeof(ublock), this->bit_rep);
+		if (other.bit_rep != nullptr) {
+			size_t block_number = (other.bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+			this->bit_rep = block_number <= 1 ? &this->inline_rep : new ublock[block_number];
+			std::copy(other.bit_rep, other.bit_rep + block_number, this->bit_rep);
 		}
 
 		this->label = other.label;
@@ -136,119 +259,43 @@ namespace lcp {
 		return *this;
 	};
 
-	// core operator overloads
-	bool operator==(const struct core &lhs, const struct core &rhs) {
-
-		if (lhs.bit_size != rhs.bit_size) {
-			return false;
+	struct core &core::operator=(struct core &&other) noexcept {
+		if (this == &other) {
+			return *this;
 		}
 
-		ubit_size index = 0;
+		if (this->bit_rep != nullptr && !this->is_inline()) {
+			delete[] this->bit_rep;
+		}
 
-		while (index < lhs.bit_size) {
-			if (lhs.bit_rep[index / UBLOCK_BIT_SIZE] != rhs.bit_rep[index / UBLOCK_BIT_SIZE])
-				return false;
+		this->take(other);
 
-			index += UBLOCK_BIT_SIZE;
-		}
+		return *this;
+	};
 
-		return true;
+	// core operator overloads
+	bool operator==(const struct core &lhs, const struct core &rhs) {
+		return lhs.bit_size == rhs.bit_size && compare_blocks(lhs.bit_rep, rhs.bit_rep, lhs.bit_size) == 0;
 	};
 
 	bool operator!=(const struct core &lhs, const struct core &rhs) {
-
-		if (lhs.bit_size != rhs.bit_size) {
-			return true;
-		}
-
-		ubit_size index = 0;
-
-		while (index < lhs.bit_size) {
-			if (lhs.bit_rep[index / UBLOCK_BIT_SIZE] != rhs.bit_rep[index / UBLOCK_BIT_SIZE])
-				return true;
-
-			index += UBLOCK_BIT_SIZE;
-		}
-
-		return false;
+		return !(lhs == rhs);
 	};
 
 	bool operator>(const struct core &lhs, const struct core &rhs) {
-
-		if (lhs.bit_size != rhs.bit_size) {
-			return lhs.bit_size > rhs.bit_size;
-		}
-
-		ubit_size index = 0;
-
-		while (index < lhs.bit_size) {
-			if (lhs.bit_rep[index / UBLOCK_BIT_SIZE] == rhs.bit_rep[index / UBLOCK_BIT_SIZE]) {
-				index += UBLOCK_BIT_SIZE;
-				continue;
-			}
-
-			return lhs.bit_rep[index / UBLOCK_BIT_SIZE] > rhs.bit_rep[index / UBLOCK_BIT_SIZE];
-		}
-
-		return false;
+		return compare(lhs, rhs) > 0;
 	};
 
 	bool operator<(const struct core &lhs, const struct core &rhs) {
-
-		if (lhs.bit_size != rhs.bit_size) {
-			return lhs.bit_size < rhs.bit_size;
-		}
-
-		ubit_size index = 0;
-
-		while (index < lhs.bit_size) {
-			if (lhs.bit_rep[index / UBLOCK_BIT_SIZE] == rhs.bit_rep[index / UBLOCK_BIT_SIZE]) {
-				index += UBLOCK_BIT_SIZE;
-				continue;
-			}
-
-			return lhs.bit_rep[index / UBLOCK_BIT_SIZE] < rhs.bit_rep[index / UBLOCK_BIT_SIZE];
-		}
-
-		return false;
+		return compare(lhs, rhs) < 0;
 	};
 
 	bool operator>=(const struct core &lhs, const struct core &rhs) {
-
-		if (lhs.bit_size != rhs.bit_size) {
-			return lhs.bit_size >= rhs.bit_size;
-		}
-
-		ubit_size index = 0;
-
-		while (index < lhs.bit_size) {
-			if (lhs.bit_rep[index / UBLOCK_BIT_SIZE] != rhs.bit_rep[index / UBLOCK_BIT_SIZE]) {
-				return lhs.bit_size > rhs.bit_size;
-			}
-
-			index += UBLOCK_BIT_SIZE;
-		}
-
-		return true;
+		return compare(lhs, rhs) >= 0;
 	};
 
 	bool operator<=(const struct core &lhs, const struct core &rhs) {
-
-		if (lhs.bit_size != rhs.bit_size) {
-			return lhs.bit_size < rhs.bit_size;
-		}
-
-		ubit_size index = 0;
-
-		while (index < lhs.bit_size) {
-			if (lhs.bit_rep[index / UBLOCK_BIT_SIZE] != rhs.bit_rep[index / UBLOCK_BIT_SIZE]) {
-				return lhs.bit_size < rhs.bit_size;
-			}
-
-			index += UBLOCK_BIT_SIZE;
-		}
-
-		return true;
+		return compare(lhs, rhs) <= 0;
 	};
 
 	std::ostream &operator<<(std::ostream &os, const struct core &element) {
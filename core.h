@@ -38,6 +38,8 @@
  * @note Define `STATS` before including this file to enable the tracking of
  * start and end indices for sequences.
  * @note Destructor handles clean-up of allocated memory for bits.
+ * @note Representations that fit into a single block are stored inline, so
+ * most cores, and every core after compression, require no heap allocation.
  *
  * @author Akmuhammet Ashyralyyev
  * @version 1.0
@@ -58,10 +60,126 @@
 
 namespace lcp {
 
+	/**
+	 * @brief Concatenates the representations of the elements in [begin, end) into
+	 * consecutive blocks.
+	 *
+	 * The last element occupies the least significant bits of the last block, and
+	 * every preceding element is pasted to its left. `bit_rep` must hold at least
+	 * `block_number` zeroed blocks.
+	 *
+	 * @param begin Iterator pointing to the first element.
+	 * @param end Iterator pointing past the last element.
+	 * @param size Function returning the bit length of an element.
+	 * @param rep Function returning the blocks of an element.
+	 * @param bit_rep The destination blocks.
+	 * @param block_number The number of destination blocks.
+	 */
+	template <typename Iterator, typename Size, typename Representation>
+	inline void pack(Iterator begin, Iterator end, Size size, Representation rep, ublock *bit_rep, size_t block_number) {
+
+		size_t shift = 0;
+		int block_index = block_number - 1;
+
+		for (Iterator it = end - 1; begin <= it; it--) {
+
+			const ublock *o_bit_rep = rep(it);
+
+			for (int i = (size(it) - 1) / UBLOCK_BIT_SIZE; 0 <= i; i--) {
+
+				size_t curr_block_size = (i > 0 ? UBLOCK_BIT_SIZE : size(it) % UBLOCK_BIT_SIZE);
+
+				// shift and paste
+				bit_rep[block_index] |= (o_bit_rep[i] << shift);
+
+				// if there is an overflow after shifting, it pastes the
+				// overfloaw to the left block.
+				if (shift + curr_block_size > UBLOCK_BIT_SIZE) {
+					bit_rep[block_index - 1] |= (o_bit_rep[i] >> (UBLOCK_BIT_SIZE - shift));
+				}
+
+				if (shift + curr_block_size >= UBLOCK_BIT_SIZE) {
+					block_index--;
+				}
+
+				shift = (shift + curr_block_size) % UBLOCK_BIT_SIZE;
+			}
+		}
+	};
+
+	/**
+	 * @brief Same as `pack` for characters of the default alphabet, which are single codes of
+	 * `dna_bit_size` bits.
+	 *
+	 * Since a code never straddles two blocks, the characters are visited once from the
+	 * first to the last and each code is pasted straight into its block, without the overflow
+	 * handling of the general case. Level 1 cores usually fit into one block, which is then
+	 * accumulated in a register. Codes of characters outside the alphabet are blocks of set bits
+	 * and fill their block up to its left end, as in `pack`.
+	 */
+	template <typename Iterator, typename Representation>
+	inline void pack(Iterator begin, Iterator end, struct dna_width size, Representation rep, ublock *bit_rep, size_t block_number) {
+		(void)size;
+
+		// codes are shifted in from the right, the leftmost ones drop out as in `pack`
+		if (block_number == 1) {
+			ublock bits = 0;
+			for (Iterator it = begin; it < end; it++) {
+				bits = (bits << dna_bit_size) | *rep(it);
+			}
+			bit_rep[0] |= bits;
+			return;
+		}
+
+		size_t position = dna_bit_size * (end - begin);
+
+		for (Iterator it = begin; it < end; it++) {
+			position -= dna_bit_size;
+			bit_rep[block_number - 1 - position / UBLOCK_BIT_SIZE] |= *rep(it) << (position % UBLOCK_BIT_SIZE);
+		}
+	};
+
+	/**
+	 * @brief Computes the DCT representation of a bit sequence with respect to its
+	 * left neighbour.
+	 *
+	 * The result encodes the position of the first differing bit from the right,
+	 * shifted left by one, together with the value of that bit in `bit_rep`.
+	 * Equal blocks are skipped from the right, and the differing bit within the
+	 * first unequal block is found from the trailing zeros of their XOR.
+	 *
+	 * @param bit_rep The blocks of the sequence to be compressed.
+	 * @param bit_size The bit length of the sequence to be compressed.
+	 * @param other_bit_rep The blocks of the left neighbour.
+	 * @param other_bit_size The bit length of the left neighbour.
+	 * @param result The block receiving the compressed representation.
+	 * @return The bit length of the compressed representation.
+	 */
+	ubit_size compress_rep(const ublock *bit_rep, ubit_size bit_size, const ublock *other_bit_rep, ubit_size other_bit_size, ublock &result);
+
+	/**
+	 * @brief Computes the DCT representations of a span of single-block sequences.
+	 *
+	 * Same as `compress_rep` for every sequence from the second one on, each with
+	 * respect to the sequence before it. The sequences are read from left to right
+	 * and the left neighbour is kept in registers, so the results may overwrite the
+	 * input; the first entries of `results` and `result_sizes` are not written. A
+	 * larger span is split into independent parts by starting each part at the last
+	 * sequence of the part before it.
+	 *
+	 * @param reps The blocks of the sequences, one per sequence.
+	 * @param bit_sizes The bit lengths of the sequences, at most `UBLOCK_BIT_SIZE` each.
+	 * @param count The number of sequences.
+	 * @param results The blocks receiving the compressed representations.
+	 * @param result_sizes The bit lengths of the compressed representations.
+	 */
+	void compress_reps(const ublock *reps, const ubit_size *bit_sizes, size_t count, ublock *results, ubit_size *result_sizes);
+
 	struct core {
 	  public:
 		// Represenation related variables
 		ubit_size bit_size;
+		ublock inline_rep;
 		ublock *bit_rep;
 
 		// Other variables
@@ -89,38 +207,13 @@ namespace lcp {
 				this->bit_size += size(it);
 			}
 
-			// allocate memory for representation
+			// allocate memory for representation, single blocks are stored inline
 			size_t block_number = (this->bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
-			this->bit_rep = new ublock[block_number];
+			this->inline_rep = 0;
+			this->bit_rep = block_number <= 1 ? &this->inline_rep : new ublock[block_number];
 			memset(this->bit_rep, 0, block_number * sizeof(ublock));
 
-			size_t shift = 0;
-			int block_index = block_number - 1;
-
-			for (Iterator it = end - 1; begin <= it; it--) {
-
-				ublock *o_bit_rep = rep(it);
-
-				for (int i = (size(it) - 1) / UBLOCK_BIT_SIZE; 0 <= i; i--) {
-
-					size_t curr_block_size = (i > 0 ? UBLOCK_BIT_SIZE : size(it) % UBLOCK_BIT_SIZE);
-
-					// shift and paste
-					this->bit_rep[block_index] |= (o_bit_rep[i] << shift);
-
-					// if there is an overflow after shifting, it pastes the
-					// overfloaw to the left block.
-					if (shift + curr_block_size > UBLOCK_BIT_SIZE) {
-						this->bit_rep[block_index - 1] |= (o_bit_rep[i] >> (UBLOCK_BIT_SIZE - shift));
-					}
-
-					if (shift + curr_block_size >= UBLOCK_BIT_SIZE) {
-						block_index--;
-					}
-
-					shift = (shift + curr_block_size) % UBLOCK_BIT_SIZE;
-				}
-			}
+			pack(begin, end, size, rep, this->bit_rep, block_number);
 
 			if (!use_map) {
 				this->label = hash::simple(data(begin, end));
@@ -133,7 +226,10 @@ namespace lcp {
 		 * @brief Constructs a `core` object from raw bit data.
 		 *
 		 * This constructor initializes a `core` object with a given pointer to
-		 * a bit sequence, and sets its size, start, and end indices.
+		 * a bit sequence, and sets its size, start, and end indices. The core
+		 * takes ownership of `bit_rep`, which must be allocated with `new[]`.
+		 * Representations that fit into a single block are moved into inline
+		 * storage and `bit_rep` is released immediately.
 		 *
 		 * @param bit_size The size of the bit sequence.
 		 * @param bit_rep The pointer to the bit representation of the sequence.
@@ -143,6 +239,22 @@ namespace lcp {
 		 */
 		core(size_t bit_size, ublock *bit_rep, ulabel label, size_t start, size_t end);
 
+		/**
+		 * @brief Constructs a `core` object by copying raw bit data.
+		 *
+		 * Unlike the owning constructor, `bit_rep` is not taken over, so the
+		 * blocks may live in any buffer (e.g. a memory-mapped file).
+		 * Representations that fit into a single block are copied into inline
+		 * storage without any allocation.
+		 *
+		 * @param bit_rep The pointer to the bit representation of the sequence.
+		 * @param bit_size The size of the bit sequence.
+		 * @param label The label/identifier of the core.
+		 * @param start The starting index of the sequence.
+		 * @param end The ending index of the sequence.
+		 */
+		core(const ublock *bit_rep, ubit_size bit_size, ulabel label, size_t start, size_t end);
+
 		/**
 		 * @brief Constructs a `core` object by reading from an input file
 		 * stream.
@@ -155,6 +267,25 @@ namespace lcp {
 		 */
 		core(std::ifstream &in);
 
+		/**
+		 * @brief Copy constructor for the `core` struct.
+		 *
+		 * Performs a deep copy of the `other` core's representation.
+		 *
+		 * @param other The `core` instance to copy from.
+		 */
+		core(const struct core &other);
+
+		/**
+		 * @brief Move constructor for the `core` struct.
+		 *
+		 * Takes over the representation of `other` without copying heap
+		 * allocated blocks. `other` is left empty.
+		 *
+		 * @param other The `core` instance to move from.
+		 */
+		core(struct core &&other) noexcept;
+
 		~core();
 
 		/**
@@ -205,6 +336,97 @@ namespace lcp {
 		 * @return A reference to the current `core` instance.
 		 */
 		struct core &operator=(const struct core &other);
+
+		/**
+		 * @brief Move assignment operator for the `core` struct.
+		 *
+		 * Releases the current representation and takes over the
+		 * representation of `other` without copying heap allocated blocks.
+		 * `other` is left empty.
+		 *
+		 * @param other The `core` instance to move from.
+		 * @return A reference to the current `core` instance.
+		 */
+		struct core &operator=(struct core &&other) noexcept;
+
+		/**
+		 * @brief Checks whether the representation is stored inline.
+		 *
+		 * Representations that fit into a single block are kept inside the
+		 * `core` object itself, so they need no heap allocation.
+		 *
+		 * @return True if `bit_rep` points to the inline storage.
+		 */
+		inline bool is_inline() const {
+			return this->bit_rep == &this->inline_rep;
+		};
+
+	  private:
+		/**
+		 * @brief Takes over the representation of another core, leaving it
+		 * empty.
+		 *
+		 * @param other The `core` instance to take the representation from.
+		 */
+		void take(struct core &other);
+	};
+
+	/**
+	 * @brief Three-way comparison of two representations of the same bit size.
+	 *
+	 * Blocks are stored from the most significant one, so the representations are
+	 * compared as fixed-width keys. Up to 64 bits, i.e. every representation after
+	 * `compress`, the blocks are loaded into a single word and compared once; longer
+	 * representations are compared block by block like `memcmp`.
+	 *
+	 * @param lhs The blocks of the left-hand side representation.
+	 * @param rhs The blocks of the right-hand side representation.
+	 * @param bit_size The bit size of both representations.
+	 * @return A negative value if `lhs` is smaller, zero if both are equal, and a
+	 * positive value if `lhs` is greater.
+	 */
+	inline int compare_blocks(const ublock *lhs, const ublock *rhs, ubit_size bit_size) {
+
+		if (bit_size <= 64) {
+#if UBLOCK_BIT_SIZE == 64
+			uint64_t key1 = lhs[0], key2 = rhs[0];
+#else
+			uint64_t key1 = lhs[0], key2 = rhs[0];
+			if (UBLOCK_BIT_SIZE < bit_size) {
+				key1 = (key1 << UBLOCK_BIT_SIZE) | lhs[1];
+				key2 = (key2 << UBLOCK_BIT_SIZE) | rhs[1];
+			}
+#endif
+			return (key1 > key2) - (key1 < key2);
+		}
+
+		const ublock *last = lhs + (bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+
+		for (; lhs < last; lhs++, rhs++) {
+			if (*lhs != *rhs) {
+				return *lhs < *rhs ? -1 : 1;
+			}
+		}
+
+		return 0;
+	};
+
+	/**
+	 * @brief Three-way comparison of two `core` objects, in the order of the
+	 * comparison operators: by bit size first, then by representation.
+	 *
+	 * @param lhs The left-hand side `core` object.
+	 * @param rhs The right-hand side `core` object.
+	 * @return A negative value if `lhs` is smaller, zero if both are equal, and a
+	 * positive value if `lhs` is greater.
+	 */
+	inline int compare(const struct core &lhs, const struct core &rhs) {
+
+		if (lhs.bit_size != rhs.bit_size) {
+			return lhs.bit_size < rhs.bit_size ? -1 : 1;
+		}
+
+		return compare_blocks(lhs.bit_rep, rhs.bit_rep, lhs.bit_size);
 	};
 
 	// core operator overloads
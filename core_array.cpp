@@ -0,0 +1,751 @@
+#include "core_array.h"
+#include "lps.h"
+#include <algorithm>
+
+namespace lcp {
+
+	core_array::core_array(bool positions) {
+		this->level = 1;
+		this->positions = positions;
+		this->label_flags = 0;
+	};
+
+	core_array::core_array(const char *begin, const char *end, bool use_map, bool positions) {
+
+		this->positions = positions;
+		this->label_flags = 0;
+		this->parse(begin, end, use_map);
+	};
+
+	core_array::core_array(std::string &str, bool use_map, bool positions) : core_array(str.data(), str.data() + str.size(), use_map, positions) {};
+
+	core_array::core_array(const char *begin, const char *end, const std::vector<struct gap> &gaps, bool use_map, bool positions) {
+
+		this->positions = positions;
+		this->label_flags = 0;
+		this->parse(begin, end, gaps, use_map);
+	};
+
+	core_array::core_array(const std::vector<struct core> &cores, int level, uint16_t label_flags) {
+
+		this->level = level;
+		this->label_flags = label_flags;
+#ifdef STATS
+		this->positions = true;
+#else
+		this->positions = false;
+#endif
+
+		this->reserve(cores.size());
+
+		for (std::vector<struct core>::const_iterator it = cores.begin(); it != cores.end(); it++) {
+
+			size_t block_number = (it->bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+			block_number = block_number > 1 ? block_number : 1;
+
+			if (block_number > 1 && this->offsets.empty()) {
+				this->expand();
+			}
+
+			if (it->bit_size > 0 && it->bit_rep != nullptr) {
+				this->blocks.insert(this->blocks.end(), it->bit_rep, it->bit_rep + block_number);
+			} else {
+				this->blocks.push_back(0);
+			}
+
+			if (!this->offsets.empty()) {
+				this->offsets.push_back(this->blocks.size());
+			}
+
+			this->bit_sizes.push_back(it->bit_size);
+			this->labels.push_back(it->label);
+
+#ifdef STATS
+			this->starts.push_back(it->start);
+			this->ends.push_back(it->end);
+#endif
+		}
+	};
+
+	core_array::core_array(const lcpt::record &rec) {
+		this->level = rec.level;
+		this->positions = rec.starts != nullptr;
+		this->label_flags = rec.label_flags;
+		this->gaps.assign(rec.gaps, rec.gaps + rec.gap_count);
+
+		this->labels.assign(rec.labels, rec.labels + rec.size());
+		this->bit_sizes.assign(rec.bit_sizes, rec.bit_sizes + rec.size());
+		this->blocks.assign(rec.blocks, rec.blocks + rec.block_count);
+
+		if (rec.offsets != nullptr) {
+			this->offsets.assign(rec.offsets, rec.offsets + rec.size() + 1);
+		}
+
+		if (this->positions) {
+			this->starts.assign(rec.starts, rec.starts + rec.size());
+			this->ends.assign(rec.ends, rec.ends + rec.size());
+		}
+	};
+
+	void core_array::parse(const char *begin, const char *end, bool use_map) {
+
+		this->clear();
+		this->level = 1;
+		this->label_flags = lcpt::labelling(1, use_map);
+
+		if (end <= begin) {
+			return;
+		}
+
+		this->reserve((end - begin) / CONSTANT_FACTOR);
+
+		stats::stage parsing(1, stats::PARSE_TIME);
+		lps::parse_alphabet(begin, end, this, use_map);
+		parsing.stop();
+
+		if (stats::enabled()) {
+			stats::count_bytes(this->level, this->memsize());
+		}
+	};
+
+	void core_array::parse(const char *begin, const char *end, const std::vector<struct gap> &gaps, bool use_map) {
+
+		this->clear();
+		this->level = 1;
+		this->label_flags = lcpt::labelling(1, use_map);
+		this->gaps = gaps;
+
+		if (end <= begin) {
+			return;
+		}
+
+		this->reserve((end - begin) / CONSTANT_FACTOR);
+
+		stats::stage parsing(1, stats::PARSE_TIME);
+
+		size_t segment_begin = 0;
+
+		for (size_t index = 0; index <= this->gaps.size(); index++) {
+
+			size_t segment_end = index < this->gaps.size() ? this->gaps[index].start : end - begin;
+			size_t first = this->size();
+
+			if (segment_begin < segment_end) {
+				lps::parse_alphabet(begin + segment_begin, begin + segment_end, this, use_map);
+			}
+
+			// positions of a segment are relative to its beginning
+			for (size_t core_index = first; this->positions && core_index < this->size(); core_index++) {
+				this->starts[core_index] += segment_begin;
+				this->ends[core_index] += segment_begin;
+			}
+
+			if (index < this->gaps.size()) {
+				this->gaps[index].index = this->size();
+				segment_begin = this->gaps[index].start + this->gaps[index].length;
+			}
+		}
+
+		parsing.stop();
+
+		if (stats::enabled()) {
+			stats::count_bytes(this->level, this->memsize());
+		}
+	};
+
+	void core_array::expand() {
+		this->offsets.resize(this->size() + 1);
+
+		for (size_t index = 0; index < this->offsets.size(); index++) {
+			this->offsets[index] = index;
+		}
+	};
+
+	bool core_array::dct() {
+
+		// at least 2 cores are needed for compression
+		if (this->size() < DCT_ITERATION_COUNT + 2) {
+			return false;
+		}
+
+		// every core owns a single block, compressed in one pass over the columns
+		if (this->offsets.empty()) {
+			for (size_t dct_index = 0; dct_index < DCT_ITERATION_COUNT; dct_index++) {
+				compress_reps(this->blocks.data() + dct_index, this->bit_sizes.data() + dct_index, this->size() - dct_index, this->blocks.data() + dct_index, this->bit_sizes.data() + dct_index);
+			}
+			return true;
+		}
+
+		// compressed representation overwrites the first block of the core, its left
+		// neighbour is not compressed yet as cores are processed from right to left
+		for (size_t dct_index = 0; dct_index < DCT_ITERATION_COUNT; dct_index++) {
+			for (size_t index = this->size() - 1; dct_index < index; index--) {
+				ublock *curr = &this->blocks[this->block_offset(index)];
+				const ublock *left = &this->blocks[this->block_offset(index - 1)];
+				this->bit_sizes[index] = compress_rep(curr, this->bit_sizes[index], left, this->bit_sizes[index - 1], *curr);
+			}
+		}
+
+		// compact blocks, only the uncompressed cores at the beginning can span multiple blocks
+		bool single = true;
+		size_t block_index = 0;
+
+		for (size_t index = 0; index < this->size(); index++) {
+
+			size_t block_number = (this->bit_sizes[index] + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+			block_number = block_number > 1 ? block_number : 1;
+			single = single && block_number == 1;
+
+			size_t offset = this->offsets[index];
+			this->offsets[index] = block_index;
+
+			for (size_t i = 0; i < block_number; i++) {
+				this->blocks[block_index++] = this->blocks[offset + i];
+			}
+		}
+
+		this->offsets.back() = block_index;
+		this->blocks.resize(block_index);
+
+		if (single) {
+			this->offsets.clear();
+		}
+
+		return true;
+	};
+
+	bool core_array::deepen(bool use_map, size_t thread_number) {
+		core_array temp(this->positions);
+		return this->deepen(temp, use_map, thread_number);
+	};
+
+	bool core_array::deepen(struct core_array &buffer, bool use_map, size_t thread_number) {
+
+		if (!this->gaps.empty()) {
+			return this->deepen_segments(buffer, use_map, thread_number);
+		}
+
+		// Compress cores
+		stats::stage compressing(this->level + 1, stats::DCT_TIME);
+
+		if (!this->dct()) {
+			this->clear();
+			return false;
+		}
+
+		compressing.stop();
+
+		// Find new cores
+		buffer.clear();
+		buffer.positions = this->positions;
+		buffer.reserve(this->size() / CONSTANT_FACTOR);
+
+		// IDs of the dictionary are given in the order of the serial parse
+		if (1 < thread_number && !use_map && 2 * DEEPEN_RANGE_SIZE <= this->size()) {
+			this->parse_ranges(buffer, thread_number);
+		} else {
+			stats::stage parsing(this->level + 1, stats::PARSE_TIME);
+			lps::parse(this->begin() + DCT_ITERATION_COUNT, this->end(), &buffer, DCT_ITERATION_COUNT, array_compare, array_index, array_size, array_rep, array_data, use_map);
+			buffer.hash_labels();
+		}
+
+		buffer.level = this->level + 1;
+		buffer.label_flags = lcpt::labelling(buffer.level, use_map);
+
+		// Remove old cores
+		this->swap(buffer);
+
+		if (stats::enabled()) {
+			stats::count_bytes(this->level, this->memsize());
+		}
+
+		return true;
+	};
+
+	/**
+	 * @brief Cores found in a range of a level, with where the first of them starts and the end of
+	 * the last of them, like `range_cores` of lps.cpp.
+	 */
+	struct range_array {
+		core_array cores;
+		core_array::iterator first;
+		core_array::iterator last_end;
+
+		range_array(core_array::iterator end, bool positions) : cores(positions), first(end), last_end(end) {};
+
+		template <typename... Args>
+		void emplace_back(core_array::iterator begin, core_array::iterator end, Args &&...args) {
+			if (this->cores.size() == 0) {
+				this->first = begin;
+			}
+			this->cores.emplace_back(begin, end, std::forward<Args>(args)...);
+		};
+	};
+
+	void core_array::parse_ranges(struct core_array &buffer, size_t thread_number) {
+
+		const iterator begin = this->begin() + DCT_ITERATION_COUNT, end = this->end();
+		const int next_level = this->level + 1;
+
+		// positions processed by parse, see parse_range
+		const size_t first = DCT_ITERATION_COUNT, count = end - (begin + first);
+		const size_t range_count = std::min(thread_number, count / DEEPEN_RANGE_SIZE);
+		std::vector<struct range_array> ranges(range_count, range_array(end, this->positions));
+
+		parallel::run(range_count, thread_number, [&](size_t range) {
+			iterator it1 = begin + first + count * range / range_count;
+			iterator stop = begin + first + count * (range + 1) / range_count;
+
+			// no core ends before the range, so the first core has no substring core in front of it
+			struct range_array &result = ranges[range];
+			result.cores.reserve((stop - it1) / CONSTANT_FACTOR);
+
+			stats::stage parsing(next_level, stats::PARSE_TIME);
+			lps::parse_span(begin, it1, result.last_end, stop, end, true, &result, DCT_ITERATION_COUNT, array_compare, array_index, array_size, array_rep, array_data, false);
+			result.cores.hash_labels();
+		});
+
+		stats::stage joining(next_level, stats::PARSE_TIME);
+
+		// end of the last core of the ranges joined so far
+		iterator it2 = end;
+
+		for (std::vector<struct range_array>::iterator range = ranges.begin(); range != ranges.end(); range++) {
+
+			if (range->cores.size() == 0) {
+				continue;
+			}
+
+			iterator it1 = range->first + DCT_ITERATION_COUNT;
+
+			// the substring core is labelled before the cores of the range are appended after it
+			if (isSSEQ(it1, it2)) {
+				buffer.emplace_back(it2 - 1 - DCT_ITERATION_COUNT, it1 + 1, array_index(begin, it2 - 1 - DCT_ITERATION_COUNT, it1 + 1), array_size, array_rep, array_data, false);
+				buffer.hash_labels();
+
+				if (stats::enabled()) {
+					stats::count_rules(0, 0, 0, 1);
+				}
+			}
+
+			buffer.append(range->cores, 0, range->cores.size(), 0);
+			core_array().swap(range->cores);
+
+			it2 = range->last_end;
+		}
+	};
+
+	bool core_array::deepen_segments(struct core_array &buffer, bool use_map, size_t thread_number) {
+
+		buffer.clear();
+		buffer.positions = this->positions;
+		buffer.reserve(this->size() / CONSTANT_FACTOR);
+
+		// every segment is copied out and deepened on its own, as if it were a sequence of its own
+		core_array segment(this->positions), temp(this->positions);
+		std::vector<struct gap> next_gaps(this->gaps);
+		size_t first = 0;
+
+		for (size_t index = 0; index <= this->gaps.size(); index++) {
+
+			size_t last = index < this->gaps.size() ? this->gaps[index].index : this->size();
+
+			segment.clear();
+			segment.level = this->level;
+			segment.append(*this, first, last, 0);
+
+			if (segment.deepen(temp, use_map, thread_number)) {
+				buffer.append(segment, 0, segment.size(), 0);
+			}
+
+			if (index < this->gaps.size()) {
+				next_gaps[index].index = buffer.size();
+			}
+
+			first = last;
+		}
+
+		// no segment is long enough for the next level
+		if (buffer.size() == 0) {
+			this->clear();
+			return false;
+		}
+
+		buffer.level = this->level + 1;
+		buffer.label_flags = lcpt::labelling(buffer.level, use_map);
+		buffer.gaps.swap(next_gaps);
+
+		this->swap(buffer);
+
+		return true;
+	};
+
+	bool core_array::deepen(int lcp_level, bool use_map, size_t thread_number) {
+		core_array temp(this->positions);
+		return this->deepen(lcp_level, temp, use_map, thread_number);
+	};
+
+	bool core_array::deepen(int lcp_level, struct core_array &buffer, bool use_map, size_t thread_number) {
+
+		if (lcp_level <= this->level)
+			return false;
+
+		while (this->level < lcp_level && this->deepen(buffer, use_map, thread_number))
+			;
+
+		return true;
+	};
+
+	bool core_array::update(const char *begin, const char *end, size_t position, size_t removed, size_t inserted, bool use_map) {
+
+		const size_t length = end - begin;
+		const std::ptrdiff_t shift = static_cast<std::ptrdiff_t>(inserted) - static_cast<std::ptrdiff_t>(removed);
+		const int lcp_level = this->level;
+
+		// anchors are located by positions
+		if (!this->positions || this->size() == 0) {
+			core_array temp(begin, end, use_map, this->positions);
+			temp.deepen(lcp_level, use_map);
+			this->swap(temp);
+			return false;
+		}
+
+		// start with a margin of UPDATE_MARGIN_CORES cores on both sides
+		size_t margin = UPDATE_MARGIN_CORES * ((this->ends.back() - this->starts.front()) / this->size() + 1);
+
+		while (true) {
+
+			size_t window_begin = position < margin ? 0 : position - margin;
+			size_t window_end = position + inserted + margin < length ? position + inserted + margin : length;
+			bool whole = window_begin == 0 && window_end == length;
+
+			core_array window(begin + window_begin, begin + window_end, use_map, true);
+			window.deepen(lcp_level, use_map);
+
+			if (whole) {
+				this->swap(window);
+				return false;
+			}
+
+			// too few cores in the window to reach the level
+			if (window.level != lcp_level) {
+				margin *= 2;
+				continue;
+			}
+
+			for (size_t index = 0; index < window.size(); index++) {
+				window.starts[index] += window_begin;
+				window.ends[index] += window_begin;
+			}
+
+			// old cores [0, first) and [last, size) are kept, window cores [other_first, other_last) are taken
+			size_t first = 0, other_first = 0, last = this->size(), other_last = window.size();
+			bool found_left = window_begin == 0, found_right = window_end == length;
+
+			// leftmost anchor before the edit, away from the left border of the window
+			for (size_t index = 0; !found_left && index + UPDATE_ANCHOR_SIZE <= window.size() && window.ends[index + UPDATE_ANCHOR_SIZE - 1] <= position; index++) {
+
+				if (window.starts[index] < window_begin + margin / 2) {
+					continue;
+				}
+
+				size_t other = std::lower_bound(this->starts.begin(), this->starts.end(), window.starts[index]) - this->starts.begin();
+
+				for (; !found_left && other < this->size() && this->starts[other] == window.starts[index]; other++) {
+
+					size_t count = 0;
+					while (count < UPDATE_ANCHOR_SIZE && other + count < this->size() && this->same(other + count, window, index + count, 0)) {
+						count++;
+					}
+
+					if (count == UPDATE_ANCHOR_SIZE) {
+						found_left = true;
+						first = other;
+						other_first = index;
+					}
+				}
+			}
+
+			// rightmost anchor after the edit, away from the right border of the window
+			for (size_t index = window.size(); !found_right && other_first + 2 * UPDATE_ANCHOR_SIZE <= index && position + inserted <= window.starts[index - UPDATE_ANCHOR_SIZE]; index--) {
+
+				if (window_end - margin / 2 < window.ends[index - 1]) {
+					continue;
+				}
+
+				size_t target = window.starts[index - 1] - shift;
+				size_t other = std::upper_bound(this->starts.begin(), this->starts.end(), target) - this->starts.begin();
+
+				for (; !found_right && 0 < other && this->starts[other - 1] == target; other--) {
+
+					size_t count = 0;
+					while (count < UPDATE_ANCHOR_SIZE && count < other && this->same(other - 1 - count, window, index - 1 - count, shift)) {
+						count++;
+					}
+
+					if (count == UPDATE_ANCHOR_SIZE) {
+						found_right = true;
+						last = other;
+						other_last = index;
+					}
+				}
+			}
+
+			if (!found_left || !found_right) {
+				margin *= 2;
+				continue;
+			}
+
+			// splice the window between the anchors
+			core_array result(true);
+			result.level = lcp_level;
+			result.label_flags = window.label_flags;
+			result.reserve(first + (other_last - other_first) + (this->size() - last));
+
+			result.append(*this, 0, first, 0);
+			result.append(window, other_first, other_last, 0);
+			result.append(*this, last, this->size(), shift);
+
+			this->swap(result);
+
+			return true;
+		}
+	};
+
+	bool core_array::stitch(const struct core_array &next, size_t cut) {
+
+		if (!this->positions || !next.positions || this->level != next.level || this->size() == 0) {
+			return false;
+		}
+
+		size_t index = std::lower_bound(next.starts.begin(), next.starts.end(), cut) - next.starts.begin();
+
+		for (; index + UPDATE_ANCHOR_SIZE <= next.size() && next.starts[index] <= this->starts.back(); index++) {
+
+			size_t other = std::lower_bound(this->starts.begin(), this->starts.end(), next.starts[index]) - this->starts.begin();
+
+			for (; other < this->size() && this->starts[other] == next.starts[index]; other++) {
+
+				size_t count = 0;
+				while (count < UPDATE_ANCHOR_SIZE && other + count < this->size() && this->same(other + count, next, index + count, 0)) {
+					count++;
+				}
+
+				if (count == UPDATE_ANCHOR_SIZE) {
+					this->truncate(other);
+					this->append(next, index, next.size(), 0);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	};
+
+	void core_array::truncate(size_t size) {
+
+		this->blocks.resize(this->block_offset(size));
+
+		if (!this->offsets.empty()) {
+			this->offsets.resize(size + 1);
+		}
+
+		this->labels.resize(size);
+		this->bit_sizes.resize(size);
+
+		if (this->positions) {
+			this->starts.resize(size);
+			this->ends.resize(size);
+		}
+	};
+
+	void core_array::append(const struct core_array &other, size_t first, size_t last, std::ptrdiff_t shift) {
+
+		for (size_t index = first; index < last; index++) {
+
+			size_t block_begin = other.block_offset(index);
+			size_t block_end = other.offsets.empty() ? index + 1 : other.offsets[index + 1];
+
+			if (block_end - block_begin > 1 && this->offsets.empty()) {
+				this->expand();
+			}
+
+			this->blocks.insert(this->blocks.end(), other.blocks.begin() + block_begin, other.blocks.begin() + block_end);
+
+			if (!this->offsets.empty()) {
+				this->offsets.push_back(this->blocks.size());
+			}
+
+			this->labels.push_back(other.labels[index]);
+			this->bit_sizes.push_back(other.bit_sizes[index]);
+
+			if (this->positions) {
+				this->starts.push_back(other.starts[index] + shift);
+				this->ends.push_back(other.ends[index] + shift);
+			}
+		}
+	};
+
+	bool core_array::same(size_t index, const struct core_array &other, size_t other_index, std::ptrdiff_t shift) const {
+
+		if (this->labels[index] != other.labels[other_index] || this->bit_sizes[index] != other.bit_sizes[other_index] ||
+			this->starts[index] + shift != other.starts[other_index] || this->ends[index] + shift != other.ends[other_index]) {
+			return false;
+		}
+
+		size_t block_number = (this->bit_sizes[index] + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+		block_number = block_number > 1 ? block_number : 1;
+
+		const ublock *rep = &this->blocks[this->block_offset(index)];
+		const ublock *other_rep = &other.blocks[other.block_offset(other_index)];
+
+		return std::equal(rep, rep + block_number, other_rep);
+	};
+
+	struct core core_array::get(size_t index) const {
+
+		size_t start = this->positions ? this->starts[index] : 0;
+		size_t end = this->positions ? this->ends[index] : 0;
+
+		return core(&this->blocks[this->block_offset(index)], this->bit_sizes[index], this->labels[index], start, end);
+	};
+
+	bool core_array::get_labels(std::vector<ulabel> &labels) const {
+		labels.insert(labels.end(), this->labels.begin(), this->labels.end());
+		return true;
+	};
+
+	lcpt::record core_array::columns() const {
+		lcpt::record rec;
+
+		rec.level = this->level;
+		rec.label_flags = this->label_flags;
+		rec.core_count = this->size();
+		rec.block_count = this->blocks.size();
+		rec.labels = this->labels.data();
+		rec.bit_sizes = this->bit_sizes.data();
+		rec.blocks = this->blocks.data();
+		rec.gaps = this->gaps.data();
+		rec.gap_count = this->gaps.size();
+		rec.offsets = this->offsets.empty() ? nullptr : reinterpret_cast<const uint64_t *>(this->offsets.data());
+
+		if (this->positions) {
+			rec.starts = reinterpret_cast<const uint64_t *>(this->starts.data());
+			rec.ends = reinterpret_cast<const uint64_t *>(this->ends.data());
+		}
+
+		return rec;
+	};
+
+	void core_array::write(std::ofstream &out, const std::string &name) const {
+		lcpt::record rec = this->columns();
+		rec.name = name.data();
+		rec.name_length = name.size();
+		lcpt::write(out, rec);
+	};
+
+	void core_array::write(std::string &out, const std::string &name) const {
+		lcpt::record rec = this->columns();
+		rec.name = name.data();
+		rec.name_length = name.size();
+		lcpt::write(out, rec);
+	};
+
+	void core_array::write(struct writer &out, const std::string &name) const {
+		lcpt::record rec = this->columns();
+		rec.name = name.data();
+		rec.name_length = name.size();
+		out.write(rec);
+	};
+
+	bool core_array::read(std::ifstream &in) {
+		lcpt::header hdr;
+
+		if (!lcpt::read_header(in, hdr, nullptr, &this->gaps)) {
+			return false;
+		}
+
+		this->level = hdr.level;
+		this->positions = hdr.flags & LCPT_POSITIONS;
+		this->label_flags = hdr.flags & LCPT_LABELS;
+
+		lcpt::read_section(in, this->labels, hdr.size);
+		lcpt::read_section(in, this->bit_sizes, hdr.size);
+		lcpt::read_section(in, this->blocks, hdr.block_count);
+
+		this->offsets.clear();
+		this->starts.clear();
+		this->ends.clear();
+
+		if (hdr.flags & LCPT_OFFSETS) {
+			lcpt::read_section(in, this->offsets, hdr.size + 1);
+		}
+
+		if (this->positions) {
+			lcpt::read_section(in, this->starts, hdr.size);
+			lcpt::read_section(in, this->ends, hdr.size);
+		}
+
+		return true;
+	};
+
+	void core_array::reserve(size_t size) {
+		this->labels.reserve(size);
+		this->bit_sizes.reserve(size);
+		this->blocks.reserve(size);
+
+		if (this->positions) {
+			this->starts.reserve(size);
+			this->ends.reserve(size);
+		}
+	};
+
+	void core_array::clear() {
+		this->labels.clear();
+		this->bit_sizes.clear();
+		this->blocks.clear();
+		this->offsets.clear();
+		this->starts.clear();
+		this->ends.clear();
+		this->gaps.clear();
+		this->pending.clear();
+	};
+
+	void core_array::hash_labels() {
+		size_t count = this->pending.size() / 4;
+
+		if (count != 0) {
+			hash::simple(this->pending.data(), count, this->labels.data() + this->labels.size() - count);
+			this->pending.clear();
+		}
+	};
+
+	void core_array::swap(struct core_array &other) {
+		std::swap(this->level, other.level);
+		std::swap(this->positions, other.positions);
+		std::swap(this->label_flags, other.label_flags);
+		this->labels.swap(other.labels);
+		this->bit_sizes.swap(other.bit_sizes);
+		this->blocks.swap(other.blocks);
+		this->offsets.swap(other.offsets);
+		this->starts.swap(other.starts);
+		this->ends.swap(other.ends);
+		this->gaps.swap(other.gaps);
+		this->pending.swap(other.pending);
+	};
+
+	double core_array::memsize() const {
+		double total = sizeof(*this);
+
+		total += this->labels.size() * sizeof(ulabel);
+		total += this->bit_sizes.size() * sizeof(ubit_size);
+		total += this->blocks.size() * sizeof(ublock);
+		total += this->offsets.size() * sizeof(size_t);
+		total += this->starts.size() * sizeof(size_t);
+		total += this->ends.size() * sizeof(size_t);
+		total += this->gaps.size() * sizeof(struct gap);
+
+		return total;
+	};
+
+}; // namespace lcp
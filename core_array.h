@@ -0,0 +1,527 @@
+/**
+ * @file core_array.h
+ * @brief Column-oriented storage for the cores of a single LCP level.
+ *
+ * The `core_array` struct keeps the cores of one level in parallel arrays
+ * instead of a vector of `core` objects. Labels, bit lengths and packed
+ * representations are each stored contiguously, so the per-core overhead of
+ * `core` (inline block, representation pointer, padding) disappears and the
+ * comparisons performed while parsing walk densely packed memory.
+ *
+ * Representations of every core are concatenated in `blocks`. As long as all
+ * cores fit into a single block, which is the case for every core after
+ * compression, core `i` simply owns `blocks[i]` and no offset table is kept.
+ * The first core that needs more than one block materializes `offsets`, where
+ * core `i` owns the blocks in [offsets[i], offsets[i+1]).
+ *
+ * Positions of cores in the input sequence are tracked in `starts` and `ends`
+ * when requested at construction, independently of the `STATS` macro.
+ *
+ * In gap-aware mode the sequence is split at its gaps (see gaps.h) into
+ * segments that are parsed and deepened independently, so no core spans a gap
+ * and no time is spent on the gaps. The cores of all segments are stored one
+ * after another, and `gaps` records where each segment ends.
+ *
+ * Key functionalities include:
+ * - Parsing an input sequence directly into the columnar layout.
+ * - Performing DCT compression in place and deepening to higher levels.
+ * - Converting cores from and to the `core` representation.
+ *
+ * Example usage:
+ * @code
+ *   std::string sequence = "AGCTAGCTAG";
+ *   lcp::core_array cores(sequence);
+ *   cores.deepen(4);
+ * @endcode
+ *
+ * @see core.h
+ * @see lps.h
+ *
+ * @namespace lcp
+ * @struct core_array
+ *
+ */
+
+#ifndef CORE_ARRAY_H
+#define CORE_ARRAY_H
+
+#include "constant.h"
+#include "core.h"
+#include "gaps.h"
+#include "hash.h"
+#include "lcpt.h"
+#include "writer.h"
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace lcp {
+
+	struct core_array {
+	  public:
+		int level;
+		bool positions;
+
+		// How the labels of the cores were computed, see `lcpt::labelling`
+		uint16_t label_flags;
+
+		// Columns
+		std::vector<ulabel> labels;
+		std::vector<ubit_size> bit_sizes;
+		std::vector<ublock> blocks;
+		std::vector<size_t> offsets;
+		std::vector<size_t> starts;
+		std::vector<size_t> ends;
+
+		// Gaps between independently parsed segments, empty unless parsed in gap-aware mode.
+		// `update` and `stitch` do not track gaps.
+		std::vector<struct gap> gaps;
+
+		// Keys of the last cores whose labels are not hashed yet, four words each, see `hash_labels`.
+		std::vector<ulabel> pending;
+
+		/**
+		 * @brief Random access iterator addressing a core by its index.
+		 *
+		 * The iterator is what the parsing rules operate on; the core columns
+		 * are reached through the `array_*` functions in rules.h. The index is
+		 * signed so that stepping before the first core stays comparable.
+		 */
+		struct iterator {
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef std::ptrdiff_t difference_type;
+			typedef std::ptrdiff_t value_type;
+			typedef const std::ptrdiff_t *pointer;
+			typedef const std::ptrdiff_t &reference;
+
+			core_array *array;
+			std::ptrdiff_t index;
+
+			iterator(core_array *array, std::ptrdiff_t index) : array(array), index(index) {};
+
+			inline iterator operator+(difference_type n) const { return iterator(this->array, this->index + n); };
+			inline iterator operator-(difference_type n) const { return iterator(this->array, this->index - n); };
+			inline difference_type operator-(const iterator &other) const { return this->index - other.index; };
+			inline iterator &operator++() { this->index++; return *this; };
+			inline iterator &operator--() { this->index--; return *this; };
+			inline iterator operator++(int) { iterator temp = *this; this->index++; return temp; };
+			inline iterator operator--(int) { iterator temp = *this; this->index--; return temp; };
+			inline bool operator==(const iterator &other) const { return this->index == other.index; };
+			inline bool operator!=(const iterator &other) const { return this->index != other.index; };
+			inline bool operator<(const iterator &other) const { return this->index < other.index; };
+			inline bool operator<=(const iterator &other) const { return this->index <= other.index; };
+			inline bool operator>(const iterator &other) const { return this->index > other.index; };
+			inline bool operator>=(const iterator &other) const { return this->index >= other.index; };
+		};
+
+		/**
+		 * @brief Constructs an empty core array.
+		 *
+		 * @param positions Whether to track positions of cores in the input sequence.
+		 */
+		core_array(bool positions = false);
+
+		/**
+		 * @brief Constructs a core array by parsing a raw character range.
+		 *
+		 * @param begin Pointer to the first character of the sequence.
+		 * @param end Pointer past the last character of the sequence.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param positions Whether to track positions of cores in the input sequence.
+		 */
+		core_array(const char *begin, const char *end, bool use_map = LCP_USE_MAP, bool positions = false);
+
+		/**
+		 * @brief Constructs a core array by parsing a string.
+		 *
+		 * @param str The input string to be parsed.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param positions Whether to track positions of cores in the input sequence.
+		 */
+		core_array(std::string &str, bool use_map = LCP_USE_MAP, bool positions = false);
+
+		/**
+		 * @brief Constructs a core array by parsing the segments of a raw character range between gaps.
+		 *
+		 * @param begin Pointer to the first character of the sequence.
+		 * @param end Pointer past the last character of the sequence.
+		 * @param gaps The gaps of the sequence, in order, e.g. found by `find_gaps`.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param positions Whether to track positions of cores in the input sequence.
+		 */
+		core_array(const char *begin, const char *end, const std::vector<struct gap> &gaps, bool use_map = LCP_USE_MAP, bool positions = false);
+
+		/**
+		 * @brief Constructs a core array from a vector of cores.
+		 *
+		 * Positions are taken over from the cores when `STATS` is defined.
+		 *
+		 * @param cores The cores to be stored.
+		 * @param level The LCP level of the cores.
+		 * @param label_flags (Optional) How the labels of the cores were computed, see `lcpt::labelling`.
+		 */
+		core_array(const std::vector<struct core> &cores, int level, uint16_t label_flags = 0);
+
+		/**
+		 * @brief Constructs a core array by copying the columns of an .lcpt record.
+		 *
+		 * @param rec The record, e.g. of a memory-mapped file.
+		 */
+		core_array(const lcpt::record &rec);
+
+		/**
+		 * @brief Replaces the cores by the level 1 cores of a raw character range.
+		 *
+		 * The columns keep their capacity, so a core array can be reused for many
+		 * sequences (e.g. short reads) without allocating once it has grown.
+		 *
+		 * @param begin Pointer to the first character of the sequence.
+		 * @param end Pointer past the last character of the sequence.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 */
+		void parse(const char *begin, const char *end, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Replaces the cores by the level 1 cores of the segments of a raw character range
+		 * between gaps.
+		 *
+		 * Every segment is parsed on its own, positions are relative to `begin`, and the characters
+		 * of the gaps are not visited. The gaps are kept with the index of the first core after them,
+		 * and later calls to `deepen` deepen every segment on its own as well.
+		 *
+		 * @param begin Pointer to the first character of the sequence.
+		 * @param end Pointer past the last character of the sequence.
+		 * @param gaps The gaps of the sequence, in order and within [begin, end).
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 */
+		void parse(const char *begin, const char *end, const std::vector<struct gap> &gaps, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Appends a core built from the elements in [begin, end).
+		 *
+		 * Takes the same arguments as the templated `core` constructor, so the
+		 * array can be passed to `lps::parse` in place of a vector of cores.
+		 *
+		 * @param begin Iterator pointing to the first element of the core.
+		 * @param end Iterator pointing past the last element of the core.
+		 * @param indeces The start and end positions of the core.
+		 * @param size Function returning the bit length of an element.
+		 * @param rep Function returning the blocks of an element.
+		 * @param data Function returning the data to be labeled.
+		 * @param use_map Whether to use the label dictionary.
+		 */
+		template <typename Iterator, typename Size, typename Representation, typename Data>
+		void emplace_back(Iterator begin, Iterator end, std::pair<size_t, size_t> indeces, Size size, Representation rep, Data data, bool use_map) {
+
+			ubit_size bit_size = 0;
+
+			for (Iterator it = begin; it < end; it++) {
+				bit_size += size(it);
+			}
+
+			// every core owns at least one block so that single block layout holds
+			size_t block_number = (bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+			block_number = block_number > 1 ? block_number : 1;
+
+			if (block_number > 1 && this->offsets.empty()) {
+				this->expand();
+			}
+
+			size_t offset = this->blocks.size();
+			this->blocks.resize(offset + block_number, 0);
+
+			pack(begin, end, size, rep, &this->blocks[offset], block_number);
+
+			if (!this->offsets.empty()) {
+				this->offsets.push_back(this->blocks.size());
+			}
+
+			this->bit_sizes.push_back(bit_size);
+			this->label(data(begin, end), use_map);
+
+			if (this->positions) {
+				this->starts.push_back(indeces.first);
+				this->ends.push_back(indeces.second);
+			}
+		};
+
+		/**
+		 * @brief Hashes the keys of the cores appended since the last call into their labels.
+		 *
+		 * Without the label dictionary, the keys of cores above level 1 are collected while
+		 * parsing and hashed `LABEL_BATCH_SIZE` at a time by the batch form of `hash::simple`.
+		 * Parsing a level through `deepen` calls it at the end, a level parsed by passing the
+		 * array to `lps::parse` directly must call it before its labels are read.
+		 */
+		void hash_labels();
+
+		/**
+		 * @brief Performs DCT compression of every core against its left neighbour.
+		 *
+		 * Compression is done in place, from the last core to the first, and the
+		 * blocks are compacted afterwards.
+		 *
+		 * @return True if dct is performed, False if no enough cores are available for dct.
+		 */
+		bool dct();
+
+		/**
+		 * @brief Deepens the cores by one level. This method compresses the
+		 * existing cores and finds new cores.
+		 *
+		 * When `thread_number` is greater than 1, the new cores are found by several threads,
+		 * each over a range of at least `DEEPEN_RANGE_SIZE` cores, and the ranges are joined in
+		 * order as in `lps::deepen`. The cores are the same as the ones of the serial parse. With
+		 * the label dictionary, the level is parsed serially to keep the order of the IDs.
+		 *
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param thread_number (Optional) Number of threads used to parse the level. Defaults to 1.
+		 * @return True if successful in deepening the structure, false otherwise.
+		 */
+		bool deepen(bool use_map = LCP_USE_MAP, size_t thread_number = LCP_THREAD_NUMBER);
+
+		/**
+		 * @brief Deepens the cores to a specific level.
+		 *
+		 * @param lcp_level The target level to deepen to.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param thread_number (Optional) Number of threads used to parse every level, see above.
+		 * @return True if deepening was successful, false otherwise.
+		 */
+		bool deepen(int lcp_level, bool use_map = LCP_USE_MAP, size_t thread_number = LCP_THREAD_NUMBER);
+
+		/**
+		 * @brief Deepens the cores by one level, finding the new cores in `buffer`.
+		 *
+		 * The columns of `buffer` are swapped with the ones of this array, so two arrays
+		 * reused in turn deepen without allocating once they have grown.
+		 *
+		 * @param buffer The array receiving the new cores, holds the old cores afterwards.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param thread_number (Optional) Number of threads used to parse the level, see above.
+		 * @return True if successful in deepening the structure, false otherwise.
+		 */
+		bool deepen(struct core_array &buffer, bool use_map = LCP_USE_MAP, size_t thread_number = LCP_THREAD_NUMBER);
+
+		/**
+		 * @brief Deepens the cores to a specific level using `buffer` for the new cores.
+		 *
+		 * @param lcp_level The target level to deepen to.
+		 * @param buffer The array receiving the new cores of each level.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param thread_number (Optional) Number of threads used to parse every level, see above.
+		 * @return True if deepening was successful, false otherwise.
+		 */
+		bool deepen(int lcp_level, struct core_array &buffer, bool use_map = LCP_USE_MAP, size_t thread_number = LCP_THREAD_NUMBER);
+
+		/**
+		 * @brief Updates the cores after an edit of the sequence, re-parsing only around the edit.
+		 *
+		 * The edit replaces `removed` characters at `position` of the previously parsed sequence
+		 * by `inserted` characters, giving the sequence [begin, end). A window around the edit is
+		 * parsed and deepened to the level of the array, and its cores replace the old ones between
+		 * two anchors: runs of `UPDATE_ANCHOR_SIZE` consecutive cores that are the same in the window
+		 * and in the array, left and right of the edit. Positions of the cores after the edit are
+		 * shifted by the length difference. If no anchors are found, the window is doubled, up to the
+		 * whole sequence.
+		 *
+		 * Anchors are found through core positions, so the array must track positions; otherwise the
+		 * cores are rebuilt from scratch.
+		 *
+		 * @param begin Pointer to the first character of the edited sequence.
+		 * @param end Pointer past the last character of the edited sequence.
+		 * @param position The position of the edit.
+		 * @param removed The number of characters removed at `position`.
+		 * @param inserted The number of characters inserted at `position`.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @return True if only a window of the sequence is parsed, false if the whole sequence is parsed.
+		 */
+		bool update(const char *begin, const char *end, size_t position, size_t removed, size_t inserted, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Appends the cores of an overlapping array, joining both at an anchor.
+		 *
+		 * Both arrays track positions in the same sequence and are of the same level, and `next`
+		 * starts within this array. The anchor is the first run of `UPDATE_ANCHOR_SIZE` cores of
+		 * `next`, starting at or after `cut`, that is the same in this array. The cores of this
+		 * array from the anchor on are replaced by the cores of `next` from the anchor on. Cores
+		 * near the borders of a parsed window may differ from the ones of the whole sequence, so
+		 * `cut` should be away from the beginning of `next` and from the end of this array.
+		 *
+		 * @param next The array parsed from a window overlapping the end of this array.
+		 * @param cut The position anchors are searched from.
+		 * @return True if an anchor is found, false if the array is left unchanged.
+		 */
+		bool stitch(const struct core_array &next, size_t cut);
+
+		/**
+		 * @brief Builds the `core` object stored at the given index.
+		 *
+		 * @param index The index of the core.
+		 * @return A `core` holding a copy of the representation of the core.
+		 */
+		struct core get(size_t index) const;
+
+		/**
+		 * @brief Retrieves the labels of all cores and appends them to the provided labels vector.
+		 *
+		 * @param labels A reference to a vector where the labels of the cores will be stored.
+		 * @return true if the labels were successfully retrieved.
+		 */
+		bool get_labels(std::vector<ulabel> &labels) const;
+
+		/**
+		 * @brief Writes the cores as an .lcpt record, one write per column.
+		 *
+		 * @param out The output file stream to write to.
+		 * @param name (Optional) The name of the sequence, stored in the record if not empty.
+		 */
+		void write(std::ofstream &out, const std::string &name = std::string()) const;
+
+		/**
+		 * @brief Appends the cores as an .lcpt record to a byte buffer.
+		 *
+		 * @param out The buffer to append to.
+		 * @param name (Optional) The name of the sequence, stored in the record if not empty.
+		 */
+		void write(std::string &out, const std::string &name = std::string()) const;
+
+		/**
+		 * @brief Serializes the cores as an .lcpt record into the buffer of an asynchronous writer.
+		 *
+		 * @param out The writer.
+		 * @param name (Optional) The name of the sequence, stored in the record if not empty.
+		 */
+		void write(struct writer &out, const std::string &name = std::string()) const;
+
+		/**
+		 * @brief Reads the cores from an .lcpt record, one read per column.
+		 *
+		 * @param in The input file stream to read from.
+		 * @return True if a record is read, false if the stream does not continue with a record.
+		 */
+		bool read(std::ifstream &in);
+
+		/**
+		 * @brief Reserves space for the given number of cores.
+		 *
+		 * @param size The number of cores.
+		 */
+		void reserve(size_t size);
+
+		/**
+		 * @brief Removes every core, keeping the level and position tracking.
+		 */
+		void clear();
+
+		/**
+		 * @brief Exchanges the contents of two core arrays.
+		 *
+		 * @param other The core array to swap with.
+		 */
+		void swap(struct core_array &other);
+
+		/**
+		 * @brief Calculates and returns the memory size used by the cores.
+		 *
+		 * @return The memory size (in bytes) used by the core array.
+		 */
+		double memsize() const;
+
+		/**
+		 * @brief Returns the number of cores stored in the array.
+		 *
+		 * @return size_t Number of cores.
+		 */
+		inline size_t size() const {
+			return this->labels.size();
+		};
+
+		/**
+		 * @brief Returns the index of the first block of the core at the given index.
+		 *
+		 * @param index The index of the core.
+		 * @return The index of the first block in `blocks`.
+		 */
+		inline size_t block_offset(size_t index) const {
+			return this->offsets.empty() ? index : this->offsets[index];
+		};
+
+		inline iterator begin() {
+			return iterator(this, 0);
+		};
+
+		inline iterator end() {
+			return iterator(this, this->size());
+		};
+
+	  private:
+		/**
+		 * @brief Materializes the offset table for the current single block layout.
+		 */
+		void expand();
+
+		/**
+		 * @brief Appends the label of a level 1 core.
+		 */
+		inline void label(ulabel data, bool use_map) {
+			if (!this->pending.empty()) {
+				this->hash_labels();
+			}
+			this->labels.push_back(use_map ? hash::emplace(data) : hash::simple(data));
+		};
+
+		/**
+		 * @brief Appends the label of a higher level core, hashed later in a batch without the dictionary.
+		 */
+		inline void label(const ulabel *data, bool use_map) {
+			if (use_map) {
+				this->labels.push_back(hash::emplace(data));
+				return;
+			}
+
+			this->labels.push_back(0);
+			this->pending.insert(this->pending.end(), data, data + 4);
+
+			if (this->pending.size() == 4 * LABEL_BATCH_SIZE) {
+				this->hash_labels();
+			}
+		};
+
+		/**
+		 * @brief Returns a record referring to the columns of the array.
+		 */
+		lcpt::record columns() const;
+
+		/**
+		 * @brief Removes the cores from `size` on.
+		 */
+		void truncate(size_t size);
+
+		/**
+		 * @brief Deepens every segment between gaps by one level on its own, see `deepen`.
+		 */
+		bool deepen_segments(struct core_array &buffer, bool use_map, size_t thread_number);
+
+		/**
+		 * @brief Finds the cores of the compressed array in ranges concurrently and appends them to
+		 * `buffer` in order, see `deepen`.
+		 */
+		void parse_ranges(struct core_array &buffer, size_t thread_number);
+
+		/**
+		 * @brief Appends the cores [first, last) of another array, shifting their positions.
+		 */
+		void append(const struct core_array &other, size_t first, size_t last, std::ptrdiff_t shift);
+
+		/**
+		 * @brief Checks whether core `index` equals core `other_index` of another array whose
+		 * positions are `shift` characters ahead.
+		 */
+		bool same(size_t index, const struct core_array &other, size_t other_index, std::ptrdiff_t shift) const;
+	};
+
+}; // namespace lcp
+
+#endif
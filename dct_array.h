@@ -0,0 +1,125 @@
+/**
+ * @file dct_array.h
+ * @brief Compressed representations of the cores of a level, used to deepen
+ * `lps` objects without compressing the level in place.
+ *
+ * Deepening compresses every core against its left neighbour and parses the
+ * compressed cores. `lps::dct` does so by rewriting the cores in place, which
+ * releases the blocks of every core longer than a block. The `dct_array`
+ * struct instead computes the compressed representations once, in a single
+ * pass, into two flat columns. A compressed core always fits into one block,
+ * so the parser then reads 12 bytes per core instead of the `core` objects, and
+ * the level is left untouched until it is released as a whole.
+ *
+ * As with `lps::dct`, the first core is not compressed and keeps its own
+ * representation.
+ *
+ * @see rules.h
+ * @see lps.h
+ *
+ * @namespace lcp
+ * @struct dct_array
+ *
+ * @note Only a single compression iteration, i.e. `DCT_ITERATION_COUNT` of 1, is computed.
+ *
+ */
+
+#ifndef DCT_ARRAY_H
+#define DCT_ARRAY_H
+
+#include "constant.h"
+#include "core.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace lcp {
+
+	struct dct_array {
+	  public:
+		/**
+		 * @brief Random access iterator addressing a compressed core by its index.
+		 */
+		struct iterator {
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef std::ptrdiff_t difference_type;
+			typedef std::ptrdiff_t value_type;
+			typedef const std::ptrdiff_t *pointer;
+			typedef const std::ptrdiff_t &reference;
+
+			dct_array *array;
+			std::ptrdiff_t index;
+
+			iterator(dct_array *array, std::ptrdiff_t index) : array(array), index(index) {};
+
+			inline iterator operator+(difference_type n) const { return iterator(this->array, this->index + n); };
+			inline iterator operator-(difference_type n) const { return iterator(this->array, this->index - n); };
+			inline difference_type operator-(const iterator &other) const { return this->index - other.index; };
+			inline iterator &operator++() { this->index++; return *this; };
+			inline iterator &operator--() { this->index--; return *this; };
+			inline iterator operator++(int) { iterator temp = *this; this->index++; return temp; };
+			inline iterator operator--(int) { iterator temp = *this; this->index--; return temp; };
+			inline bool operator==(const iterator &other) const { return this->index == other.index; };
+			inline bool operator!=(const iterator &other) const { return this->index != other.index; };
+			inline bool operator<(const iterator &other) const { return this->index < other.index; };
+			inline bool operator<=(const iterator &other) const { return this->index <= other.index; };
+			inline bool operator>(const iterator &other) const { return this->index > other.index; };
+			inline bool operator>=(const iterator &other) const { return this->index >= other.index; };
+		};
+
+		std::vector<struct core> *cores;
+		std::vector<ublock> reps;
+		std::vector<ubit_size> sizes;
+
+		/**
+		 * @brief Compresses every core of the given level against its left neighbour.
+		 *
+		 * @param cores The cores of the level, which are not modified.
+		 * @param thread_number (Optional) Number of threads compressing ranges of the level.
+		 */
+		dct_array(std::vector<struct core> *cores, size_t thread_number = 1) : cores(cores), reps(cores->size()), sizes(cores->size()) {
+
+			size_t count = cores->size() < DCT_ITERATION_COUNT ? 0 : cores->size() - DCT_ITERATION_COUNT;
+			size_t range_count = std::max(std::min(thread_number, count / DEEPEN_RANGE_SIZE), static_cast<size_t>(1));
+
+			parallel::run(range_count, thread_number, [&](size_t range) {
+				size_t first = DCT_ITERATION_COUNT + count * range / range_count;
+				size_t last = DCT_ITERATION_COUNT + count * (range + 1) / range_count;
+
+				for (size_t index = first; index < last; index++) {
+					const struct core &curr = (*cores)[index];
+					const struct core &left = (*cores)[index - 1];
+
+					this->sizes[index] = compress_rep(curr.bit_rep, curr.bit_size, left.bit_rep, left.bit_size, this->reps[index]);
+				}
+			});
+		};
+
+		inline iterator begin() {
+			return iterator(this, 0);
+		};
+
+		inline iterator end() {
+			return iterator(this, this->cores->size());
+		};
+
+		/**
+		 * @brief Returns the bit length of the compressed core at the given index.
+		 */
+		inline ubit_size size(std::ptrdiff_t index) const {
+			return index < DCT_ITERATION_COUNT ? (*this->cores)[index].bit_size : this->sizes[index];
+		};
+
+		/**
+		 * @brief Returns the representation of the compressed core at the given index.
+		 */
+		inline ublock *rep(std::ptrdiff_t index) {
+			return index < DCT_ITERATION_COUNT ? (*this->cores)[index].bit_rep : &this->reps[index];
+		};
+	};
+
+}; // namespace lcp
+
+#endif
@@ -9,51 +9,54 @@
  */
 
 #include "encoding.h"
+#include "context.h"
 
 namespace lcp {
 
-	int alphabet[128];
-	int rc_alphabet[128];
-	char characters[128];
-	int alphabet_bit_size;
-
 	namespace encoding {
 
 		void summary() {
+			struct context &ctx = context::current();
+
 			std::cout << "# Alphabet encoding summary" << std::endl;
 			std::cout << "# Coefficients: ";
 			for (int i = 0; i < 128; i++) {
-				if (alphabet[i] != -1) {
-					std::cout << char(i) << ":" << alphabet[i] << " ";
+				if (ctx.alphabet[i] != -1) {
+					std::cout << char(i) << ":" << ctx.alphabet[i] << " ";
 				}
 			}
 			std::cout << std::endl;
-			std::cout << "# Alphabet bit size: " << alphabet_bit_size << std::endl;
+			std::cout << "# Alphabet bit size: " << ctx.alphabet_bit_size << std::endl;
 		};
 
 		int init(bool verbose) {
+			struct context &ctx = context::current();
 
 			// init coefficients A/a=0, T/t=3, G/g=2, C/c=1
+			// every byte is indexed, characters outside of ASCII are not encoded
+			for (int current_index = 0; current_index < 256; current_index++) {
+				ctx.alphabet[current_index] = -1;
+			}
 			for (int current_index = 0; current_index < 128; current_index++) {
-				alphabet[current_index] = -1;
-				characters[current_index] = 126;
+				ctx.characters[current_index] = 126;
 			}
-			alphabet['A'] = 0; alphabet['a'] = 0;
-			alphabet['T'] = 3; alphabet['t'] = 3;
-			alphabet['G'] = 2; alphabet['g'] = 2;
-			alphabet['C'] = 1; alphabet['c'] = 1;
+			ctx.alphabet['A'] = 0; ctx.alphabet['a'] = 0;
+			ctx.alphabet['T'] = 3; ctx.alphabet['t'] = 3;
+			ctx.alphabet['G'] = 2; ctx.alphabet['g'] = 2;
+			ctx.alphabet['C'] = 1; ctx.alphabet['c'] = 1;
 
-			rc_alphabet['A'] = 3; rc_alphabet['a'] = 3;
-			rc_alphabet['T'] = 0; rc_alphabet['t'] = 0;
-			rc_alphabet['G'] = 1; rc_alphabet['g'] = 1;
-			rc_alphabet['C'] = 2; rc_alphabet['c'] = 2;
+			ctx.rc_alphabet['A'] = 3; ctx.rc_alphabet['a'] = 3;
+			ctx.rc_alphabet['T'] = 0; ctx.rc_alphabet['t'] = 0;
+			ctx.rc_alphabet['G'] = 1; ctx.rc_alphabet['g'] = 1;
+			ctx.rc_alphabet['C'] = 2; ctx.rc_alphabet['c'] = 2;
 
-			characters[0] = 'A';
-			characters[1] = 'C';
-			characters[2] = 'G';
-			characters[3] = 'T';
+			ctx.characters[0] = 'A';
+			ctx.characters[1] = 'C';
+			ctx.characters[2] = 'G';
+			ctx.characters[3] = 'T';
 
-			alphabet_bit_size = 2;
+			ctx.alphabet_bit_size = 2;
+			ctx.dna_alphabet = true;
 
 			if (verbose)
 				summary();
@@ -62,11 +65,15 @@ namespace lcp {
 		};
 
 		int init(std::map<char, int> map, std::map<char, int> rc_map, bool verbose) {
+			struct context &ctx = context::current();
 
 			// init coefficients A/a=0, T/t=3, G/g=2, C/c=1
+			// every byte is indexed, characters outside of ASCII are not encoded
+			for (int current_index = 0; current_index < 256; current_index++) {
+				ctx.alphabet[current_index] = -1;
+			}
 			for (int current_index = 0; current_index < 128; current_index++) {
-				alphabet[current_index] = -1;
-				characters[current_index] = 126;
+				ctx.characters[current_index] = 126;
 			}
 
 			std::map<char, int>::iterator it = map.begin();
@@ -76,8 +83,8 @@ namespace lcp {
 				if (it->second < 0)
 					throw std::invalid_argument("Invalid value given.");
 
-				alphabet[static_cast<unsigned char>(it->first)] = it->second;
-				characters[it->second] = it->first;
+				ctx.alphabet[static_cast<unsigned char>(it->first)] = it->second;
+				ctx.characters[it->second] = it->first;
 				if (max < it->second) {
 					max = it->second;
 				}
@@ -91,8 +98,8 @@ namespace lcp {
 				if (it->second < 0)
 					throw std::invalid_argument("Invalid value given.");
 
-				rc_alphabet[static_cast<unsigned char>(it->first)] = it->second;
-				characters[it->second] = it->first;
+				ctx.rc_alphabet[static_cast<unsigned char>(it->first)] = it->second;
+				ctx.characters[it->second] = it->first;
 				if (max < it->second) {
 					max = it->second;
 				}
@@ -105,7 +112,8 @@ namespace lcp {
 				max = max / 2;
 			}
 
-			alphabet_bit_size = bit_count;
+			ctx.alphabet_bit_size = bit_count;
+			ctx.dna_alphabet = false;
 
 			if (verbose)
 				summary();
@@ -22,6 +22,9 @@
  *   - Loads encoding mappings from an external file, making it easy to extend
  * the encoding system for custom alphabets or symbols.
  *
+ * The functions initialize the alphabet of the context of the calling thread,
+ * the global one unless another context is bound (see context.h).
+ *
  * Example usage:
  * @code
  *   // Initialize standard encoding and reverse complements
@@ -56,10 +59,88 @@
 
 namespace lcp {
 
-	extern int alphabet[128];
-	extern int rc_alphabet[128];
-	extern char characters[128];
-	extern int alphabet_bit_size;
+	// tables of the global context, parsing reads the ones of `context::current()` (see context.h)
+	extern int (&alphabet)[256];
+	extern int (&rc_alphabet)[256];
+	extern char (&characters)[128];
+	extern int &alphabet_bit_size;
+
+	/**
+	 * @brief Whether the default DNA alphabet of `encoding::init()` is in use, in which case
+	 * level 1 is parsed with the compile-time `dna_*` rules of rules.h. Custom alphabets clear it.
+	 * Every context keeps its own flag, this is the one of the global context.
+	 */
+	extern bool &dna_alphabet;
+
+	/**
+	 * @brief Codes of the default alphabet set by `encoding::init()`, indexed by character.
+	 *
+	 * A/a=0, C/c=1, G/g=2, T/t=3, every other character is -1 as in `alphabet`.
+	 */
+	constexpr int8_t dna_codes[256] = {
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1,  0, -1,  1, -1, -1, -1,  2, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1,  0, -1,  1, -1, -1, -1,  2, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+	};
+
+	/**
+	 * @brief Reverse complement codes of the default alphabet, indexed by character.
+	 *
+	 * A/a=3, C/c=2, G/g=1, T/t=0. Other characters are left 0 by `encoding::init()` in
+	 * `rc_alphabet`, and are 0 here as well.
+	 */
+	constexpr int8_t dna_rc_codes[256] = {
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  3,  0,  2,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  3,  0,  2,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+		 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+	};
+
+	/**
+	 * @brief Blocks of the codes above, offset by one so that -1 maps to a block of set bits,
+	 * the same block `char_rep` produces for characters outside the alphabet.
+	 */
+	constexpr ublock dna_blocks[5] = {~static_cast<ublock>(0), 0, 1, 2, 3};
+
+	constexpr int dna_bit_size = 2;
+
+	/**
+	 * @brief Size rule of the default alphabet, returning `dna_bit_size` for every character.
+	 *
+	 * Its type tells core construction that every character is a single code of
+	 * `dna_bit_size` bits, so representations are packed in one forward pass (see `pack`).
+	 */
+	struct dna_width {
+		template <typename Iterator>
+		constexpr uint64_t operator()(Iterator) const {
+			return dna_bit_size;
+		};
+	};
 
 	namespace encoding {
 
@@ -201,7 +201,7 @@ int main(int argc, char **argv) {
 		if (USE_MAP) {
 			lcp::hash::init(4000, 536870911);
 
-			std::cout << "str_map.capacity at the begining: " << format_int(lcp::hash::str_map.max_load_factor() * lcp::hash::str_map.bucket_count()) << std::endl;
+			std::cout << "str_map.capacity at the begining: " << format_int(lcp::hash::str_map.capacity()) << std::endl;
 		}
 
 		std::cout << "Program begins" << std::endl;
@@ -0,0 +1,54 @@
+#include "gaps.h"
+#include "context.h"
+#include <cstring>
+
+namespace lcp {
+
+	static inline bool unknown(char character, bool iupac) {
+		unsigned char code = static_cast<unsigned char>(character);
+		return iupac ? context::current().alphabet[code] < 0 : (code | 0x20) == 'n';
+	};
+
+	// eight N or n characters, the case is folded by setting bit 5 of every byte
+	static inline bool unknown_word(const char *it) {
+		uint64_t word;
+		memcpy(&word, it, sizeof(word));
+		return (word | 0x2020202020202020ULL) == 0x6e6e6e6e6e6e6e6eULL;
+	};
+
+	size_t find_gaps(const char *begin, const char *end, std::vector<struct gap> &gaps, bool iupac, size_t min_length) {
+		size_t total = 0;
+		const char *it = begin;
+
+		while (it < end) {
+
+			if (!unknown(*it, iupac)) {
+				it++;
+				continue;
+			}
+
+			const char *run = it;
+
+			if (!iupac) {
+				while (it + sizeof(uint64_t) <= end && unknown_word(it)) {
+					it += sizeof(uint64_t);
+				}
+			}
+
+			while (it < end && unknown(*it, iupac)) {
+				it++;
+			}
+
+			size_t length = it - run;
+
+			if (min_length <= length) {
+				struct gap curr = {static_cast<uint64_t>(run - begin), length, 0};
+				gaps.push_back(curr);
+				total += length;
+			}
+		}
+
+		return total;
+	};
+
+}; // namespace lcp
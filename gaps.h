@@ -0,0 +1,72 @@
+/**
+ * @file gaps.h
+ * @brief Detection of gaps, runs of unknown bases such as N, in sequences.
+ *
+ * Assemblies contain long runs of N where the sequence is unknown, e.g. the
+ * centromeres of human chromosomes, and ambiguous bases are written as other
+ * IUPAC codes. None of them are encoded by the alphabet, so parsing them costs
+ * time and yields cores that do not describe any sequence. In gap-aware mode
+ * the sequence is split at its gaps into segments that are parsed and deepened
+ * independently (see `core_array`), and only the gaps themselves are kept:
+ * their position, their length and the index of the first core after them.
+ *
+ * Soft-masked regions, written in lowercase, are not gaps; lowercase bases are
+ * encoded like uppercase ones and are parsed as usual.
+ *
+ * Example usage:
+ * @code
+ *   std::vector<lcp::gap> gaps;
+ *   lcp::find_gaps(sequence.data(), sequence.data() + sequence.size(), gaps);
+ *   lcp::core_array cores(sequence.data(), sequence.data() + sequence.size(), gaps);
+ *   cores.deepen(4);
+ * @endcode
+ *
+ * @namespace lcp
+ * @struct gap
+ *
+ */
+
+#ifndef GAPS_H
+#define GAPS_H
+
+#include "constant.h"
+#include "encoding.h"
+#include <cstdint>
+#include <vector>
+
+namespace lcp {
+
+	/**
+	 * @brief A gap of a sequence.
+	 *
+	 * The layout is the one of the gap section of .lcpt records (see lcpt.h).
+	 */
+	struct gap {
+		// position of the first character of the gap
+		uint64_t start;
+		// number of characters in the gap
+		uint64_t length;
+		// index of the first core after the gap
+		uint64_t index;
+	};
+
+	/**
+	 * @brief Appends the gaps of a sequence.
+	 *
+	 * A gap is a run of N or n. If `iupac` is true, a gap is a run of any character
+	 * the alphabet does not encode, which covers the other IUPAC codes as well. Runs of N are
+	 * measured eight characters at a time. The index of the gaps is left 0, it is set
+	 * while parsing.
+	 *
+	 * @param begin Pointer to the first character of the sequence.
+	 * @param end Pointer past the last character of the sequence.
+	 * @param gaps The vector the gaps are appended to, in order.
+	 * @param iupac Whether every character unknown to the alphabet starts a gap.
+	 * @param min_length Runs shorter than this are not gaps and are parsed as usual.
+	 * @return The number of characters in the appended gaps.
+	 */
+	size_t find_gaps(const char *begin, const char *end, std::vector<struct gap> &gaps, bool iupac = false, size_t min_length = GAP_MIN_LENGTH);
+
+}; // namespace lcp
+
+#endif
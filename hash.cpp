@@ -5,98 +5,63 @@
  *
  * This source file provides the implementation for custom hash functions and
  * equality operators used in unordered maps. It also includes functionality to
- * initialize the hash maps (`str_map` and `cores_map`) and compute hash values
+ * initialize the hash maps (`str_map` and `cores_map`) of the current context
+ * (see context.h) and compute hash values
  * for sequences of bytes. The hashing functions are designed to handle
  * case-insensitive input and work efficiently with large datasets.
  */
 
 #include "hash.h"
+#include "context.h"
 
 namespace lcp {
 
 	namespace hash {
 
-		// mutex
-		std::mutex str_map_mutex;
-		std::mutex cores_map_mutex;
-
-		// maps
-		std::unordered_map<std::string, ulabel> str_map(1);
-		std::vector<std::vector<struct cores>> cores_map(1);
-		size_t size = 0;
-		size_t cores_size = 0;
-
-		// ID
-		ulabel next_id = 0;
-
 		void init(size_t str_map_size, size_t cores_map_size) {
-			str_map.reserve(str_map_size);
+			struct context &ctx = context::current();
+			ctx.str_map.reserve(str_map_size);
+			ctx.cores_map.reserve(cores_map_size);
+		};
 
-			if (size > 0) {
-				std::cout << "Reserving hash map failed. It is already used." << std::endl;
-				return;
-			}
-			cores_map.resize(cores_map_size);
+		void set_backend(enum backend selected) {
+			context::current().labelling = selected;
+		};
+
+		enum backend get_backend() {
+			return context::current().labelling;
 		};
 
 		ulabel emplace(const ulabel data) {
-			thread_local static int double_shift = 2 * alphabet_bit_size;
-			thread_local static int triple_shift = 3 * alphabet_bit_size;
-			thread_local static ulabel mask = (1 << alphabet_bit_size) - 1;
-			
-			// construct the string
-			std::string str;
-			str.reserve((data >> triple_shift) + 2); // size 
-
-			str.push_back(characters[(data >> double_shift) & mask]); // first char
-			str.append((data >> triple_shift), characters[(data >> alphabet_bit_size) & mask]); // middle char
-			str.push_back(characters[data & mask]); // last char
-			
-			// find if it is already exists
-			std::unordered_map<std::string, ulabel>::iterator index = str_map.find(str);
-
-			if (index != str_map.end()) {
-				return index->second;
-			}
+			struct context &ctx = context::current();
+			int triple_shift = 3 * ctx.alphabet_bit_size;
+			ulabel middle_mask = ((static_cast<ulabel>(1) << ctx.alphabet_bit_size) - 1) << ctx.alphabet_bit_size;
 
-			// insert safely
-			{
-				std::lock_guard<std::mutex> lock(str_map_mutex);
-				std::pair<std::unordered_map<std::string, ulabel>::iterator, bool> result = str_map.emplace(str, next_id);
+			// strings of length two have no middle character
+			ulabel key = (data >> triple_shift) == 0 ? data & ~middle_mask : data;
 
-				if (result.second) {
-					size++;
-					return next_id++;
-				}
+			bool inserted;
+			ulabel label = ctx.str_map.emplace(&key, static_cast<uint32_t>(mix(key)), ctx.next_id, inserted);
 
-				return result.first->second;
+			if (inserted) {
+				ctx.size++;
 			}
+
+			return label;
 		};
 
 		ulabel emplace(const ulabel data[4]) {
-			std::vector<struct cores> &bucket = cores_map[MurmurHash3_32(data, MEMCOMP_CORES_SIZE) % cores_map.size()];
-			size_t bucket_size = bucket.size();
+			struct context &ctx = context::current();
 
-			for (std::vector<struct cores>::iterator it = bucket.begin(); it != bucket.end(); it++) {
-				if (it->data[0] == data[0] && it->data[1] == data[1] && it->data[2] == data[2] && it->data[3] == data[3]) {
-					return it->label;
-				}
-			}
+			bool inserted;
+			ulabel label = ctx.cores_map.emplace(data, static_cast<uint32_t>(mix(data)), ctx.next_id, inserted);
 
-			{
-				std::lock_guard<std::mutex> lock(cores_map_mutex);
-				if (bucket_size != bucket.size()) {
-					for (std::vector<struct cores>::iterator it = bucket.begin(); it != bucket.end(); it++) {
-						if (it->data[0] == data[0] && it->data[1] == data[1] && it->data[2] == data[2] && it->data[3] == data[3]) {
-							return it->label;
-						}
-					}
-				}
-				bucket.emplace_back(next_id, data);
-				size++;
-				cores_size++;
-				return next_id++;
+			if (inserted) {
+				ctx.size++;
+				ctx.cores_size++;
 			}
+
+			return label;
 		};
 
 		ulabel simple(const ulabel data) {
@@ -104,34 +69,39 @@ namespace lcp {
 		};
 
 		ulabel simple(const ulabel data[4]) {
+			if (context::current().labelling == MIX) {
+				return static_cast<ulabel>(mix(data));
+			}
+#ifdef LCP_64BIT
+			return MurmurHash64A(data, MEMCOMP_CORES_SIZE, 42);
+#else
 			return MurmurHash3_32(data, MEMCOMP_CORES_SIZE);
+#endif
 		};
 
-		void summary() {
-			size_t collisions = 0, empty = 0, max = 0;
-			for (size_t bucket = str_map.bucket_count(); bucket--;) {
-				if (str_map.bucket_size(bucket) == 0)
-					empty++;
-				else
-					collisions += str_map.bucket_size(bucket) - 1;
-
-				max = std::max(max, str_map.bucket_size(bucket));
+		void simple(const ulabel *data, size_t count, ulabel *labels) {
+			const ulabel *end = data + 4 * count;
+
+			if (context::current().labelling == MIX) {
+				for (; data < end; data += 4, labels++) {
+					*labels = static_cast<ulabel>(mix(data));
+				}
+				return;
 			}
-			std::cout << "str_map = " << str_map.load_factor() << ' ' << str_map.bucket_count() << ' ' << collisions << ' ' << empty << ' ' << max << '\n';
-
-			collisions = 0;
-			empty = 0;
-			max = 0;
-			for (size_t bucket = cores_map.size(); bucket--;) {
-				if (cores_map[bucket].size() == 0)
-					empty++;
-				else
-					collisions += cores_map[bucket].size() - 1;
-
-				max = std::max(max, cores_map[bucket].size());
+
+			for (; data < end; data += 4, labels++) {
+#ifdef LCP_64BIT
+				*labels = MurmurHash64A(data, MEMCOMP_CORES_SIZE, 42);
+#else
+				*labels = MurmurHash3_32(data, MEMCOMP_CORES_SIZE);
+#endif
 			}
+		};
 
-			std::cout << "cores_map = " << static_cast<float>(cores_map.size()) / cores_map.capacity() << ' ' << cores_map.capacity() << ' ' << collisions << ' ' << empty << ' ' << max << '\n';
+		void summary() {
+			struct context &ctx = context::current();
+			ctx.str_map.summary("str_map");
+			ctx.cores_map.summary("cores_map");
 		};
 
 		// Hash functions
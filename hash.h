@@ -14,8 +14,16 @@
  *   - An equality operator to compare arrays of three unsigned integers.
  *   - Functions to initialize hash tables (`str_map` and `cores_map`) with
  * preallocated sizes.
+ *   - A sharded open addressing dictionary that assigns consistent IDs to
+ * labels and can be shared by concurrent parsers.
  *   - A function to hash a sequence of bytes from a string iterator range,
  * using a seed value for initialization.
+ *   - A choice of the function labelling cores when no dictionary is used,
+ * MurmurHash3 or a multiply-xor mixer of the label words, also used to place
+ * keys in the dictionaries.
+ *
+ * The dictionaries, the ID counter and the label function belong to a context
+ * (see context.h); the functions below use the one of the calling thread.
  *
  * ----------------------------------------------------------------------------
  * MurmurHash3 was written by Austin Appleby, and is placed in the public
@@ -49,61 +57,342 @@
 
 #include "constant.h"
 #include "encoding.h"
+#include "stats.h"
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <iostream>
 #include <mutex>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #define BIG_CONSTANT(x) (x)
 
+// label hash function of this build, `make LCP_FAST_HASH=1` selects the mixer
+#ifdef LCP_FAST_HASH
+#define LCP_HASH_BACKEND        lcp::hash::MIX
+#else
+#define LCP_HASH_BACKEND        lcp::hash::MURMUR
+#endif
+
+// secrets of the multiply-xor mixer, the ones of wyhash
+#define MIX_SECRET0             BIG_CONSTANT(0xa0761d6478bd642f)
+#define MIX_SECRET1             BIG_CONSTANT(0xe7037ed1a0b428db)
+#define MIX_SECRET2             BIG_CONSTANT(0x8ebc6af09c88c6e3)
+#define MIX_SECRET3             BIG_CONSTANT(0x589965cc75374cc3)
+
 namespace lcp {
 
-	// struct core
-	struct cores {
-		ulabel data[4];
-		ulabel label;
+	namespace hash {
 
 		/**
-		 * @brief Parameterized constructor for the `cores` structure.
+		 * @brief Functions computing the labels of cores above level 1 when no dictionary is used.
 		 *
-		 * @param label Label associated with the structure.
-		 * @param labels The array of subcore labels. Must have exactly
-		 * DCT_ITERATION_COUNT + 3 elements.
+		 * - `MURMUR`: MurmurHash3 of the label words, MurmurHash64A when labels are 64-bit. These
+		 *   are the labels of earlier releases.
+		 * - `MIX`: a wyhash-style mixer that multiplies the label words in pairs into 128 bits and
+		 *   folds the halves, a few multiplications per core instead of a loop over the bytes.
+		 *   It reads the label values rather than their bytes, so its labels are the same on
+		 *   every platform.
 		 *
-		 * Initializes the structure with the provided core values and label.
+		 * Both are deterministic, but labels of different functions do not match, so cores that
+		 * are compared with each other, e.g. when read from `.lcpt` files, have to be labelled
+		 * with the same function.
 		 */
-		cores(const ulabel label, const ulabel labels[4]) {
-			this->label = label;
-			this->data[0] = labels[0];
-			this->data[1] = labels[1];
-			this->data[2] = labels[2];
-			this->data[3] = labels[3];
-		}
-	};
+		enum backend { MURMUR, MIX };
 
-	namespace hash {
+		/**
+		 * @brief Multiplies two words into 128 bits and folds the halves with xor.
+		 */
+		inline uint64_t mum(uint64_t lhs, uint64_t rhs) {
+#ifdef __SIZEOF_INT128__
+			__uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+			return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+			uint64_t lhs_high = lhs >> 32, lhs_low = static_cast<uint32_t>(lhs);
+			uint64_t rhs_high = rhs >> 32, rhs_low = static_cast<uint32_t>(rhs);
+			uint64_t high_high = lhs_high * rhs_high, high_low = lhs_high * rhs_low;
+			uint64_t low_high = lhs_low * rhs_high, low_low = lhs_low * rhs_low;
+			uint64_t middle = (low_low >> 32) + static_cast<uint32_t>(high_low) + static_cast<uint32_t>(low_high);
+			uint64_t low = (middle << 32) | static_cast<uint32_t>(low_low);
+			uint64_t high = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+			return low ^ high;
+#endif
+		};
+
+		/**
+		 * @brief Mixes a single label word.
+		 *
+		 * @param data The label word.
+		 * @return The mixed value.
+		 */
+		inline uint64_t mix(const ulabel data) {
+			return mum(static_cast<uint64_t>(data) ^ MIX_SECRET0, sizeof(ulabel) ^ MIX_SECRET1);
+		};
+
+		/**
+		 * @brief Mixes the four label words of a core, see `MIX`.
+		 *
+		 * @param data Pointer to the array of four words.
+		 * @return The mixed value.
+		 */
+		inline uint64_t mix(const ulabel data[4]) {
+#ifdef LCP_64BIT
+			uint64_t value = mum(data[0] ^ MIX_SECRET0, data[1] ^ MIX_SECRET1) ^ mum(data[2] ^ MIX_SECRET2, data[3] ^ MIX_SECRET3);
+#else
+			uint64_t value = mum(((static_cast<uint64_t>(data[0]) << 32) | data[1]) ^ MIX_SECRET0, ((static_cast<uint64_t>(data[2]) << 32) | data[3]) ^ MIX_SECRET1);
+#endif
+			return mum(value ^ MIX_SECRET2, MEMCOMP_CORES_SIZE ^ MIX_SECRET3);
+		};
+
+		/**
+		 * @brief Concurrent dictionary assigning consecutive IDs to fixed size keys.
+		 *
+		 * Keys are distributed over `DICT_SHARD_COUNT` shards by their hash. Every shard is
+		 * an open addressing table with linear probing, guarded by its own mutex, so callers
+		 * only contend when their keys fall into the same shard. IDs are drawn from a shared
+		 * atomic counter while the shard is locked, hence a key is assigned exactly one ID
+		 * and serial callers get the same IDs in the same order on every run.
+		 *
+		 * @tparam KeySize The number of `ulabel` words in a key.
+		 */
+		template <size_t KeySize>
+		struct dictionary {
+		  public:
+			struct slot {
+				ulabel key[KeySize];
+				ulabel label;
+				uint32_t hash;
+				bool used;
+			};
+
+			struct shard {
+				std::mutex mutex;
+				std::vector<struct slot> slots;
+				size_t count;
+			};
+
+			struct shard shards[DICT_SHARD_COUNT];
+
+			dictionary() {
+				for (size_t index = 0; index < DICT_SHARD_COUNT; index++) {
+					this->shards[index].count = 0;
+				}
+			};
+
+			/**
+			 * @brief Reserves enough slots to hold `size` keys without rehashing.
+			 *
+			 * @param size The expected number of keys.
+			 */
+			void reserve(size_t size) {
+				size_t capacity = capacity_of(size / DICT_SHARD_COUNT + 1);
+
+				for (size_t index = 0; index < DICT_SHARD_COUNT; index++) {
+					std::lock_guard<std::mutex> lock(this->shards[index].mutex);
+					if (this->shards[index].slots.size() < capacity) {
+						rehash(this->shards[index], capacity);
+					}
+				}
+			};
+
+			/**
+			 * @brief Calls `fn(key, id)` for every key, in no particular order.
+			 *
+			 * @tparam Function Callable accepting a `const ulabel *` key and its `ulabel` ID.
+			 * @param fn The function.
+			 */
+			template <typename Function>
+			void for_each(Function fn) {
+				for (size_t index = 0; index < DICT_SHARD_COUNT; index++) {
+					std::lock_guard<std::mutex> lock(this->shards[index].mutex);
+					for (typename std::vector<struct slot>::const_iterator it = this->shards[index].slots.begin(); it != this->shards[index].slots.end(); it++) {
+						if (it->used) {
+							fn(it->key, it->label);
+						}
+					}
+				}
+			};
+
+			/**
+			 * @brief Removes every key and frees the slots.
+			 */
+			void clear() {
+				for (size_t index = 0; index < DICT_SHARD_COUNT; index++) {
+					std::lock_guard<std::mutex> lock(this->shards[index].mutex);
+					std::vector<struct slot>().swap(this->shards[index].slots);
+					this->shards[index].count = 0;
+				}
+			};
+
+			/**
+			 * @brief Returns the ID of the key, inserting it with a new ID if it is absent.
+			 *
+			 * @param key The key words.
+			 * @param hash The hash value of the key.
+			 * @param next_id The counter new IDs are drawn from.
+			 * @param inserted Set to true if the key was inserted.
+			 * @return The ID of the key.
+			 */
+			ulabel emplace(const ulabel key[KeySize], uint32_t hash, std::atomic<ulabel> &next_id, bool &inserted) {
+				struct shard &shard = this->shards[hash % DICT_SHARD_COUNT];
+
+				// waits are only timed when the shard is held by another thread
+				bool waited = !shard.mutex.try_lock();
+				uint64_t wait_ns = 0;
+
+				if (waited) {
+					uint64_t begin = stats::enabled() ? stats::now() : 0;
+					shard.mutex.lock();
+					wait_ns = begin != 0 ? stats::now() - begin : 0;
+				}
+
+				std::lock_guard<std::mutex> lock(shard.mutex, std::adopt_lock);
+
+				if (shard.slots.size() < capacity_of(shard.count + 1)) {
+					rehash(shard, capacity_of(2 * shard.count + 1));
+				}
+
+				size_t mask = shard.slots.size() - 1;
+				size_t probes = 1;
+				ulabel label;
+
+				for (size_t index = (hash / DICT_SHARD_COUNT) & mask;; index = (index + 1) & mask, probes++) {
+					struct slot &curr = shard.slots[index];
 
-		// mutex
-		extern std::mutex str_map_mutex;
-		extern std::mutex cores_map_mutex;
+					if (!curr.used) {
+						std::copy(key, key + KeySize, curr.key);
+						curr.hash = hash;
+						curr.used = true;
+						curr.label = next_id++;
+						shard.count++;
+						inserted = true;
+						label = curr.label;
+						break;
+					}
+
+					if (curr.hash == hash && std::equal(key, key + KeySize, curr.key)) {
+						inserted = false;
+						label = curr.label;
+						break;
+					}
+				}
+
+				if (stats::enabled()) {
+					stats::count_lookup(KeySize == 1 ? stats::STR_MAP : stats::CORES_MAP, probes, inserted, waited, wait_ns);
+				}
+
+				return label;
+			};
+
+			/**
+			 * @brief Returns the number of keys stored in the dictionary.
+			 */
+			size_t size() {
+				size_t total = 0;
+				for (size_t index = 0; index < DICT_SHARD_COUNT; index++) {
+					std::lock_guard<std::mutex> lock(this->shards[index].mutex);
+					total += this->shards[index].count;
+				}
+				return total;
+			};
+
+			/**
+			 * @brief Returns the number of slots allocated in the dictionary.
+			 */
+			size_t capacity() {
+				size_t total = 0;
+				for (size_t index = 0; index < DICT_SHARD_COUNT; index++) {
+					std::lock_guard<std::mutex> lock(this->shards[index].mutex);
+					total += this->shards[index].slots.size();
+				}
+				return total;
+			};
+
+			/**
+			 * @brief Prints the load factor, capacity, number of keys not stored in their home
+			 * slot, number of empty slots and the longest probe sequence of the dictionary.
+			 *
+			 * @param name The name printed in front of the statistics.
+			 */
+			void summary(const std::string &name) {
+				size_t count = 0, capacity = 0, collisions = 0, empty = 0, max = 0;
+
+				for (size_t index = 0; index < DICT_SHARD_COUNT; index++) {
+					struct shard &shard = this->shards[index];
+					std::lock_guard<std::mutex> lock(shard.mutex);
+
+					size_t mask = shard.slots.size() - 1;
+					count += shard.count;
+					capacity += shard.slots.size();
+
+					for (size_t slot_index = 0; slot_index < shard.slots.size(); slot_index++) {
+						if (!shard.slots[slot_index].used) {
+							empty++;
+							continue;
+						}
+
+						size_t distance = (slot_index - (shard.slots[slot_index].hash / DICT_SHARD_COUNT)) & mask;
+						collisions += distance > 0;
+						max = std::max(max, distance + 1);
+					}
+				}
+
+				std::cout << name << " = " << (capacity ? static_cast<float>(count) / capacity : 0) << ' ' << capacity << ' ' << collisions << ' ' << empty << ' ' << max << '\n';
+			};
+
+		  private:
+			/**
+			 * @brief Returns the power of two slot count keeping `size` keys under 70% load.
+			 */
+			static size_t capacity_of(size_t size) {
+				size_t capacity = 16;
+				while (capacity * 7 < size * 10) {
+					capacity *= 2;
+				}
+				return capacity;
+			};
+
+			static void rehash(struct shard &shard, size_t capacity) {
+				std::vector<struct slot> slots(capacity, slot());
+				size_t mask = capacity - 1;
+
+				for (typename std::vector<struct slot>::iterator it = shard.slots.begin(); it != shard.slots.end(); it++) {
+					if (!it->used) {
+						continue;
+					}
+
+					size_t index = (it->hash / DICT_SHARD_COUNT) & mask;
+					while (slots[index].used) {
+						index = (index + 1) & mask;
+					}
+
+					slots[index] = *it;
+				}
+
+				shard.slots.swap(slots);
+			};
+		};
+
+		// state of the global context, the functions below use the one of `context::current()`
 
 		// maps
-		extern std::unordered_map<std::string, ulabel> str_map;
-		extern std::vector<std::vector<struct cores>> cores_map;
-		extern size_t size;
-		extern size_t cores_size;
+		extern dictionary<1> &str_map;
+		extern dictionary<4> &cores_map;
+		extern std::atomic<size_t> &size;
+		extern std::atomic<size_t> &cores_size;
 
 		// id
-		extern ulabel next_id;
+		extern std::atomic<ulabel> &next_id;
+
+		// label function
+		extern enum backend &labelling;
 
 		/**
 		 * @brief Initializes the internal hash maps with the specified sizes.
 		 *
-		 * Reserves memory for the `str_map` and `cores_map` hash maps.
-		 * If `cores_map` already contains elements, a warning message is
-		 * printed, and no reservation is performed for `cores_map`.
+		 * Reserves memory for the `str_map` and `cores_map` hash maps. It can
+		 * be called at any time; existing entries are rehashed.
 		 *
 		 * @param str_map_size The number of elements to reserve for the
 		 * `str_map`.
@@ -112,15 +401,31 @@ namespace lcp {
 		 */
 		void init(size_t str_map_size = STR_HASH_TABLE_SIZE, size_t cores_map_size = CORE_HASH_TABLE_SIZE);
 
+		/**
+		 * @brief Selects the function labelling cores when no dictionary is used.
+		 *
+		 * The default is `LCP_HASH_BACKEND` of the build. It should be selected before
+		 * parsing, cores labelled by different functions do not match.
+		 *
+		 * @param selected The label function.
+		 */
+		void set_backend(enum backend selected);
+
+		/**
+		 * @brief Returns the function labelling cores when no dictionary is used.
+		 */
+		enum backend get_backend();
+
 		/**
 		 * @brief Inserts a string into the `str_map` and returns its unique ID.
 		 *
-		 * Converts the input string to uppercase and checks if it already
-		 * exists in the `str_map`. If it exists, returns the existing ID.
-		 * Otherwise, safely inserts the string into the map while ensuring
-		 * thread safety and assigns it a new ID.
+		 * The packed character data (length, first, second-to-last and last
+		 * characters) is used as the key directly. Strings of length two have
+		 * no middle characters, so the second-to-last character is dropped from
+		 * their key. If the key exists, returns the existing ID. Otherwise, the
+		 * key is inserted with a new ID. Safe to call concurrently.
 		 *
-		 * @param data Pointer to the string data to be inserted.
+		 * @param data The packed character data of the string.
 		 * @return The unique ID of the string in the `str_map`.
 		 */
 		ulabel emplace(const ulabel data);
@@ -129,10 +434,10 @@ namespace lcp {
 		 * @brief Inserts a core represented as an array of `ulabel` into the
 		 * `cores_map` and returns its unique ID.
 		 *
-		 * Computes a hash index for the core and checks if an equivalent core
-		 * exists in the same bucket. If it exists, returns the existing label.
-		 * Otherwise, safely inserts the new core into the bucket while ensuring
-		 * thread safety and assigns it a new label.
+		 * Computes a hash of the core and checks if an equivalent core exists
+		 * in the dictionary. If it exists, returns the existing label.
+		 * Otherwise, the core is inserted with a new label. Safe to call
+		 * concurrently.
 		 *
 		 * @param data Pointer to the array representing the core.
 		 * @return The unique ID (label) of the core in the `cores_map`.
@@ -154,39 +459,51 @@ namespace lcp {
 		/**
 		 * @brief Computes a hash value for a given array of `ulabel`.
 		 *
-		 * Uses the MurmurHash3 hashing algorithm to compute a hash value for
-		 * the input array. Frees the memory allocated for the input array after
-		 * hashing.
+		 * Uses the function selected by `set_backend`: the MurmurHash3 hashing
+		 * algorithm, or MurmurHash64A when labels are 64-bit, or the mixer.
 		 *
 		 * @param data Pointer to the array to be hashed.
 		 * @return The computed hash value.
 		 */
 		ulabel simple(const ulabel data[4]);
 
+		/**
+		 * @brief Computes the hash values of consecutive arrays of four `ulabel`.
+		 *
+		 * Same as calling `simple` for each array, the function is selected once
+		 * and independent arrays are hashed in the same loop. `core_array` labels
+		 * the cores of every level above 1 this way (see `core_array::hash_labels`).
+		 *
+		 * @param data Pointer to `count` arrays stored one after another.
+		 * @param count The number of arrays.
+		 * @param labels Pointer to where the `count` hash values are written.
+		 */
+		void simple(const ulabel *data, size_t count, ulabel *labels);
+
 		/**
 		 * @brief Provides a summary of hash map statistics for two maps:
 		 * `str_map` and `cores_map`.
 		 *
 		 * This function computes and outputs various statistics about two hash
-		 * maps (`str_map` and `cores_map`), including the load factor, bucket
-		 * count, number of collisions, number of empty buckets, and the maximum
-		 * bucket size. The summary provides insight into the efficiency of the
-		 * hash maps and their underlying bucket distribution.
+		 * maps (`str_map` and `cores_map`), including the load factor, slot
+		 * count, number of collisions, number of empty slots, and the longest
+		 * probe sequence. The summary provides insight into the efficiency of
+		 * the hash maps and their underlying slot distribution.
 		 *
 		 * The statistics are printed in the following format for each map:
 		 *
-		 *     map_name = <load_factor> <bucket_count> <collisions>
-		 * <empty_buckets> <max_bucket_size>
+		 *     map_name = <load_factor> <slot_count> <collisions>
+		 * <empty_slots> <max_probe_length>
 		 *
 		 * Where:
 		 * - `load_factor` is the ratio of the number of elements to the number
-		 * of buckets.
-		 * - `bucket_count` is the total number of buckets.
-		 * - `collisions` refers to the number of hash collisions (entries
-		 * sharing the same bucket).
-		 * - `empty_buckets` is the number of buckets with no entries.
-		 * - `max_bucket_size` is the largest number of entries in any single
-		 * bucket.
+		 * of slots.
+		 * - `slot_count` is the total number of slots over all shards.
+		 * - `collisions` refers to the number of entries not stored in their
+		 * home slot.
+		 * - `empty_slots` is the number of slots with no entries.
+		 * - `max_probe_length` is the largest number of slots probed to find
+		 * an entry.
 		 */
 		void summary();
 
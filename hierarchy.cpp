@@ -0,0 +1,101 @@
+#include "hierarchy.h"
+#include "lps.h"
+
+namespace lcp {
+
+	hierarchy::hierarchy(const char *begin, const char *end, int lcp_level, bool use_map) {
+
+		this->layers.resize(1);
+
+		struct layer &first = this->layers.front();
+		first.cores.level = 1;
+		first.cores.label_flags = lcpt::labelling(1, use_map);
+
+		if (begin < end) {
+			size_t capacity = (end - begin) / CONSTANT_FACTOR;
+			first.cores.reserve(capacity);
+			first.firsts.reserve(capacity);
+			first.lasts.reserve(capacity);
+
+			struct sink output = {&first};
+			stats::stage parsing(1, stats::PARSE_TIME);
+			lps::parse_alphabet(begin, end, &output, use_map);
+		}
+
+		this->deepen(lcp_level, use_map);
+	};
+
+	hierarchy::hierarchy(const std::string &str, int lcp_level, bool use_map) : hierarchy(str.data(), str.data() + str.size(), lcp_level, use_map) {};
+
+	bool hierarchy::deepen(bool use_map) {
+
+		// Compress cores of the top level, they are kept in compressed form
+		stats::stage compressing(this->level() + 1, stats::DCT_TIME);
+
+		if (!this->layers.back().cores.dct()) {
+			return false;
+		}
+
+		compressing.stop();
+
+		this->layers.emplace_back();
+
+		struct layer &curr = this->layers[this->layers.size() - 2];
+		struct layer &next = this->layers.back();
+
+		size_t capacity = curr.cores.size() / CONSTANT_FACTOR;
+		next.cores.level = curr.cores.level + 1;
+		next.cores.label_flags = lcpt::labelling(next.cores.level, use_map);
+		next.cores.reserve(capacity);
+		next.firsts.reserve(capacity);
+		next.lasts.reserve(capacity);
+
+		// spans are indices of the cores in the level below
+		struct sink output = {&next};
+		stats::stage parsing(next.cores.level, stats::PARSE_TIME);
+		lps::parse(curr.cores.begin() + DCT_ITERATION_COUNT, curr.cores.end(), &output, DCT_ITERATION_COUNT, array_compare,
+				   [](core_array::iterator, core_array::iterator it1, core_array::iterator it2) { return std::make_pair(static_cast<size_t>(it1.index), static_cast<size_t>(it2.index)); },
+				   array_size, array_rep, array_data, use_map);
+		next.cores.hash_labels();
+
+		return true;
+	};
+
+	bool hierarchy::deepen(int lcp_level, bool use_map) {
+
+		while (this->level() < lcp_level && this->deepen(use_map))
+			;
+
+		return this->level() >= lcp_level;
+	};
+
+	std::pair<size_t, size_t> hierarchy::position(int lcp_level, size_t index) const {
+
+		size_t first = index, last = index;
+
+		// follow the first and the last child down to level 1
+		for (int curr = lcp_level; curr > 1; curr--) {
+			const struct layer &layer = this->layers[curr - 1];
+			size_t next_first = layer.firsts[first];
+			size_t next_last = layer.lasts[last] - 1;
+			first = next_first;
+			last = next_last;
+		}
+
+		const struct layer &bottom = this->layers.front();
+
+		return std::make_pair(bottom.firsts[first], bottom.lasts[last]);
+	};
+
+	double hierarchy::memsize() const {
+		double total = sizeof(*this);
+
+		for (std::vector<struct layer>::const_iterator it = this->layers.begin(); it != this->layers.end(); it++) {
+			total += it->cores.memsize();
+			total += (it->firsts.size() + it->lasts.size()) * sizeof(uint32_t);
+		}
+
+		return total;
+	};
+
+}; // namespace lcp
@@ -0,0 +1,164 @@
+/**
+ * @file hierarchy.h
+ * @brief Keeps every LCP level of a sequence with a cross-level position index.
+ *
+ * `lps` and `core_array` replace the cores of a level when they are deepened, so
+ * a core can only be mapped back to the input when `STATS` is compiled in. The
+ * `hierarchy` struct instead keeps the cores of every level in a `core_array`
+ * and, for every core, the span of the cores of the level below it is built
+ * from, as two 32-bit offsets. The spans of level 1 cores are character
+ * positions.
+ *
+ * A core is drilled down to its children in O(1), and its position in the input
+ * is found by following the first and last child down to level 1, i.e. in as
+ * many steps as its level. No `STATS` build is needed, and per core only the
+ * two offsets are added to the columnar storage.
+ *
+ * Lower levels hold their cores after DCT compression, which is the form the
+ * level above is built from; labels are not affected by compression.
+ *
+ * Example usage:
+ * @code
+ *   lcp::hierarchy index(sequence, 4);
+ *   std::pair<size_t, size_t> children = index.children(4, 10);
+ *   std::pair<size_t, size_t> position = index.position(4, 10);
+ * @endcode
+ *
+ * @see core_array.h
+ * @see lps.h
+ *
+ * @namespace lcp
+ * @struct hierarchy
+ *
+ * @note Sequences are limited to 2^32 characters by the 32-bit offsets.
+ *
+ */
+
+#ifndef HIERARCHY_H
+#define HIERARCHY_H
+
+#include "constant.h"
+#include "core_array.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lcp {
+
+	struct hierarchy {
+	  public:
+		/**
+		 * @brief The cores of a level and the spans of their children.
+		 *
+		 * Core `i` is built from the elements [firsts[i], lasts[i]) of the level below,
+		 * or from the characters [firsts[i], lasts[i]) at level 1.
+		 */
+		struct layer {
+			core_array cores;
+			std::vector<uint32_t> firsts;
+			std::vector<uint32_t> lasts;
+		};
+
+		std::vector<struct layer> layers;
+
+		/**
+		 * @brief Parses a raw character range and deepens it to the given level, keeping every level.
+		 *
+		 * @param begin Pointer to the first character of the sequence.
+		 * @param end Pointer past the last character of the sequence.
+		 * @param lcp_level The level to deepen to.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 */
+		hierarchy(const char *begin, const char *end, int lcp_level = 1, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Parses a string and deepens it to the given level, keeping every level.
+		 *
+		 * @param str The input string to be parsed.
+		 * @param lcp_level The level to deepen to.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 */
+		hierarchy(const std::string &str, int lcp_level = 1, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Adds the next level on top of the current one.
+		 *
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @return True if a level is added, false if the top level has too few cores.
+		 */
+		bool deepen(bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Adds levels until the given level is reached.
+		 *
+		 * @param lcp_level The target level.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @return True if the target level is reached.
+		 */
+		bool deepen(int lcp_level, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Returns the highest level.
+		 */
+		inline int level() const {
+			return static_cast<int>(this->layers.size());
+		};
+
+		/**
+		 * @brief Returns the cores of a level.
+		 *
+		 * @param lcp_level The level, from 1 to `level()`.
+		 * @return The cores of the level.
+		 */
+		inline const core_array &at(int lcp_level) const {
+			return this->layers[lcp_level - 1].cores;
+		};
+
+		/**
+		 * @brief Returns the span of the children of a core, in the level below it.
+		 *
+		 * @param lcp_level The level of the core.
+		 * @param index The index of the core in its level.
+		 * @return The range of indices in level `lcp_level - 1`, or of characters at level 1.
+		 */
+		inline std::pair<size_t, size_t> children(int lcp_level, size_t index) const {
+			const struct layer &curr = this->layers[lcp_level - 1];
+			return std::make_pair(curr.firsts[index], curr.lasts[index]);
+		};
+
+		/**
+		 * @brief Returns the characters covered by a core.
+		 *
+		 * @param lcp_level The level of the core.
+		 * @param index The index of the core in its level.
+		 * @return The range [start, end) of characters in the input sequence.
+		 */
+		std::pair<size_t, size_t> position(int lcp_level, size_t index) const;
+
+		/**
+		 * @brief Calculates and returns the memory size used by all levels.
+		 *
+		 * @return The memory size (in bytes).
+		 */
+		double memsize() const;
+
+	  private:
+		/**
+		 * @brief Container passed to the parser, storing each core with the span its indices describe.
+		 */
+		struct sink {
+			struct layer *target;
+
+			template <typename Iterator, typename Size, typename Representation, typename Data>
+			void emplace_back(Iterator begin, Iterator end, std::pair<size_t, size_t> indeces, Size size, Representation rep, Data data, bool use_map) {
+				this->target->cores.emplace_back(begin, end, indeces, size, rep, data, use_map);
+				this->target->firsts.push_back(static_cast<uint32_t>(indeces.first));
+				this->target->lasts.push_back(static_cast<uint32_t>(indeces.second));
+			};
+		};
+	};
+
+}; // namespace lcp
+
+#endif
@@ -0,0 +1,284 @@
+#include "inverted_index.h"
+#include "lcpt.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace lcp {
+
+	struct index_header {
+		char magic[4];
+		uint16_t version;
+		uint16_t flags;
+		uint32_t sequence_count;
+		uint32_t padding;
+		uint64_t label_count;
+		uint64_t posting_count;
+	};
+
+	static_assert(sizeof(struct index_header) == 32, "index header must be 32 bytes");
+
+	inverted_index::inverted_index() {
+		this->label_flags = 0;
+		this->offsets.push_back(0);
+	};
+
+	inverted_index::inverted_index(const std::vector<lps *> &collection, size_t thread_number) {
+
+		this->label_flags = collection.empty() ? 0 : collection.front()->label_flags;
+
+		for (size_t sequence = 0; sequence < collection.size(); sequence++) {
+			this->check(collection[sequence]->label_flags);
+		}
+
+		this->build(collection.size(), thread_number, [&](size_t sequence, std::vector<struct entry> &entries) {
+			const std::vector<struct core> *curr = collection[sequence]->cores;
+
+			if (curr == nullptr) {
+				return;
+			}
+
+			for (size_t index = 0; index < curr->size(); index++) {
+				struct entry temp = {(*curr)[index].label, static_cast<uint32_t>(sequence), static_cast<uint32_t>(index)};
+				entries.push_back(temp);
+			}
+		});
+	};
+
+	inverted_index::inverted_index(const std::vector<core_array> &collection, size_t thread_number) {
+
+		this->label_flags = collection.empty() ? 0 : collection.front().label_flags;
+
+		for (size_t sequence = 0; sequence < collection.size(); sequence++) {
+			this->check(collection[sequence].label_flags);
+		}
+
+		this->build(collection.size(), thread_number, [&](size_t sequence, std::vector<struct entry> &entries) {
+			const std::vector<ulabel> &curr = collection[sequence].labels;
+
+			for (size_t index = 0; index < curr.size(); index++) {
+				struct entry temp = {curr[index], static_cast<uint32_t>(sequence), static_cast<uint32_t>(index)};
+				entries.push_back(temp);
+			}
+		});
+	};
+
+	template <typename Collect>
+	void inverted_index::build(size_t count, size_t thread_number, Collect collect) {
+
+		auto less = [](const struct entry &lhs, const struct entry &rhs) {
+			if (lhs.label != rhs.label) return lhs.label < rhs.label;
+			if (lhs.sequence != rhs.sequence) return lhs.sequence < rhs.sequence;
+			return lhs.index < rhs.index;
+		};
+
+		size_t slice_count = std::max(static_cast<size_t>(1), std::min(thread_number, count));
+		std::vector<std::vector<struct entry>> slices(slice_count);
+
+		// every thread collects and sorts a contiguous slice of the collection
+		parallel::run(slice_count, thread_number, [&](size_t slice_index) {
+			size_t first = count * slice_index / slice_count;
+			size_t last = count * (slice_index + 1) / slice_count;
+
+			for (size_t sequence = first; sequence < last; sequence++) {
+				collect(sequence, slices[slice_index]);
+			}
+
+			std::sort(slices[slice_index].begin(), slices[slice_index].end(), less);
+		});
+
+		// merge neighbouring slices until a single sorted slice is left
+		while (slices.size() > 1) {
+			std::vector<std::vector<struct entry>> merged((slices.size() + 1) / 2);
+
+			parallel::run(merged.size(), thread_number, [&](size_t merged_index) {
+				if (2 * merged_index + 1 == slices.size()) {
+					merged[merged_index].swap(slices[2 * merged_index]);
+					return;
+				}
+
+				std::vector<struct entry> &lhs = slices[2 * merged_index];
+				std::vector<struct entry> &rhs = slices[2 * merged_index + 1];
+
+				merged[merged_index].resize(lhs.size() + rhs.size());
+				std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), merged[merged_index].begin(), less);
+
+				std::vector<struct entry>().swap(lhs);
+				std::vector<struct entry>().swap(rhs);
+			});
+
+			slices.swap(merged);
+		}
+
+		const std::vector<struct entry> &entries = slices.front();
+
+		this->labels.clear();
+		this->offsets.clear();
+		this->sequences.resize(entries.size());
+		this->cores.resize(entries.size());
+		this->distinct.assign(count, 0);
+
+		for (size_t index = 0; index < entries.size(); index++) {
+			const struct entry &curr = entries[index];
+
+			bool new_label = index == 0 || curr.label != entries[index - 1].label;
+
+			if (new_label) {
+				this->labels.push_back(curr.label);
+				this->offsets.push_back(index);
+			}
+
+			// postings of a label are ordered by sequence, so a sequence is counted once per label
+			if (new_label || curr.sequence != entries[index - 1].sequence) {
+				this->distinct[curr.sequence]++;
+			}
+
+			this->sequences[index] = curr.sequence;
+			this->cores[index] = curr.index;
+		}
+
+		this->offsets.push_back(entries.size());
+	};
+
+	void inverted_index::check(uint16_t label_flags) const {
+		if (!lcpt::comparable(this->label_flags, label_flags)) {
+			throw std::invalid_argument("Labels computed differently are compared.");
+		}
+	};
+
+	std::pair<size_t, size_t> inverted_index::postings(ulabel label) const {
+
+		std::vector<ulabel>::const_iterator it = std::lower_bound(this->labels.begin(), this->labels.end(), label);
+
+		if (it == this->labels.end() || *it != label) {
+			return std::make_pair(0, 0);
+		}
+
+		size_t index = it - this->labels.begin();
+
+		return std::make_pair(this->offsets[index], this->offsets[index + 1]);
+	};
+
+	size_t inverted_index::shared(std::vector<ulabel> &query, std::vector<size_t> &counts) const {
+
+		std::sort(query.begin(), query.end());
+		query.erase(std::unique(query.begin(), query.end()), query.end());
+
+		counts.assign(this->size(), 0);
+
+		for (std::vector<ulabel>::const_iterator it = query.begin(); it != query.end(); it++) {
+			std::pair<size_t, size_t> range = this->postings(*it);
+
+			uint32_t previous = std::numeric_limits<uint32_t>::max();
+
+			for (size_t index = range.first; index < range.second; index++) {
+				if (this->sequences[index] != previous) {
+					previous = this->sequences[index];
+					counts[previous]++;
+				}
+			}
+		}
+
+		return query.size();
+	};
+
+	size_t inverted_index::shared(const lps &query, std::vector<size_t> &counts) const {
+		this->check(query.label_flags);
+
+		std::vector<ulabel> query_labels;
+		query.get_labels(query_labels);
+
+		return this->shared(query_labels, counts);
+	};
+
+	size_t inverted_index::shared(const core_array &query, std::vector<size_t> &counts) const {
+		this->check(query.label_flags);
+
+		std::vector<ulabel> query_labels(query.labels);
+
+		return this->shared(query_labels, counts);
+	};
+
+	void inverted_index::jaccard(std::vector<ulabel> &query, std::vector<double> &scores) const {
+
+		std::vector<size_t> counts;
+		size_t query_count = this->shared(query, counts);
+
+		scores.assign(this->size(), 0);
+
+		for (size_t sequence = 0; sequence < this->size(); sequence++) {
+			size_t total = query_count + this->distinct[sequence] - counts[sequence];
+
+			if (total > 0) {
+				scores[sequence] = static_cast<double>(counts[sequence]) / total;
+			}
+		}
+	};
+
+	void inverted_index::jaccard(const lps &query, std::vector<double> &scores) const {
+		this->check(query.label_flags);
+
+		std::vector<ulabel> query_labels;
+		query.get_labels(query_labels);
+
+		this->jaccard(query_labels, scores);
+	};
+
+	void inverted_index::jaccard(const core_array &query, std::vector<double> &scores) const {
+		this->check(query.label_flags);
+
+		std::vector<ulabel> query_labels(query.labels);
+
+		this->jaccard(query_labels, scores);
+	};
+
+	void inverted_index::write(std::ofstream &out) const {
+
+		struct index_header hdr;
+
+		memcpy(hdr.magic, INDEX_MAGIC, 4);
+		hdr.version = INDEX_VERSION;
+		hdr.flags = (this->label_flags & LCPT_LABELS) | LCPT_WIDTH;
+		hdr.sequence_count = this->distinct.size();
+		hdr.padding = 0;
+		hdr.label_count = this->labels.size();
+		hdr.posting_count = this->sequences.size();
+
+		out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+
+		lcpt::write_section(out, this->labels.data(), this->labels.size() * sizeof(ulabel));
+		lcpt::write_section(out, this->offsets.data(), this->offsets.size() * sizeof(uint64_t));
+		lcpt::write_section(out, this->sequences.data(), this->sequences.size() * sizeof(uint32_t));
+		lcpt::write_section(out, this->cores.data(), this->cores.size() * sizeof(uint32_t));
+		lcpt::write_section(out, this->distinct.data(), this->distinct.size() * sizeof(uint32_t));
+	};
+
+	bool inverted_index::read(std::ifstream &in) {
+
+		struct index_header hdr;
+
+		if (!in.read(reinterpret_cast<char *>(&hdr), sizeof(hdr)) || memcmp(hdr.magic, INDEX_MAGIC, 4) != 0 || (hdr.flags & ~LCPT_LABELS) != LCPT_WIDTH || hdr.version != INDEX_VERSION) {
+			return false;
+		}
+
+		this->label_flags = hdr.flags & LCPT_LABELS;
+
+		lcpt::read_section(in, this->labels, hdr.label_count);
+		lcpt::read_section(in, this->offsets, hdr.label_count + 1);
+		lcpt::read_section(in, this->sequences, hdr.posting_count);
+		lcpt::read_section(in, this->cores, hdr.posting_count);
+		lcpt::read_section(in, this->distinct, hdr.sequence_count);
+
+		return static_cast<bool>(in);
+	};
+
+	double inverted_index::memsize() const {
+		return sizeof(*this) +
+			   this->labels.capacity() * sizeof(ulabel) +
+			   this->offsets.capacity() * sizeof(uint64_t) +
+			   (this->sequences.capacity() + this->cores.capacity() + this->distinct.capacity()) * sizeof(uint32_t);
+	};
+
+}; // namespace lcp
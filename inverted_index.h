@@ -0,0 +1,188 @@
+/**
+ * @file inverted_index.h
+ * @brief Inverted index from core labels to the sequences containing them.
+ *
+ * The `inverted_index` struct maps every label of a collection of parsed
+ * sequences to its postings, the (sequence id, core index) pairs where the
+ * label occurs. It is stored in compressed sparse row form: the distinct
+ * labels in sorted order, one offset per label into the postings, and the
+ * postings as two 32-bit columns ordered by sequence id. Lookups are a binary
+ * search over a flat label array followed by a linear scan, without any
+ * per-label allocation.
+ *
+ * The index is built in parallel: every thread collects and sorts the labels of
+ * a contiguous slice of the collection, and the sorted slices are merged pairwise.
+ * It is written with the section layout of .lcpt files under its own header:
+ *
+ *   header | labels | offsets | sequences | cores | distinct
+ *
+ * Example usage:
+ * @code
+ *   lcp::inverted_index index(collection, 8);
+ *   std::vector<double> scores;
+ *   index.jaccard(query, scores);   // one estimate per indexed sequence
+ * @endcode
+ *
+ * @see lcpt.h
+ * @see parallel.h
+ *
+ * @namespace lcp
+ * @struct inverted_index
+ *
+ * @note Sequence ids and core indices are limited to 2^32 by the 32-bit columns.
+ *
+ */
+
+#ifndef INVERTED_INDEX_H
+#define INVERTED_INDEX_H
+
+#include "constant.h"
+#include "core_array.h"
+#include "lps.h"
+#include <cstdint>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#define INDEX_MAGIC             "LCPI"
+#define INDEX_VERSION           1
+
+namespace lcp {
+
+	struct inverted_index {
+	  public:
+		std::vector<ulabel> labels;
+		std::vector<uint64_t> offsets;
+		std::vector<uint32_t> sequences;
+		std::vector<uint32_t> cores;
+		std::vector<uint32_t> distinct;
+
+		// How the indexed labels were computed, see `lcpt::labelling`
+		uint16_t label_flags;
+
+		/**
+		 * @brief Constructs an empty index.
+		 */
+		inverted_index();
+
+		/**
+		 * @brief Builds the index of a collection of `lps` objects, sequence `i` being `collection[i]`.
+		 *
+		 * @param collection The parsed sequences.
+		 * @param thread_number The number of threads building the index (default is 1).
+		 * @throws std::invalid_argument if the labels of the sequences were computed differently.
+		 */
+		inverted_index(const std::vector<lps *> &collection, size_t thread_number = LCP_THREAD_NUMBER);
+
+		/**
+		 * @brief Builds the index of a collection of `core_array` objects, sequence `i` being `collection[i]`.
+		 *
+		 * @param collection The parsed sequences.
+		 * @param thread_number The number of threads building the index (default is 1).
+		 * @throws std::invalid_argument if the labels of the sequences were computed differently.
+		 */
+		inverted_index(const std::vector<core_array> &collection, size_t thread_number = LCP_THREAD_NUMBER);
+
+		/**
+		 * @brief Returns the range of postings of a label.
+		 *
+		 * @param label The label to look up.
+		 * @return The range [first, last) of the postings, empty if the label is not indexed.
+		 */
+		std::pair<size_t, size_t> postings(ulabel label) const;
+
+		/**
+		 * @brief Counts the distinct labels every indexed sequence shares with the query.
+		 *
+		 * @param query The parsed query sequence.
+		 * @param counts Receives one count per indexed sequence.
+		 * @return The number of distinct labels of the query.
+		 * @throws std::invalid_argument if the labels of the query were computed differently.
+		 */
+		size_t shared(const lps &query, std::vector<size_t> &counts) const;
+
+		/**
+		 * @brief Counts the distinct labels every indexed sequence shares with the query.
+		 *
+		 * @param query The parsed query sequence.
+		 * @param counts Receives one count per indexed sequence.
+		 * @return The number of distinct labels of the query.
+		 * @throws std::invalid_argument if the labels of the query were computed differently.
+		 */
+		size_t shared(const core_array &query, std::vector<size_t> &counts) const;
+
+		/**
+		 * @brief Estimates the Jaccard similarity of the query and every indexed sequence.
+		 *
+		 * The similarity is computed on the sets of distinct labels.
+		 *
+		 * @param query The parsed query sequence.
+		 * @param scores Receives one similarity per indexed sequence.
+		 * @throws std::invalid_argument if the labels of the query were computed differently.
+		 */
+		void jaccard(const lps &query, std::vector<double> &scores) const;
+
+		/**
+		 * @brief Estimates the Jaccard similarity of the query and every indexed sequence.
+		 *
+		 * @param query The parsed query sequence.
+		 * @param scores Receives one similarity per indexed sequence.
+		 * @throws std::invalid_argument if the labels of the query were computed differently.
+		 */
+		void jaccard(const core_array &query, std::vector<double> &scores) const;
+
+		/**
+		 * @brief Writes the index to a file.
+		 *
+		 * @param out The output file stream.
+		 */
+		void write(std::ofstream &out) const;
+
+		/**
+		 * @brief Reads an index written by `write`.
+		 *
+		 * @param in The input file stream.
+		 * @return True if a valid index was read.
+		 */
+		bool read(std::ifstream &in);
+
+		/**
+		 * @brief Returns the number of indexed sequences.
+		 */
+		inline size_t size() const {
+			return this->distinct.size();
+		};
+
+		/**
+		 * @brief Calculates and returns the memory size used by the index.
+		 *
+		 * @return The memory size (in bytes).
+		 */
+		double memsize() const;
+
+	  private:
+		struct entry {
+			ulabel label;
+			uint32_t sequence;
+			uint32_t index;
+		};
+
+		/**
+		 * @brief Builds the index from `count` sequences whose labels are added by `collect`.
+		 */
+		template <typename Collect>
+		void build(size_t count, size_t thread_number, Collect collect);
+
+		/**
+		 * @brief Throws if labels with the given flags cannot be compared to the indexed ones.
+		 */
+		void check(uint16_t label_flags) const;
+
+		size_t shared(std::vector<ulabel> &query, std::vector<size_t> &counts) const;
+
+		void jaccard(std::vector<ulabel> &query, std::vector<double> &scores) const;
+	};
+
+}; // namespace lcp
+
+#endif
@@ -0,0 +1,299 @@
+#include "lcpt.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lcp {
+
+	namespace lcpt {
+
+		static_assert(sizeof(struct header) == 32, "lcpt header must be 32 bytes");
+		static_assert(sizeof(size_t) == sizeof(uint64_t), "offsets and positions are stored as 64-bit values");
+		static_assert(sizeof(struct gap) == 3 * sizeof(uint64_t), "gaps are stored as three 64-bit values");
+
+		template <typename Sink>
+		inline void write_section(Sink &sink, const void *data, size_t length) {
+			static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+			if (length > 0) {
+				sink(reinterpret_cast<const char *>(data), length);
+			}
+			sink(padding, section_size(length) - length);
+		};
+
+		inline bool valid(const struct header &hdr) {
+			// records of earlier versions only lack the name and gap flags, they are read the same way
+			return memcmp(hdr.magic, LCPT_MAGIC, 4) == 0 && 1 <= hdr.version && hdr.version <= LCPT_VERSION && (hdr.flags & LCPT_WIDE) == LCPT_WIDTH;
+		};
+
+		record::record() {
+			this->name = nullptr;
+			this->name_length = 0;
+			this->gaps = nullptr;
+			this->gap_count = 0;
+			this->level = 1;
+			this->label_flags = 0;
+			this->core_count = 0;
+			this->block_count = 0;
+			this->labels = nullptr;
+			this->bit_sizes = nullptr;
+			this->blocks = nullptr;
+			this->offsets = nullptr;
+			this->starts = nullptr;
+			this->ends = nullptr;
+		};
+
+		uint16_t labelling(int level, bool use_map) {
+			if (use_map) {
+				return LCPT_IDS;
+			}
+
+			return 1 < level && hash::get_backend() == hash::MIX ? LCPT_MIX : 0;
+		};
+
+		struct core record::get(size_t index) const {
+			size_t start = this->starts != nullptr ? this->starts[index] : 0;
+			size_t end = this->ends != nullptr ? this->ends[index] : 0;
+
+			return core(this->bit_rep(index), this->bit_sizes[index], this->labels[index], start, end);
+		};
+
+		template <typename Sink>
+		void write_record(Sink &sink, const struct record &rec) {
+			struct header hdr;
+
+			memcpy(hdr.magic, LCPT_MAGIC, 4);
+			hdr.version = LCPT_VERSION;
+			hdr.flags = (rec.offsets != nullptr ? LCPT_OFFSETS : 0) | (rec.starts != nullptr ? LCPT_POSITIONS : 0) | (rec.name_length > 0 ? LCPT_NAME : 0) | (rec.gap_count > 0 ? LCPT_GAPS : 0) | (rec.label_flags & LCPT_LABELS) | LCPT_WIDTH;
+			hdr.level = rec.level;
+			hdr.name_length = rec.name_length;
+			hdr.size = rec.core_count;
+			hdr.block_count = rec.block_count;
+
+			sink(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+
+			if (rec.name_length > 0) {
+				write_section(sink, rec.name, rec.name_length);
+			}
+
+			if (rec.gap_count > 0) {
+				uint64_t gap_count = rec.gap_count;
+				write_section(sink, &gap_count, sizeof(gap_count));
+				write_section(sink, rec.gaps, rec.gap_count * sizeof(struct gap));
+			}
+
+			write_section(sink, rec.labels, rec.core_count * sizeof(ulabel));
+			write_section(sink, rec.bit_sizes, rec.core_count * sizeof(ubit_size));
+			write_section(sink, rec.blocks, rec.block_count * sizeof(ublock));
+
+			if (rec.offsets != nullptr) {
+				write_section(sink, rec.offsets, (rec.core_count + 1) * sizeof(uint64_t));
+			}
+
+			if (rec.starts != nullptr) {
+				write_section(sink, rec.starts, rec.core_count * sizeof(uint64_t));
+				write_section(sink, rec.ends, rec.core_count * sizeof(uint64_t));
+			}
+		};
+
+		void write(std::ostream &out, const struct record &rec) {
+			auto sink = [&out](const char *data, size_t length) { out.write(data, length); };
+			write_record(sink, rec);
+		};
+
+		void write(std::string &out, const struct record &rec) {
+			auto sink = [&out](const char *data, size_t length) { out.append(data, length); };
+			write_record(sink, rec);
+		};
+
+		size_t record_size(const struct record &rec) {
+			size_t size = sizeof(struct header) + section_size(rec.name_length);
+
+			if (rec.gap_count > 0) {
+				size += section_size(sizeof(uint64_t)) + section_size(rec.gap_count * sizeof(struct gap));
+			}
+
+			size += section_size(rec.core_count * sizeof(ulabel)) + section_size(rec.core_count * sizeof(ubit_size)) + section_size(rec.block_count * sizeof(ublock));
+
+			if (rec.offsets != nullptr) {
+				size += section_size((rec.core_count + 1) * sizeof(uint64_t));
+			}
+
+			if (rec.starts != nullptr) {
+				size += 2 * section_size(rec.core_count * sizeof(uint64_t));
+			}
+
+			return size;
+		};
+
+		void write_section(std::ostream &out, const void *data, size_t length) {
+			auto sink = [&out](const char *data, size_t length) { out.write(data, length); };
+			write_section(sink, data, length);
+		};
+
+		bool read_header(std::istream &in, struct header &hdr, std::string *name, std::vector<struct gap> *gaps) {
+			std::streampos position = in.tellg();
+
+			if (in.read(reinterpret_cast<char *>(&hdr), sizeof(hdr)) && valid(hdr)) {
+				size_t name_length = hdr.flags & LCPT_NAME ? hdr.name_length : 0;
+
+				if (name != nullptr) {
+					name->resize(name_length);
+					if (name_length > 0) {
+						in.read(&(*name)[0], name_length);
+					}
+					in.ignore(section_size(name_length) - name_length);
+				} else {
+					in.ignore(section_size(name_length));
+				}
+
+				if (gaps != nullptr) {
+					gaps->clear();
+				}
+
+				if (hdr.flags & LCPT_GAPS) {
+					uint64_t gap_count = 0;
+					in.read(reinterpret_cast<char *>(&gap_count), sizeof(gap_count));
+
+					if (gaps != nullptr) {
+						read_section(in, *gaps, gap_count);
+					} else {
+						in.ignore(section_size(gap_count * sizeof(struct gap)));
+					}
+				}
+
+				return true;
+			}
+
+			in.clear();
+			in.seekg(position);
+
+			return false;
+		};
+
+		view::view(const std::string &filename) {
+			this->data = nullptr;
+			this->length = 0;
+
+			int fd = open(filename.c_str(), O_RDONLY);
+
+			if (fd < 0) {
+				return;
+			}
+
+			struct stat st;
+
+			if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+				close(fd);
+				return;
+			}
+
+			void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			close(fd);
+
+			if (mapped == MAP_FAILED) {
+				return;
+			}
+
+			this->data = static_cast<const char *>(mapped);
+			this->length = st.st_size;
+
+			// index records, their sections are used in place
+			size_t position = 0;
+
+			while (position + sizeof(struct header) <= this->length) {
+
+				const struct header *hdr = reinterpret_cast<const struct header *>(this->data + position);
+
+				if (!valid(*hdr) || this->length < hdr->size || this->length < hdr->block_count) {
+					break;
+				}
+
+				size_t name_length = hdr->flags & LCPT_NAME ? hdr->name_length : 0;
+				size_t gaps_at = position + sizeof(struct header) + section_size(name_length);
+				size_t gap_count = 0;
+
+				if (hdr->flags & LCPT_GAPS) {
+					if (this->length < gaps_at + sizeof(uint64_t)) {
+						break;
+					}
+
+					gap_count = *reinterpret_cast<const uint64_t *>(this->data + gaps_at);
+
+					if (this->length / sizeof(struct gap) < gap_count) {
+						break;
+					}
+				}
+
+				size_t record_size = sizeof(struct header) +
+									 section_size(name_length) +
+									 (hdr->flags & LCPT_GAPS ? sizeof(uint64_t) + section_size(gap_count * sizeof(struct gap)) : 0) +
+									 section_size(hdr->size * sizeof(ulabel)) +
+									 section_size(hdr->size * sizeof(ubit_size)) +
+									 section_size(hdr->block_count * sizeof(ublock)) +
+									 (hdr->flags & LCPT_OFFSETS ? section_size((hdr->size + 1) * sizeof(uint64_t)) : 0) +
+									 (hdr->flags & LCPT_POSITIONS ? 2 * section_size(hdr->size * sizeof(uint64_t)) : 0);
+
+				// truncated record
+				if (this->length - position < record_size) {
+					break;
+				}
+
+				struct record rec;
+				const char *it = this->data + position + sizeof(struct header);
+
+				if (name_length > 0) {
+					rec.name = it;
+					rec.name_length = name_length;
+					it += section_size(name_length);
+				}
+
+				if (hdr->flags & LCPT_GAPS) {
+					rec.gaps = reinterpret_cast<const struct gap *>(it + sizeof(uint64_t));
+					rec.gap_count = gap_count;
+					it += sizeof(uint64_t) + section_size(gap_count * sizeof(struct gap));
+				}
+
+				rec.level = hdr->level;
+				rec.label_flags = hdr->flags & LCPT_LABELS;
+				rec.core_count = hdr->size;
+				rec.block_count = hdr->block_count;
+
+				rec.labels = reinterpret_cast<const ulabel *>(it);
+				it += section_size(hdr->size * sizeof(ulabel));
+				rec.bit_sizes = reinterpret_cast<const ubit_size *>(it);
+				it += section_size(hdr->size * sizeof(ubit_size));
+				rec.blocks = reinterpret_cast<const ublock *>(it);
+				it += section_size(hdr->block_count * sizeof(ublock));
+
+				if (hdr->flags & LCPT_OFFSETS) {
+					rec.offsets = reinterpret_cast<const uint64_t *>(it);
+					it += section_size((hdr->size + 1) * sizeof(uint64_t));
+				}
+
+				if (hdr->flags & LCPT_POSITIONS) {
+					rec.starts = reinterpret_cast<const uint64_t *>(it);
+					it += section_size(hdr->size * sizeof(uint64_t));
+					rec.ends = reinterpret_cast<const uint64_t *>(it);
+				}
+
+				this->records.push_back(rec);
+				position += record_size;
+			}
+		};
+
+		view::~view() {
+			if (this->data != nullptr) {
+				munmap(const_cast<char *>(this->data), this->length);
+			}
+		};
+
+		bool view::is_open() const {
+			return this->data != nullptr;
+		};
+
+	}; // namespace lcpt
+
+}; // namespace lcp
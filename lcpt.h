@@ -0,0 +1,283 @@
+/**
+ * @file lcpt.h
+ * @brief Versioned binary container for LCP cores (.lcpt files).
+ *
+ * An .lcpt file is a sequence of records, one per parsed sequence. Every record
+ * starts with a fixed size header followed by columnar sections, each written
+ * with a single bulk write and padded to 8 bytes:
+ *
+ *   header | [name] | [gaps] | labels | bit sizes | blocks | [offsets] | [starts | ends]
+ *
+ * - `name` holds the name of the sequence (e.g. the FASTA record identifier),
+ *   without a terminating null; it is present only if the record is named.
+ * - `gaps` holds the number of gaps as a 64-bit value followed by the start,
+ *   length and first core index of every gap (see gaps.h); it is present only
+ *   if the sequence was parsed in gap-aware mode and has gaps.
+ * - `labels` and `bit sizes` hold one 32-bit value per core.
+ * - `blocks` holds the concatenated representations of the cores.
+ * - `offsets` (`size + 1` 64-bit values) is present only if a core spans more
+ *   than one block; otherwise core `i` owns block `i`.
+ * - `starts` and `ends` (64-bit values) are present only if positions were
+ *   recorded, which no longer depends on how the reader was compiled.
+ *
+ * Values are stored in native byte order. Blocks and labels have the width of
+ * the build, recorded by the `LCPT_WIDE` flag, and records of the other width
+ * are rejected. The flags also record how the labels of the record's level were
+ * computed: `LCPT_IDS` if they are IDs of a label dictionary, along with
+ * `LCPT_MERGED` once they are relabelled to the IDs of a merged dictionary (see
+ * shard.h), `LCPT_MIX` if they were hashed by the mixer of `hash::MIX`, neither
+ * if they are the packed characters of level 1 or MurmurHash3 hashes. Records
+ * before version 4 do not mark dictionary IDs. Since every section is padded, records
+ * and sections stay 8 byte aligned, so `view` can memory-map a file and expose
+ * the cores in place without any per-core allocation.
+ *
+ * Example usage:
+ * @code
+ *   lcp::lcpt::view file("genome.fa.lcpt");
+ *   for (size_t i = 0; i < file.records.size(); i++) {
+ *       const lcp::lcpt::record &rec = file.records[i];
+ *       ulabel first = rec.labels[0];
+ *   }
+ * @endcode
+ *
+ * @see core_array.h
+ *
+ * @namespace lcp::lcpt
+ *
+ */
+
+#ifndef LCPT_H
+#define LCPT_H
+
+#include "constant.h"
+#include "core.h"
+#include "gaps.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define LCPT_MAGIC              "LCPT"
+#define LCPT_VERSION            4
+#define LCPT_POSITIONS          0x1
+#define LCPT_OFFSETS            0x2
+#define LCPT_WIDE               0x4
+#define LCPT_NAME               0x8
+#define LCPT_MIX                0x10
+#define LCPT_GAPS               0x20
+#define LCPT_IDS                0x40
+#define LCPT_MERGED             0x80
+
+// flags telling how the labels of a record were computed
+#define LCPT_LABELS             (LCPT_MIX | LCPT_IDS | LCPT_MERGED)
+
+// flag of the block and label width of this build
+#ifdef LCP_64BIT
+#define LCPT_WIDTH              LCPT_WIDE
+#else
+#define LCPT_WIDTH              0
+#endif
+
+namespace lcp {
+
+	namespace lcpt {
+
+		struct header {
+			char magic[4];
+			uint16_t version;
+			uint16_t flags;
+			int32_t level;
+			uint32_t name_length;
+			uint64_t size;
+			uint64_t block_count;
+		};
+
+		/**
+		 * @brief Non-owning view of the columns of a record.
+		 *
+		 * The pointers either refer to the columns of a `core_array` that is about
+		 * to be written, or into a memory-mapped file. Optional columns are null
+		 * when they are absent.
+		 */
+		struct record {
+			const char *name;
+			size_t name_length;
+			const struct gap *gaps;
+			size_t gap_count;
+			int level;
+			uint16_t label_flags;
+			size_t core_count;
+			size_t block_count;
+			const ulabel *labels;
+			const ubit_size *bit_sizes;
+			const ublock *blocks;
+			const uint64_t *offsets;
+			const uint64_t *starts;
+			const uint64_t *ends;
+
+			record();
+
+			/**
+			 * @brief Returns the number of cores in the record.
+			 */
+			inline size_t size() const {
+				return this->core_count;
+			};
+
+			/**
+			 * @brief Returns the blocks of the core at the given index.
+			 *
+			 * @param index The index of the core.
+			 * @return A pointer to the first block of the core.
+			 */
+			inline const ublock *bit_rep(size_t index) const {
+				return this->blocks + (this->offsets != nullptr ? this->offsets[index] : index);
+			};
+
+			/**
+			 * @brief Builds the `core` object stored at the given index.
+			 *
+			 * @param index The index of the core.
+			 * @return A `core` holding a copy of the representation of the core.
+			 */
+			struct core get(size_t index) const;
+		};
+
+		/**
+		 * @brief Returns the label flags of cores of a level labelled in the current context.
+		 *
+		 * Level 1 labels without the dictionary are the packed characters, which do not
+		 * depend on the label function.
+		 *
+		 * @param level The level of the cores.
+		 * @param use_map Whether the cores are labelled by the label dictionary.
+		 * @return `LCPT_IDS`, `LCPT_MIX` or 0.
+		 */
+		uint16_t labelling(int level, bool use_map);
+
+		/**
+		 * @brief Checks whether labels with the given flags were computed the same way.
+		 *
+		 * Labels computed differently do not match even for the same cores.
+		 *
+		 * @param flags The label flags of the first labels.
+		 * @param other_flags The label flags of the other labels.
+		 * @return True if the labels can be compared.
+		 */
+		inline bool comparable(uint16_t flags, uint16_t other_flags) {
+			return (flags & LCPT_LABELS) == (other_flags & LCPT_LABELS);
+		};
+
+		/**
+		 * @brief Writes a record to an output stream, one write per section.
+		 *
+		 * @param out The output stream.
+		 * @param rec The record to be written.
+		 */
+		void write(std::ostream &out, const struct record &rec);
+
+		/**
+		 * @brief Appends a record to a byte buffer, in the same layout as written to streams.
+		 *
+		 * @param out The buffer to append to.
+		 * @param rec The record to be written.
+		 */
+		void write(std::string &out, const struct record &rec);
+
+		/**
+		 * @brief Returns the number of bytes `write` produces for a record, padding included.
+		 *
+		 * @param rec The record.
+		 */
+		size_t record_size(const struct record &rec);
+
+		/**
+		 * @brief Reads and validates a record header.
+		 *
+		 * If the stream does not continue with a record of a supported version,
+		 * the stream position is restored and false is returned. The name and the
+		 * gaps of the record, if any, are read as well, so the stream continues with
+		 * the labels.
+		 *
+		 * @param in The input stream.
+		 * @param hdr The header to be filled.
+		 * @param name (Optional) The string receiving the name, the name is skipped if null.
+		 * @param gaps (Optional) The vector receiving the gaps, the gaps are skipped if null.
+		 * @return True if a valid header is read.
+		 */
+		bool read_header(std::istream &in, struct header &hdr, std::string *name = nullptr, std::vector<struct gap> *gaps = nullptr);
+
+		/**
+		 * @brief Returns the size of a section of `length` bytes including its padding.
+		 */
+		inline size_t section_size(size_t length) {
+			return length + (8 - length % 8) % 8;
+		};
+
+		/**
+		 * @brief Writes a section of `length` bytes followed by its padding.
+		 *
+		 * Used by other binary formats to lay out their columns like records.
+		 *
+		 * @param out The output stream.
+		 * @param data The bytes of the section.
+		 * @param length The number of bytes in the section.
+		 */
+		void write_section(std::ostream &out, const void *data, size_t length);
+
+		/**
+		 * @brief Reads a section of `count` values and skips its padding.
+		 *
+		 * @param in The input stream.
+		 * @param data The vector receiving the values.
+		 * @param count The number of values in the section.
+		 */
+		template <typename T>
+		void read_section(std::istream &in, std::vector<T> &data, size_t count) {
+			data.resize(count);
+			if (count > 0) {
+				in.read(reinterpret_cast<char *>(data.data()), count * sizeof(T));
+			}
+			in.ignore((8 - (count * sizeof(T)) % 8) % 8);
+		};
+
+		/**
+		 * @brief Memory-mapped read-only view of an .lcpt file.
+		 *
+		 * The records point into the mapping, which stays valid as long as the
+		 * view exists. Parsing stops at the first byte that does not start a
+		 * valid record, such as the completion marker written by lcptools.
+		 */
+		struct view {
+		  public:
+			std::vector<struct record> records;
+
+			/**
+			 * @brief Maps the file and indexes its records.
+			 *
+			 * @param filename The path of the .lcpt file.
+			 */
+			view(const std::string &filename);
+
+			~view();
+
+			view(const struct view &other) = delete;
+			struct view &operator=(const struct view &other) = delete;
+
+			/**
+			 * @brief Checks whether the file is mapped.
+			 *
+			 * @return True if the file could be opened and mapped.
+			 */
+			bool is_open() const;
+
+		  private:
+			const char *data;
+			size_t length;
+		};
+
+	}; // namespace lcpt
+
+}; // namespace lcp
+
+#endif
@@ -1,18 +1,48 @@
+#include "batch.h"
+#include "core_array.h"
+#include "gaps.h"
 #include "lps.h"
+#include "parallel.h"
+#include "shard.h"
+#include "stats.h"
+#include "writer.h"
 #include <ctype.h>
+#include <fcntl.h>
 #include <fstream>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 #define MAX_LINE_LENGTH 1024
 #define SEQUENCE_CAPACITY 250000000
+#define READ_BATCH_SIZE 100000
+#define FASTA_MEMORY_BUDGET 1000
+
+// how falcpt splits sequences at unknown bases
+enum gap_mode { GAPS_NONE, GAPS_N, GAPS_IUPAC };
 
 void print_usage(const char *lcptools) {
-	std::cout << "Usage: " << lcptools << " <command> <filename> <lcp-level> [sequence-size]" << std::endl;
+	std::cout << "Usage: " << lcptools << " falcpt <filename> <lcp-level> [sequence-size] [thread-number] [--memory <mb>] [--gaps | --gaps-iupac] [--dictionary] [--stats]" << std::endl;
+	std::cout << "       " << lcptools << " fqlcpt <filename> <lcp-level> [thread-number] [--stats]" << std::endl;
+	std::cout << "       " << lcptools << " merge <dictionary> <lcpt-file>..." << std::endl;
+	std::cout << "Options:" << std::endl;
+	std::cout << "  --memory Megabytes of sequence parsed at once by falcpt threads (default " << FASTA_MEMORY_BUDGET << ")." << std::endl;
+	std::cout << "  --gaps   Parse the sequence between runs of N independently and record the runs as gaps." << std::endl;
+	std::cout << "  --gaps-iupac" << std::endl;
+	std::cout << "           Same as --gaps, for runs of any character other than A, C, G and T." << std::endl;
+	std::cout << "  --dictionary" << std::endl;
+	std::cout << "           Label cores with the dictionary and write it to <filename>.lcpd for merge." << std::endl;
+	std::cout << "  --stats  Print per-level counters and timings to stderr." << std::endl;
 	std::cout << "Commands:" << std::endl;
-	std::cout << "  falcpt   Process the fasta file." << std::endl;
-	// std::cout << "  fqlcpt   Process the fasta file." << std::endl;
+	std::cout << "  falcpt   Process the fasta file, one named record per sequence." << std::endl;
+	std::cout << "  fqlcpt   Process the fastq file, one record per read." << std::endl;
+	std::cout << "  merge    Merge the dictionaries of lcpt files written with --dictionary into one, and" << std::endl;
+	std::cout << "           relabel the files in place. An existing merged dictionary is extended, and" << std::endl;
+	std::cout << "           files relabelled before are skipped." << std::endl;
 	std::cout << "File extensions:" << std::endl;
 	std::cout << "  .fasta, .fa, .fastq, .fq" << std::endl;
 };
@@ -47,13 +77,238 @@ bool isNumber(const char *str) {
 	return true;
 };
 
-void done(std::ofstream &out) {
+/**
+ * @brief Checks whether a file is a non-empty regular file, the only files that can be mapped.
+ *
+ * Checked before the file is opened, since other files such as pipes cannot be opened twice.
+ */
+bool mappable(const std::string &infilename) {
+	struct stat file_stat;
+	return stat(infilename.c_str(), &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size != 0;
+};
+
+void done(lcp::writer &buffered, std::ofstream &out) {
 	bool isDone = true;
-	out.write(reinterpret_cast<const char *>(&isDone), sizeof(isDone));
+	buffered.write(reinterpret_cast<const char *>(&isDone), sizeof(isDone));
+	buffered.finish();
 	out.close();
 };
 
-int process_fasta(const std::string &infilename, std::string &outfilename, const int lcp_level, const int sequence_size) {
+/**
+ * @brief A FASTA record to be parsed, either in place or from its own copy of the sequence.
+ */
+struct fasta_record {
+	std::string name;
+	std::string sequence;
+	const char *begin;
+	const char *end;
+};
+
+/**
+ * @brief The serialized cores of a record, and where the record ended in the input.
+ *
+ * With the dictionary, the cores are labelled with the IDs of `dictionary` until they are written.
+ */
+struct fasta_output {
+	std::string data;
+	const char *end;
+	lcp::shard dictionary;
+};
+
+typedef lcp::parallel::ordered<struct fasta_record, struct fasta_output> fasta_queue;
+
+/**
+ * @brief Returns the identifier of a header line, up to the first whitespace.
+ */
+std::string record_name(const char *line_begin, const char *line_end) {
+	const char *name_begin = line_begin + 1;
+	const char *name_end = name_begin;
+
+	while (name_end < line_end && !isspace(static_cast<unsigned char>(*name_end))) {
+		name_end++;
+	}
+
+	return std::string(name_begin, name_end);
+};
+
+struct fasta_output process_sequence(struct fasta_record &rec, const int lcp_level, const size_t thread_number, const size_t memory_budget, const enum gap_mode gaps, const bool use_map) {
+	const char *begin = rec.sequence.empty() ? rec.begin : rec.sequence.data();
+	const char *end = rec.sequence.empty() ? rec.end : rec.sequence.data() + rec.sequence.size();
+
+	struct fasta_output output;
+	output.end = rec.end;
+
+	// a record holding the budget share of several threads keeps as many records from running next to it,
+	// so it deepens with that many threads itself
+	size_t thread_budget = std::max(memory_budget / std::max(thread_number, static_cast<size_t>(1)), static_cast<size_t>(1));
+	size_t deepen_threads = std::max(std::min(thread_number, static_cast<size_t>(end - begin) / thread_budget), static_cast<size_t>(1));
+
+	// with the dictionary, every record is labelled in a context of its own, merged in record order once
+	// the record is written, so the IDs do not depend on which records are parsed concurrently
+	lcp::context &parent = lcp::context::current();
+	lcp::context local;
+
+	if (use_map) {
+		local.copy_encoding(parent);
+	}
+
+	lcp::context::scope bind(use_map ? local : parent);
+
+	if (gaps != GAPS_NONE) {
+		std::vector<lcp::gap> found;
+		lcp::find_gaps(begin, end, found, gaps == GAPS_IUPAC);
+
+		lcp::core_array cores(begin, end, found, use_map);
+		cores.deepen(lcp_level, use_map, deepen_threads);
+		cores.write(output.data, rec.name);
+	} else {
+		lcp::lps *str = new lcp::lps(begin, end, use_map);
+		str->deepen(lcp_level, use_map, deepen_threads);
+
+		str->write(output.data, rec.name);
+
+		delete str;
+	}
+
+	if (use_map) {
+		output.dictionary = lcp::shard(local);
+	}
+
+	return output;
+};
+
+/**
+ * @brief Writes the cores of a record, merging its dictionary into the current context first.
+ */
+void write_output(lcp::writer &buffered, struct fasta_output &output, const bool use_map) {
+	if (use_map) {
+		std::vector<ulabel> ids;
+		output.dictionary.merge(ids);
+		lcp::shard::relabel(output.data, ids);
+	}
+
+	// a record of a buffer or more is handed to the writer as it is, and the record holds its share of
+	// the budget until it reaches the file
+	bool large = WRITER_BUFFER_SIZE <= output.data.size();
+	buffered.write(std::move(output.data));
+
+	if (large) {
+		buffered.flush();
+	}
+};
+
+int process_fasta_mapped(const std::string &infilename, std::string &outfilename, const int lcp_level, const size_t thread_number, const size_t memory_budget, const enum gap_mode gaps, const bool use_map) {
+
+	int fd = open(infilename.c_str(), O_RDONLY);
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	// only non-empty regular files can be mapped, others are read as streams
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0) {
+		close(fd);
+		return -1;
+	}
+
+	size_t length = file_stat.st_size;
+
+	// private mapping so that newlines can be stripped in place without touching the file
+	char *data = static_cast<char *>(mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0));
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		return -1;
+	}
+
+	madvise(data, length, MADV_SEQUENTIAL);
+
+	std::ofstream outfile;
+	outfile.open(outfilename);
+
+	if (!outfile.is_open()) {
+		std::cout << "Error opening file" << std::endl;
+		munmap(data, length);
+		return 1;
+	}
+
+	// Initialize lcp encoding
+	lcp::encoding::init();
+
+	const size_t page_size = sysconf(_SC_PAGESIZE);
+	char *end = data + length;
+	char *read = data;
+	char *write = data;
+	char *sequence = data;
+	const char *released = data;
+	std::string name;
+
+	// records are written in input order by a background thread, pages of written records are given back
+	lcp::writer buffered(outfile);
+	fasta_queue records(
+		thread_number, memory_budget,
+		[lcp_level, thread_number, memory_budget, gaps, use_map](struct fasta_record &rec) { return process_sequence(rec, lcp_level, thread_number, memory_budget, gaps, use_map); },
+		[&](struct fasta_output &output) {
+			write_output(buffered, output, use_map);
+
+			const char *release_end = data + ((output.end - data) / page_size) * page_size;
+			if (released < release_end) {
+				madvise(const_cast<char *>(released), release_end - released, MADV_DONTNEED);
+				released = release_end;
+			}
+		});
+
+	while (read < end) {
+
+		char *line_end = static_cast<char *>(memchr(read, '\n', end - read));
+
+		if (line_end == nullptr) {
+			line_end = end;
+		}
+
+		if (*read != '>') {
+			// compact sequence line right after the previous one, dropping line breaks
+			size_t line_length = line_end - read;
+
+			if (0 < line_length && read[line_length - 1] == '\r') {
+				line_length--;
+			}
+
+			if (write != read) {
+				memmove(write, read, line_length);
+			}
+
+			write += line_length;
+			read = line_end < end ? line_end + 1 : end;
+			continue;
+		}
+
+		// queue previous chromosome before moving into new one, later records are compacted after it
+		if (sequence < write) {
+			records.push(fasta_record{name, std::string(), sequence, write}, write - sequence);
+		}
+
+		name = record_name(read, line_end);
+
+		read = line_end < end ? line_end + 1 : end;
+		sequence = write = read;
+	}
+
+	if (sequence < write) {
+		records.push(fasta_record{name, std::string(), sequence, write}, write - sequence);
+	}
+
+	records.finish();
+
+	done(buffered, outfile);
+
+	munmap(data, length);
+
+	return 0;
+};
+
+int process_fasta(const std::string &infilename, std::string &outfilename, const int lcp_level, const int sequence_size, const size_t thread_number, const size_t memory_budget, const enum gap_mode gaps, const bool use_map) {
 
 	std::fstream infile;
 	infile.open(infilename, std::ios::in);
@@ -66,12 +321,18 @@ int process_fasta(const std::string &infilename, std::string &outfilename, const
 		return 1;
 	}
 
-	std::string sequence, line;
+	std::string sequence, line, name;
 	sequence.reserve(sequence_size);
 
 	// Initialize lcp encoding
 	lcp::encoding::init();
 
+	lcp::writer buffered(outfile);
+	fasta_queue records(
+		thread_number, memory_budget,
+		[lcp_level, thread_number, memory_budget, gaps, use_map](struct fasta_record &rec) { return process_sequence(rec, lcp_level, thread_number, memory_budget, gaps, use_map); },
+		[&buffered, use_map](struct fasta_output &output) { write_output(buffered, output, use_map); });
+
 	while (getline(infile, line)) {
 
 		if (line[0] != '>') {
@@ -79,36 +340,282 @@ int process_fasta(const std::string &infilename, std::string &outfilename, const
 			continue;
 		}
 
-		// process previous chromosome before moving into new one
+		// queue a copy of previous chromosome before moving into new one, the buffer keeps its capacity
 		if (0 < sequence.size()) {
-			lcp::lps *str = new lcp::lps(sequence);
-			str->deepen(lcp_level);
-			str->write(outfile);
-
-			delete str;
-
+			records.push(fasta_record{name, sequence, nullptr, nullptr}, sequence.size());
 			sequence.clear();
 		}
+
+		name = record_name(line.data(), line.data() + line.size());
 	}
 
 	if (sequence.size() != 0) {
-		lcp::lps *str = new lcp::lps(sequence);
-		str->deepen(lcp_level);
-		str->write(outfile);
-
-		delete str;
+		records.push(fasta_record{name, sequence, nullptr, nullptr}, sequence.size());
 	}
 
-	done(outfile);
+	records.finish();
+
+	done(buffered, outfile);
 
 	infile.close();
-	outfile.close();
 
 	return 0;
 }
 
+/**
+ * @brief Finds the next line in [read, end), without its line break.
+ *
+ * @return The beginning of the line after it.
+ */
+const char *next_line(const char *read, const char *end, const char *&line_begin, const char *&line_end) {
+	const char *found = static_cast<const char *>(memchr(read, '\n', end - read));
+	const char *next = found == nullptr ? end : found + 1;
+
+	line_begin = read;
+	line_end = found == nullptr ? end : found;
+
+	if (line_begin < line_end && line_end[-1] == '\r') {
+		line_end--;
+	}
+
+	return next;
+};
+
+int process_fastq_mapped(const std::string &infilename, std::string &outfilename, const int lcp_level, const size_t thread_number) {
+
+	int fd = open(infilename.c_str(), O_RDONLY);
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0) {
+		close(fd);
+		return -1;
+	}
+
+	size_t length = file_stat.st_size;
+
+	// reads are parsed in place, the mapping is never written
+	const char *data = static_cast<const char *>(mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0));
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		return -1;
+	}
+
+	madvise(const_cast<char *>(data), length, MADV_SEQUENTIAL);
+
+	std::ofstream outfile;
+	outfile.open(outfilename, std::ios::binary);
+
+	if (!outfile.is_open()) {
+		std::cout << "Error opening file" << std::endl;
+		munmap(const_cast<char *>(data), length);
+		return 1;
+	}
+
+	// Initialize lcp encoding
+	lcp::encoding::init();
+
+	lcp::batch reads(lcp_level, thread_number);
+	lcp::writer buffered(outfile);
+
+	const char *end = data + length;
+	const char *read = data;
+	const char *line_begin, *line_end;
+
+	while (read < end) {
+
+		read = next_line(read, end, line_begin, line_end);
+
+		if (line_begin == line_end || *line_begin != '@') {
+			continue;
+		}
+
+		// sequence line, then skip separator and quality lines
+		read = next_line(read, end, line_begin, line_end);
+		reads.push(line_begin, line_end);
+
+		read = next_line(read, end, line_begin, line_end);
+		read = next_line(read, end, line_begin, line_end);
+
+		if (reads.size() == READ_BATCH_SIZE) {
+			reads.write(buffered);
+			reads.clear();
+		}
+	}
+
+	reads.write(buffered);
+
+	done(buffered, outfile);
+
+	munmap(const_cast<char *>(data), length);
+
+	return 0;
+};
+
+int process_fastq(const std::string &infilename, std::string &outfilename, const int lcp_level, const size_t thread_number) {
+
+	std::fstream infile;
+	infile.open(infilename, std::ios::in);
+
+	std::ofstream outfile;
+	outfile.open(outfilename, std::ios::binary);
+
+	if (!infile.is_open() || !outfile.is_open()) {
+		std::cout << "Error opening file" << std::endl;
+		return 1;
+	}
+
+	// Initialize lcp encoding
+	lcp::encoding::init();
+
+	lcp::batch reads(lcp_level, thread_number);
+	lcp::writer buffered(outfile);
+
+	// reads of a batch are kept back to back, they are pushed once the batch is complete
+	std::string sequences, line;
+	std::vector<size_t> offsets(1, 0);
+
+	while (getline(infile, line)) {
+
+		if (line.empty() || line[0] != '@') {
+			continue;
+		}
+
+		getline(infile, line);
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		sequences += line;
+		offsets.push_back(sequences.size());
+
+		getline(infile, line);
+		getline(infile, line);
+
+		if (offsets.size() > READ_BATCH_SIZE) {
+			for (size_t index = 0; index + 1 < offsets.size(); index++) {
+				reads.push(sequences.data() + offsets[index], sequences.data() + offsets[index + 1]);
+			}
+			reads.write(buffered);
+			reads.clear();
+			sequences.clear();
+			offsets.resize(1);
+		}
+	}
+
+	for (size_t index = 0; index + 1 < offsets.size(); index++) {
+		reads.push(sequences.data() + offsets[index], sequences.data() + offsets[index + 1]);
+	}
+	reads.write(buffered);
+
+	done(buffered, outfile);
+
+	infile.close();
+
+	return 0;
+};
+
+/**
+ * @brief Merges the dictionaries of lcpt files into one and relabels the files in place.
+ *
+ * The dictionary of `<name>.lcpt` is read from `<name>.lcpd`. If the merged dictionary exists,
+ * it is extended, so shards can be added later. The merged dictionary is written before any file
+ * is relabelled and records relabelled before are skipped, so a failed run can be repeated.
+ */
+int merge(const std::string &dictionary, const std::vector<std::string> &filenames) {
+
+	lcp::context global;
+	std::vector<std::vector<ulabel>> ids(filenames.size());
+
+	std::ifstream existing(dictionary, std::ios::binary);
+	if (existing.is_open()) {
+		lcp::shard merged;
+		std::vector<ulabel> merged_ids;
+		if (!merged.read(existing)) {
+			std::cerr << "Error: Invalid dictionary " << dictionary << std::endl;
+			return 1;
+		}
+		merged.merge(merged_ids, global);
+		existing.close();
+	}
+
+	for (size_t index = 0; index < filenames.size(); index++) {
+		const std::string &filename = filenames[index];
+		std::string name = filename.size() > 5 && filename.compare(filename.size() - 5, 5, ".lcpt") == 0 ? filename.substr(0, filename.size() - 5) : filename;
+		std::ifstream in(name + ".lcpd", std::ios::binary);
+		lcp::shard local;
+
+		if (!local.read(in)) {
+			std::cerr << "Error: Invalid or missing dictionary " << name << ".lcpd" << std::endl;
+			return 1;
+		}
+
+		local.merge(ids[index], global);
+	}
+
+	std::ofstream out(dictionary, std::ios::binary);
+	lcp::shard(global).write(out);
+	out.close();
+
+	if (!out) {
+		std::cerr << "Error: Cannot write " << dictionary << std::endl;
+		return 1;
+	}
+
+	std::cout << "Dictionary: " << dictionary << std::endl;
+
+	for (size_t index = 0; index < filenames.size(); index++) {
+		if (lcp::shard::remap(filenames[index], ids[index]) < 0) {
+			std::cerr << "Error: Cannot relabel " << filenames[index] << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+};
+
 int main(int argc, char *argv[]) {
 
+	// options may be given anywhere, the remaining arguments are positional
+	bool print_stats = false;
+	bool use_map = false;
+	enum gap_mode gaps = GAPS_NONE;
+	size_t memory_budget = FASTA_MEMORY_BUDGET;
+	std::vector<char *> args;
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--stats") == 0) {
+			print_stats = true;
+		} else if (strcmp(argv[i], "--gaps") == 0) {
+			gaps = GAPS_N;
+		} else if (strcmp(argv[i], "--gaps-iupac") == 0) {
+			gaps = GAPS_IUPAC;
+		} else if (strcmp(argv[i], "--dictionary") == 0) {
+			use_map = true;
+		} else if (strcmp(argv[i], "--memory") == 0) {
+			if (i + 1 == argc || !isNumber(argv[i + 1]) || atoi(argv[i + 1]) <= 0) {
+				std::cout << "Error: The memory argument must be a positive integer." << std::endl;
+				return 1;
+			}
+			memory_budget = atoi(argv[++i]);
+		} else {
+			args.push_back(argv[i]);
+		}
+	}
+
+	// argv stays null terminated like the one main received
+	argc = args.size();
+	args.push_back(nullptr);
+	argv = args.data();
+
+	if (argc >= 4 && std::string(argv[1]) == "merge") {
+		std::vector<std::string> filenames(argv + 3, argv + argc);
+		return merge(argv[2], filenames);
+	}
+
 	if (argc < 4) {
 		print_usage(argv[0]);
 		return 1;
@@ -117,7 +624,7 @@ int main(int argc, char *argv[]) {
 	std::string command = std::string(argv[1]);
 	std::string infilename = std::string(argv[2]);
 
-	if (command != "falcpt") {
+	if (command != "falcpt" && command != "fqlcpt") {
 		std::cout << "Error: Unsupported command " << command << std::endl;
 		print_usage(argv[0]);
 		return 1;
@@ -135,14 +642,30 @@ int main(int argc, char *argv[]) {
 
 	int lcp_level = atoi(argv[3]);
 	int sequence_size = SEQUENCE_CAPACITY;
+	int thread_number = LCP_THREAD_NUMBER;
 
-	if (argc == 5) {
+	if (argc >= 5) {
 
 		if (!isNumber(argv[4])) {
-			std::cout << "Error: The sequence size argument must be a positive integer." << std::endl;
+			std::cout << "Error: The " << (command == "falcpt" ? "sequence size" : "thread number") << " argument must be a positive integer." << std::endl;
+			return 1;
+		}
+
+		if (command == "falcpt") {
+			sequence_size = atoi(argv[4]);
+		} else {
+			thread_number = atoi(argv[4]);
+		}
+	}
+
+	if (argc >= 6 && command == "falcpt") {
+
+		if (!isNumber(argv[5])) {
+			std::cout << "Error: The thread number argument must be a positive integer." << std::endl;
 			return 1;
 		}
-		sequence_size = atoi(argv[4]);
+
+		thread_number = atoi(argv[5]);
 	}
 
 	// generate output infilename
@@ -150,8 +673,30 @@ int main(int argc, char *argv[]) {
 
 	std::cout << "Output: " << outfilename << std::endl;
 
-	process_fasta(infilename, outfilename, lcp_level, sequence_size);
-	// todo: fastq
+	if (print_stats) {
+		lcp::stats::enable();
+	}
+
+	// read files directly from the mapped pages, fall back to streams if they cannot be mapped
+	bool mapped = mappable(infilename);
+
+	if (command == "fqlcpt") {
+		if (!mapped || process_fastq_mapped(infilename, outfilename, lcp_level, thread_number) < 0) {
+			process_fastq(infilename, outfilename, lcp_level, thread_number);
+		}
+	} else if (!mapped || process_fasta_mapped(infilename, outfilename, lcp_level, thread_number, memory_budget * 1000000, gaps, use_map) < 0) {
+		process_fasta(infilename, outfilename, lcp_level, sequence_size, thread_number, memory_budget * 1000000, gaps, use_map);
+	}
+
+	if (use_map && command == "falcpt") {
+		std::ofstream dictionary(infilename + ".lcpd", std::ios::binary);
+		lcp::shard(lcp::context::global()).write(dictionary);
+		std::cout << "Dictionary: " << infilename << ".lcpd" << std::endl;
+	}
+
+	if (print_stats) {
+		lcp::stats::print(std::cerr);
+	}
 
 	return 0;
 };
\ No newline at end of file
@@ -1,125 +1,205 @@
 #include "lps.h"
-
-void reverse(std::string &str) {
-	size_t left = 0;
-	size_t right = str.size() - 1;
-
-	while (left < right) {
-		char temp = str[left];
-		str[left] = str[right];
-		str[right] = temp;
-
-		left++;
-		right--;
-	}
-};
+#include "shard.h"
 
 namespace lcp {
 
-	lps::lps(std::string &str, const int lcp_level, const size_t sequence_split_length, const size_t overlap_margin_length) {
+	/**
+	 * @brief Parses the window of a split, starting `margin` characters before the split, and
+	 * deepens it with positions relative to the beginning of the string.
+	 */
+	static void parse_window(const std::string &str, size_t split_begin, size_t split_length, size_t margin, int lcp_level, bool use_map, core_array &window) {
+		size_t begin = split_begin - std::min(split_begin, margin);
+		size_t end = std::min(split_begin + split_length, str.size());
 
-		this->level = 1;
-
-		// create initial cores based on first sequence split
-		this->cores = new std::vector<struct core>;
-		this->cores->reserve(sequence_split_length / CONSTANT_FACTOR);
+		window.parse(str.data() + begin, str.data() + end, use_map);
+		window.deepen(lcp_level, use_map);
 
-		std::string::iterator it = str.begin();
+		for (size_t index = 0; index < window.size(); index++) {
+			window.starts[index] += begin;
+			window.ends[index] += begin;
+		}
+	};
 
-		parse(it, std::min(it + sequence_split_length, str.end()), this->cores, 0, char_gt, char_lt, char_eq, char_index, char_size, char_rep, char_data, false);
+	/**
+	 * @brief Parses a window with the dictionary of a context of its own, and relabels its cores with
+	 * the IDs of the current context once the dictionary is merged into it.
+	 *
+	 * The window is labelled as if it were parsed in the current context right now, whatever the
+	 * other windows parsed concurrently.
+	 */
+	static void parse_window(const std::string &str, size_t split_begin, size_t split_length, size_t margin, int lcp_level, struct context &local, core_array &window) {
+		struct context &parent = context::current();
+
+		local.clear();
+		local.copy_encoding(parent);
+
+		context::scope bind(local);
+		parse_window(str, split_begin, split_length, margin, lcp_level, true, window);
+	};
 
-		this->deepen(lcp_level);
+	/**
+	 * @brief Merges the dictionary of a window parsed by `parse_window` into the current context.
+	 */
+	static void merge_window(struct context &local, core_array &window) {
+		std::vector<ulabel> ids;
+		shard(local).merge(ids);
+		local.clear();
 
-		// reserve the size based on the estimated core size for whole string
-		this->cores->reserve(this->cores->size() * (str.size() / sequence_split_length + 1));
+		for (std::vector<ulabel>::iterator it = window.labels.begin(); it != window.labels.end(); it++) {
+			*it = ids[*it];
+		}
+	};
 
-		// move to next split
-		it += sequence_split_length;
+	lps::lps(std::string &str, const int lcp_level, const size_t sequence_split_length, const size_t overlap_margin_length, const size_t thread_number, const bool use_map) {
 
-		while (it < str.end()) {
+		this->level = 1;
+		this->cores = nullptr;
+		this->label_flags = lcpt::labelling(1, use_map);
+
+		// every split except the first one starts overlap_margin_length characters earlier
+		size_t split_count = (str.size() + sequence_split_length - 1) / sequence_split_length;
+		std::vector<core_array> windows(split_count, core_array(true));
+		std::vector<size_t> margins(split_count, overlap_margin_length);
+
+		// with the dictionary, every split is labelled in a context of its own, merged in split order
+		// once all splits are parsed, so the IDs are the ones of parsing the splits one by one
+		std::vector<struct context> locals(use_map ? split_count : 0);
+
+		// parse and deepen splits independently, directly from the input string
+		parallel::run(split_count, thread_number, [&](size_t split_index) {
+			if (use_map) {
+				parse_window(str, split_index * sequence_split_length, sequence_split_length, margins[split_index], lcp_level, locals[split_index], windows[split_index]);
+			} else {
+				parse_window(str, split_index * sequence_split_length, sequence_split_length, margins[split_index], lcp_level, false, windows[split_index]);
+			}
+		});
 
-			std::string::iterator begin = it - overlap_margin_length;
-			std::string::iterator end = std::min(it + sequence_split_length, str.end());
-			std::string str(begin, end);
-			lcp::lps *temp = new lcp::lps(str);
-			temp->deepen(lcp_level);
+		for (size_t split_index = 0; use_map && split_index < split_count; split_index++) {
+			merge_window(locals[split_index], windows[split_index]);
+		}
 
-			// merge new processed segment with main cores
-			size_t max_overlap_size = 4;
-			size_t overlap_index = max_overlap_size;
-			size_t max_overlap_index = 50 < temp->cores->size() ? 50 : temp->cores->size();
-			bool found = false; // index for overlap
+		// join windows in order at the middle of their overlap, a window that does not agree with
+		// the previous cores there is parsed again with a doubled margin
+		core_array merged(true);
 
-			while (overlap_index <= max_overlap_index) {
+		for (size_t split_index = 0; split_index < split_count; split_index++) {
 
-				size_t match_count = 0;
-				std::vector<struct core>::iterator it1, it2;
+			size_t split_begin = split_index * sequence_split_length;
+			core_array &window = windows[split_index];
 
-				it1 = this->cores->end() - 1;
-				it2 = temp->cores->begin() + overlap_index - 1;
+			while (true) {
+				size_t begin = split_begin - std::min(split_begin, margins[split_index]);
 
-				while (match_count < max_overlap_size && *((it1 - match_count)) == *((it2 - match_count))) {
-					match_count++;
+				// a window from the beginning of the string replaces all previous cores
+				if (begin == 0) {
+					merged.swap(window);
+					break;
 				}
 
-				// found overlap with size overlap_size
-				if (match_count == max_overlap_size) {
-					found = true;
+				if (merged.stitch(window, begin + (split_begin - begin) / 2)) {
 					break;
 				}
 
-				// try larger overlap
-				overlap_index++;
-			}
+				margins[split_index] = std::max(2 * margins[split_index], static_cast<size_t>(1));
 
-			if (!found) {
-				overlap_index = 0;
+				if (use_map) {
+					parse_window(str, split_begin, sequence_split_length, margins[split_index], lcp_level, locals[split_index], window);
+					merge_window(locals[split_index], window);
+				} else {
+					parse_window(str, split_begin, sequence_split_length, margins[split_index], lcp_level, false, window);
+				}
 			}
 
-			// append new cores to the original core vector
-			this->cores->insert(this->cores->end(), temp->cores->begin() + overlap_index, temp->cores->end());
+			core_array().swap(window);
+		}
 
-			// remove non-overlapping cores so it wont be deleted
-			temp->cores->erase(temp->cores->begin() + overlap_index, temp->cores->end());
-			delete temp;
+		if (0 < split_count) {
+			this->level = merged.level;
+			this->label_flags = merged.label_flags;
+		}
 
-			// move next segment
-			it += sequence_split_length;
+		if (0 < merged.size()) {
+			this->cores = new std::vector<struct core>;
+			this->cores->reserve(merged.size());
+
+			for (size_t index = 0; index < merged.size(); index++) {
+				this->cores->push_back(merged.get(index));
+			}
 		}
 	};
 
 	lps::lps(std::string::iterator begin, std::string::iterator end) {
 
 		this->level = 1;
+		this->label_flags = lcpt::labelling(1, false);
 
 		this->cores = new std::vector<struct core>;
 		this->cores->reserve((end - begin) / CONSTANT_FACTOR);
 
-		parse(begin, end, this->cores, 0, char_gt, char_lt, char_eq, char_index, char_size, char_rep, char_data, false);
+		if (begin < end) {
+			stats::stage parsing(1, stats::PARSE_TIME);
+			parse_alphabet(&(*begin), &(*begin) + (end - begin), this->cores, false);
+		}
+
+		if (stats::enabled()) {
+			stats::count_bytes(this->level, this->memsize());
+		}
 	};
 
-	lps::lps(std::string &str, bool use_map, bool rev_comp) {
+	lps::lps(const char *begin, const char *end, bool use_map, bool rev_comp) {
 
 		this->level = 1;
+		this->label_flags = lcpt::labelling(1, use_map);
 
 		this->cores = new std::vector<struct core>;
-		this->cores->reserve(str.size() / CONSTANT_FACTOR);
+		this->cores->reserve((end - begin) / CONSTANT_FACTOR);
+
+		stats::stage parsing(1, stats::PARSE_TIME);
 
-		if (rev_comp) {
-			reverse(str);
-			parse(str.begin(), str.end(), this->cores, 0, char_rc_gt, char_rc_lt, char_rc_eq, char_index, char_size, char_rev_rep, char_data, use_map);
+		if (!rev_comp) {
+			parse_alphabet(begin, end, this->cores, use_map);
+		} else if (context::current().dna_alphabet) {
+			parse_chars(rc_iterator(end), rc_iterator(begin), this->cores, context::current().rc_alphabet, dna_rc_gt, dna_rc_lt, dna_rc_eq, rc_index, dna_rc_size, dna_rc_rep, dna_rc_data, use_map);
 		} else {
-			parse(str.begin(), str.end(), this->cores, 0, char_gt, char_lt, char_eq, char_index, char_size, char_rep, char_data, use_map);
+			parse_chars(rc_iterator(end), rc_iterator(begin), this->cores, context::current().rc_alphabet, rc_gt, rc_lt, rc_eq, rc_index, rc_size, rc_rep, rc_data, use_map);
+		}
+
+		if (stats::enabled()) {
+			stats::count_bytes(this->level, this->memsize());
 		}
 	};
 
+	lps::lps(std::string &str, bool use_map, bool rev_comp) : lps(str.data(), str.data() + str.size(), use_map, rev_comp) {};
+
 	lps::lps(std::ifstream &in) {
+
+		this->cores = nullptr;
+		this->label_flags = 0;
+
+		// versioned records are read column by column
+		core_array array;
+
+		if (array.read(in)) {
+			this->level = array.level;
+			this->label_flags = array.label_flags;
+
+			if (0 < array.size()) {
+				this->cores = new std::vector<struct core>;
+				this->cores->reserve(array.size());
+
+				for (size_t i = 0; i < array.size(); i++) {
+					this->cores->push_back(array.get(i));
+				}
+			}
+
+			return;
+		}
+
+		// legacy layout, written core by core
 		in.read(reinterpret_cast<char *>(&level), sizeof(level));
 		size_t size;
 		in.read(reinterpret_cast<char *>(&size), sizeof(size));
 
-		this->cores = nullptr;
-
 		// read each core object
 		if (0 < size) {
 			// resize the vector to the appropriate size
@@ -158,10 +238,82 @@ namespace lcp {
 		return true;
 	};
 
-	bool lps::deepen(bool use_map) {
+	/**
+	 * @brief Cores found in a range of positions of a level, with where the first of them starts
+	 * and the end of the last of them.
+	 */
+	struct range_cores {
+		std::vector<struct core> cores;
+		dct_array::iterator first;
+		dct_array::iterator last_end;
+
+		range_cores(dct_array::iterator end) : first(end), last_end(end) {};
+
+		template <typename... Args>
+		void emplace_back(dct_array::iterator begin, dct_array::iterator end, Args &&...args) {
+			if (this->cores.empty()) {
+				this->first = begin;
+			}
+			this->cores.emplace_back(begin, end, std::forward<Args>(args)...);
+		};
+	};
+
+	/**
+	 * @brief Parses the compressed level in ranges of positions concurrently and joins them in order.
+	 */
+	static void parse_ranges(dct_array &compressed, std::vector<struct core> *cores, int level, size_t thread_number) {
+
+		const dct_array::iterator begin = compressed.begin() + DCT_ITERATION_COUNT, end = compressed.end();
+
+		// positions processed by parse, see parse_range
+		const size_t first = DCT_ITERATION_COUNT, count = end - (begin + first);
+		const size_t range_count = std::min(thread_number, count / DEEPEN_RANGE_SIZE);
+		std::vector<struct range_cores> ranges(range_count, range_cores(end));
+
+		parallel::run(range_count, thread_number, [&](size_t range) {
+			dct_array::iterator it1 = begin + first + count * range / range_count;
+			dct_array::iterator stop = begin + first + count * (range + 1) / range_count;
+
+			// no core ends before the range, so the first core has no substring core in front of it
+			struct range_cores &result = ranges[range];
+			result.cores.reserve((stop - it1) / CONSTANT_FACTOR);
+
+			stats::stage parsing(level, stats::PARSE_TIME);
+			lps::parse_span(begin, it1, result.last_end, stop, end, true, &result, DCT_ITERATION_COUNT, dct_compare, dct_index, dct_size, dct_rep, dct_data, false);
+		});
+
+		stats::stage joining(level, stats::PARSE_TIME);
+
+		// end of the last core of the ranges joined so far
+		dct_array::iterator it2 = end;
+
+		for (std::vector<struct range_cores>::iterator range = ranges.begin(); range != ranges.end(); range++) {
+
+			if (range->cores.empty()) {
+				continue;
+			}
+
+			dct_array::iterator it1 = range->first + DCT_ITERATION_COUNT;
+
+			if (isSSEQ(it1, it2)) {
+				cores->emplace_back(it2 - 1 - DCT_ITERATION_COUNT, it1 + 1, dct_index(begin, it2 - 1 - DCT_ITERATION_COUNT, it1 + 1), dct_size, dct_rep, dct_data, false);
+
+				if (stats::enabled()) {
+					stats::count_rules(0, 0, 0, 1);
+				}
+			}
 
-		// Compress cores
-		if (!dct()) {
+			cores->insert(cores->end(), std::make_move_iterator(range->cores.begin()), std::make_move_iterator(range->cores.end()));
+			std::vector<struct core>().swap(range->cores);
+
+			it2 = range->last_end;
+		}
+	};
+
+	bool lps::deepen(bool use_map, size_t thread_number) {
+
+		// at least 2 cores are needed for compression
+		if (this->cores == nullptr || this->cores->size() < DCT_ITERATION_COUNT + 2) {
 			if (this->cores != nullptr)
 				delete this->cores;
 			this->cores = nullptr;
@@ -172,7 +324,27 @@ namespace lcp {
 		std::vector<struct core> *temp_cores = new std::vector<struct core>;
 		temp_cores->reserve(this->cores->size() / CONSTANT_FACTOR);
 
-		parse(this->cores->begin() + DCT_ITERATION_COUNT, this->cores->end(), temp_cores, DCT_ITERATION_COUNT, core_gt, core_lt, core_eq, core_index, core_size, core_rep, core_data, use_map);
+		if (DCT_ITERATION_COUNT == 1) {
+			// compressed cores are kept aside, the current level is left untouched
+			stats::stage compressing(this->level + 1, stats::DCT_TIME);
+			dct_array compressed(this->cores, thread_number);
+			compressing.stop();
+
+			// IDs of the dictionary are given in the order of the serial parse
+			if (1 < thread_number && !use_map && 2 * DEEPEN_RANGE_SIZE <= this->cores->size()) {
+				parse_ranges(compressed, temp_cores, this->level + 1, thread_number);
+			} else {
+				stats::stage parsing(this->level + 1, stats::PARSE_TIME);
+				parse(compressed.begin() + DCT_ITERATION_COUNT, compressed.end(), temp_cores, DCT_ITERATION_COUNT, dct_compare, dct_index, dct_size, dct_rep, dct_data, use_map);
+			}
+		} else {
+			stats::stage compressing(this->level + 1, stats::DCT_TIME);
+			this->dct();
+			compressing.stop();
+
+			stats::stage parsing(this->level + 1, stats::PARSE_TIME);
+			parse(this->cores->begin() + DCT_ITERATION_COUNT, this->cores->end(), temp_cores, DCT_ITERATION_COUNT, core_compare, core_index, core_size, core_rep, core_data, use_map);
+		}
 
 		// Remove old cores
 		delete this->cores;
@@ -181,32 +353,39 @@ namespace lcp {
 		temp_cores = nullptr;
 
 		this->level++;
+		this->label_flags = lcpt::labelling(this->level, use_map);
+
+		if (stats::enabled()) {
+			stats::count_bytes(this->level, this->memsize());
+		}
 
 		return true;
 	};
 
-	bool lps::deepen(int lcp_level, bool use_map) {
+	bool lps::deepen(int lcp_level, bool use_map, size_t thread_number) {
 
 		if (lcp_level <= this->level)
 			return false;
 
-		while (this->level < lcp_level && this->deepen(use_map))
+		while (this->level < lcp_level && this->deepen(use_map, thread_number))
 			;
 
 		return true;
 	};
 
-	void lps::write(std::ofstream &out) const {
-		out.write(reinterpret_cast<const char *>(&level), sizeof(level));
-		size_t size = this->cores == nullptr ? 0 : this->cores->size();
-		out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+	void lps::write(std::ofstream &out, const std::string &name) const {
+		static const std::vector<struct core> empty;
 
-		// write each core object
-		if (this->cores != nullptr) {
-			for (std::vector<struct core>::iterator it = this->cores->begin(); it != this->cores->end(); it++) {
-				(it)->write(out);
-			}
-		}
+		// write as columns, positions are included when STATS is defined
+		core_array array(this->cores != nullptr ? *this->cores : empty, this->level, this->label_flags);
+		array.write(out, name);
+	};
+
+	void lps::write(std::string &out, const std::string &name) const {
+		static const std::vector<struct core> empty;
+
+		core_array array(this->cores != nullptr ? *this->cores : empty, this->level, this->label_flags);
+		array.write(out, name);
 	};
 
 	double lps::memsize() const {
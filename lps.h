@@ -51,7 +51,11 @@
 #include "constant.h"
 #include "core.h"
 #include "encoding.h"
+#include "parallel.h"
 #include "rules.h"
+#include "simd.h"
+#include "stats.h"
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -63,20 +67,34 @@ namespace lcp {
 		int level;
 		std::vector<struct core> *cores;
 
+		// How the labels of the cores were computed, see `lcpt::labelling`
+		uint16_t label_flags;
+
 		/**
 		 * @brief Constructor for the lps struct that processes a string by splitting it into segments and merging cores.
 		 *
 		 * This constructor divides the input string into segments of a specified size (defaulting to 1,000,000)
 		 * and processes each segment individually. It also handles overlapping regions (defaulting to 10,000)
-		 * between segments to ensure continuity. The processed segments are merged by matching cores and
-		 * eliminating redundancy in the overlapping regions.
+		 * between segments to ensure continuity. Segments are parsed with the positions of their cores, and
+		 * consecutive segments are joined at the middle of their overlap, at the first run of
+		 * `UPDATE_ANCHOR_SIZE` cores found at the same positions in both (see `core_array::stitch`). If a
+		 * segment has no such run, the overlap is too short for the level, and the segment is parsed again
+		 * with a doubled margin. The cores are therefore the same as the ones of the whole string.
+		 *
+		 * Segments are parsed and deepened directly from the input string without being copied. When
+		 * `thread_number` is greater than 1, segments are processed concurrently, and the overlap merge
+		 * is performed in order once all segments are done. With the label dictionary, every segment
+		 * is labelled with a dictionary of its own, merged into the current context in segment order
+		 * (see shard.h), so the IDs are the ones of a serial parse whatever the number of threads.
 		 *
 		 * @param str Reference to the input string to be processed.
 		 * @param lcp_level The depth of processing for each core in the LCP structure.
 		 * @param sequence_split_length (Optional) Length of each segment to split the string. Defaults to 1,000,000.
-		 * @param overlap_margin_length (Optional) Length of the overlapping region between consecutive segments. Defaults to 10,000.
+		 * @param overlap_margin_length (Optional) Initial length of the overlapping region between consecutive segments. Defaults to 10,000.
+		 * @param thread_number (Optional) Number of threads used to process segments. Defaults to 1.
+		 * @param use_map (Optional) Whether to use the label dictionary.
 		 */
-		lps(std::string &str, const int lcp_level, const size_t sequence_split_length = MAX_STR_LENGTH, const size_t overlap_margin_length = OVERLAP_MARGIN);
+		lps(std::string &str, const int lcp_level, const size_t sequence_split_length = MAX_STR_LENGTH, const size_t overlap_margin_length = OVERLAP_MARGIN, const size_t thread_number = LCP_THREAD_NUMBER, const bool use_map = LCP_USE_MAP);
 
 		/**
 		 * @brief Constructor for the lps struct that processes a segment of a string.
@@ -89,10 +107,30 @@ namespace lcp {
 		 */
 		lps(std::string::iterator begin, std::string::iterator end);
 
+		/**
+		 * @brief Constructor for the lps struct that processes a raw character range.
+		 *
+		 * This constructor parses the characters in [begin, end) in place, so that sequences held
+		 * in external buffers (e.g. memory-mapped files) can be parsed without being copied into a
+		 * `std::string` first.
+		 *
+		 * If `rev_comp` is true, the reverse complement of the sequence is parsed by reading the
+		 * characters backwards, so both strands can be parsed from the same unmodified buffer.
+		 *
+		 * @param begin Pointer to the first character of the sequence.
+		 * @param end Pointer past the last character of the sequence.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param rev_comp Whether to apply reverse complement (default is false).
+		 */
+		lps(const char *begin, const char *end, bool use_map = LCP_USE_MAP, bool rev_comp = LCP_REV_COMP);
+
 		/**
 		 * @brief Constructs an lps object from a string, with an option to apply reverse complement
 		 * transformation.
 		 *
+		 * The string is not modified; positions of reverse complement cores are relative to the
+		 * last character of the string.
+		 *
 		 * @param str The input string to be parsed.
 		 * @param rev_comp Whether to apply reverse complement (default is false).
 		 */
@@ -101,6 +139,9 @@ namespace lcp {
 		/**
 		 * @brief Constructs an lps object by reading from a binary input file.
 		 *
+		 * Reads a versioned .lcpt record (see lcpt.h), or the legacy core by core layout
+		 * if the stream does not start with a record header.
+		 *
 		 * @param in Input stream from which the lps data is read.
 		 */
 		lps(std::ifstream &in);
@@ -114,24 +155,50 @@ namespace lcp {
 		 * @brief Deepens the compression level of the LCP structure. This method compresses the
 		 * existing cores and finds new cores.
 		 *
+		 * The compressed cores are written into a `dct_array` and the new cores are found from it,
+		 * so the existing cores are neither rewritten nor reallocated before they are released.
+		 *
+		 * When `thread_number` is greater than 1, the level is compressed and parsed by several
+		 * threads, each over a range of at least `DEEPEN_RANGE_SIZE` positions into its own vector
+		 * (see `parse_span`). The ranges are joined in order, and the substring core in front of
+		 * the first core of a range, the only one that depends on the cores before the range, is
+		 * decided while joining. The cores are the same as the ones of the serial parse. With the
+		 * label dictionary, IDs depend on the order cores are first seen, so the level is parsed
+		 * serially to keep them.
+		 *
+		 * @param use_map Whether to use the label dictionary.
+		 * @param thread_number (Optional) Number of threads used to parse the level. Defaults to 1.
 		 * @return True if successful in deepening the structure, false otherwise.
 		 */
-		bool deepen(bool use_map = LCP_USE_MAP);
+		bool deepen(bool use_map = LCP_USE_MAP, size_t thread_number = LCP_THREAD_NUMBER);
 
 		/**
 		 * @brief Deepens the compression level of the LCP structure to a specific level.
 		 *
 		 * @param lcp_level The target compression level to deepen to.
+		 * @param use_map Whether to use the label dictionary.
+		 * @param thread_number (Optional) Number of threads used to parse every level, see above.
 		 * @return True if deepening was successful, false otherwise.
 		 */
-		bool deepen(int lcp_level, bool use_map = LCP_USE_MAP);
+		bool deepen(int lcp_level, bool use_map = LCP_USE_MAP, size_t thread_number = LCP_THREAD_NUMBER);
 
 		/**
-		 * @brief Writes the current LCP structure to an existing output stream.
+		 * @brief Writes the current LCP structure to an existing output stream as a versioned
+		 * .lcpt record (see lcpt.h).
 		 *
 		 * @param out The output file stream to write to.
+		 * @param name (Optional) The name of the sequence, stored in the record if not empty.
+		 */
+		void write(std::ofstream &out, const std::string &name = std::string()) const;
+
+		/**
+		 * @brief Appends the current LCP structure to a byte buffer as an .lcpt record, in the
+		 * same layout as written to streams.
+		 *
+		 * @param out The buffer to append to.
+		 * @param name (Optional) The name of the sequence, stored in the record if not empty.
 		 */
-		void write(std::ofstream &out) const;
+		void write(std::string &out, const std::string &name = std::string()) const;
 
 		/**
 		 * @brief Calculates and returns the memory size used by the LCP structure.
@@ -162,22 +229,6 @@ namespace lcp {
 		 */
 		size_t size() const;
 
-	  private:
-		/**
-		 * @brief Performs Deterministic Coin Tossing (DCT) compression on binary sequences.
-		 *
-		 * This function is a central part of the LCP (Locally Consisted Parsing) algorithm. It identifies differences
-		 * between consecutive binary strings, compressing the information by focusing on the position and value of
-		 * the first divergent bit from the right-end of the strings. This difference is used to generate a compact
-		 * 'core' that encapsulates the unique elements of each sequence in a smaller binary form.
-		 *
-		 * This compression significantly reduces redundant information, making further analysis of the sequences
-		 * within the LCP framework more efficient and manageable.
-		 *
-		 * @return True if dct is performed, False if no enough cores are available for dct.
-		 */
-		bool dct();
-
 		/**
 		 * @brief Parses a sequence to extract Locally Consisted Parsing (LCP) cores and stores them in a vector.
 		 *
@@ -187,11 +238,12 @@ namespace lcp {
 		 * these cores for further processing in the LCP framework.
 		 *
 		 * @tparam Iterator Type of the sequence iterator, supporting random access.
+		 * @tparam Container Type of the output container, either a vector of cores or a `core_array`.
 		 * @tparam Compare Type of comparison function, used to evaluate relationships between elements.
 		 *
 		 * @param begin Iterator pointing to the beginning of the sequence to parse.
 		 * @param end Iterator pointing to the end of the sequence to parse.
-		 * @param cores Pointer to a vector where the identified LCP cores will be stored.
+		 * @param cores Pointer to a container where the identified LCP cores will be stored.
 		 * @param extension_size Size of the extension applied to core boundaries when calculating positions.
 		 * @param gt Comparator for greater-than relations between sequence elements.
 		 * @param lt Comparator for less-than relations between sequence elements.
@@ -207,43 +259,147 @@ namespace lcp {
 		 *   local minimum or maximum, signifying core boundaries.
 		 *
 		 * @note `use_map` influences how cores are constructed.
+		 * @note Any container providing `emplace_back` with the arguments of the templated `core`
+		 * constructor can be filled, which is how `core_array` is parsed into.
 		 *
 		 */
-		template <typename Iterator, typename Compare, typename Index, typename Size, typename Representation, typename Data>
-		inline void parse(Iterator begin, Iterator end, std::vector<struct core> *cores, const size_t extension_size, Compare gt, Compare lt, Compare eq, Index fn_index, Size fn_size, Representation fn_rep, Data fn_data, bool use_map) {
+		template <typename Iterator, typename Container, typename Compare, typename Index, typename Size, typename Representation, typename Data>
+		static inline void parse(Iterator begin, Iterator end, Container *cores, const size_t extension_size, Compare gt, Compare lt, Compare eq, Index fn_index, Size fn_size, Representation fn_rep, Data fn_data, bool use_map) {
+
+			(void)eq;
+
+			parse(begin, end, cores, extension_size, relation<Compare>(gt, lt), fn_index, fn_size, fn_rep, fn_data, use_map);
+		};
+
+		/**
+		 * @brief Form of `parse` that takes a three-way comparison instead of the `gt`, `lt` and `eq`
+		 * comparators, i.e. `core_compare`, `array_compare` or `dct_compare`.
+		 *
+		 * Every neighbouring pair is compared once, and the relation is reused by the equality, local
+		 * minimum and local maximum checks of the positions around it.
+		 *
+		 * @param order Three-way comparison returning a negative value, zero or a positive value
+		 * if the first element is smaller, equal or greater.
+		 *
+		 * The rest of the parameters are the same as in `parse`.
+		 */
+		template <typename Iterator, typename Container, typename Order, typename Index, typename Size, typename Representation, typename Data>
+		static inline void parse(Iterator begin, Iterator end, Container *cores, const size_t extension_size, Order order, Index fn_index, Size fn_size, Representation fn_rep, Data fn_data, bool use_map) {
 
-			Iterator it1 = begin + extension_size;
 			Iterator it2 = end;
 
+			parse_range(begin, begin + extension_size, it2, end, true, cores, extension_size, order, fn_index, fn_size, fn_rep, fn_data, use_map);
+		};
+
+		/**
+		 * @brief Resumable form of `parse` that processes positions starting from `it1`.
+		 *
+		 * The loop and the rules are the ones of `parse`; the state of the scan is the current position
+		 * `it1` and the end of the last found core `it2`, so the scan can be continued once more elements
+		 * are appended after `end`. When `final` is false, the scan stops at the first position whose
+		 * decision depends on elements beyond `end`, i.e. a local maximum check or a run reaching `end`.
+		 *
+		 * @param begin Iterator pointing to the beginning of the sequence to parse.
+		 * @param it1 Iterator pointing to the first position to be processed.
+		 * @param it2 End of the last found core, or `end` if no core is found yet. Updated as cores are found.
+		 * @param end Iterator pointing to the end of the available elements.
+		 * @param final Whether `end` is the end of the sequence.
+		 *
+		 * The rest of the parameters are the same as in `parse`.
+		 *
+		 * @return The first position that is not processed yet.
+		 */
+		template <typename Iterator, typename Container, typename Compare, typename Index, typename Size, typename Representation, typename Data>
+		static inline Iterator parse_range(Iterator begin, Iterator it1, Iterator &it2, Iterator end, bool final, Container *cores, const size_t extension_size, Compare gt, Compare lt, Compare eq, Index fn_index, Size fn_size, Representation fn_rep, Data fn_data, bool use_map) {
+
+			(void)eq;
+
+			return parse_range(begin, it1, it2, end, final, cores, extension_size, relation<Compare>(gt, lt), fn_index, fn_size, fn_rep, fn_data, use_map);
+		};
+
+		/**
+		 * @brief Resumable form of the three-way `parse`, with the same state and return value as `parse_range`.
+		 */
+		template <typename Iterator, typename Container, typename Order, typename Index, typename Size, typename Representation, typename Data>
+		static inline Iterator parse_range(Iterator begin, Iterator it1, Iterator &it2, Iterator end, bool final, Container *cores, const size_t extension_size, Order order, Index fn_index, Size fn_size, Representation fn_rep, Data fn_data, bool use_map) {
+
+			return parse_span(begin, it1, it2, end, end, final, cores, extension_size, order, fn_index, fn_size, fn_rep, fn_data, use_map);
+		};
+
+		/**
+		 * @brief Form of the three-way `parse_range` that processes the positions in [it1, stop) only.
+		 *
+		 * Elements up to `end` are still read to decide the positions before `stop`, so the cores are
+		 * the ones the whole scan finds at these positions. Whether a core starts at a position does
+		 * not depend on the positions before it, only the substring core emitted in front of the first
+		 * core depends on the end of the last core `it2`; this is how a level is parsed by several
+		 * threads in `lps::deepen`.
+		 *
+		 * @param stop Iterator pointing past the last position to be processed.
+		 *
+		 * The rest of the parameters and the return value are the same as in `parse_range`.
+		 */
+		template <typename Iterator, typename Container, typename Order, typename Index, typename Size, typename Representation, typename Data>
+		static inline Iterator parse_span(Iterator begin, Iterator it1, Iterator &it2, Iterator stop, Iterator end, bool final, Container *cores, const size_t extension_size, Order order, Index fn_index, Size fn_size, Representation fn_rep, Data fn_data, bool use_map) {
+
+			// rule hits, reported once per call if instrumentation is enabled
+			uint64_t run_hits = 0, lmin_hits = 0, lmax_hits = 0, sseq_hits = 0;
+
+			if (end <= it1 + 2 || stop <= it1) {
+				return it1;
+			}
+
+			// relations of the pairs starting at it1 - 1, it1, it1 + 1 and it1 + 2, shifted as it1 advances
+			int prev = begin < it1 ? order(it1 - 1, it1) : 0;
+			int curr = order(it1, it1 + 1);
+			int next = order(it1 + 1, it1 + 2);
+			int after = 0;
+
 			// find lcp cores
-			for (; it1 + 2 < end; it1++) {
+			for (; it1 < stop && it1 + 2 < end; it1++, prev = curr, curr = next, next = after) {
+
+				// local maximum check needs 3 elements ahead
+				if (!final && end <= it1 + 3) {
+					break;
+				}
+
+				after = it1 + 3 < end ? order(it1 + 2, it1 + 3) : 0;
 
 				// skip invalid character
-				if (eq(it1, it1 + 1)) {
+				if (curr == 0) {
 					continue;
 				}
 
-				size_t middleCount = countMiddle(it1, end, eq);
+				size_t middleCount = countMiddle(it1, end, next, order);
+
+				// run may continue after end
+				if (!final && middleCount == 0) {
+					break;
+				}
 
 				if (middleCount > 1) {
 
 					if (isSSEQ(it1, it2)) {
 						cores->emplace_back(it2 - 1 - extension_size, it1 + 1, fn_index(begin, it2 - 1 - extension_size, it1 + 1), fn_size, fn_rep, fn_data, use_map);
+						sseq_hits++;
 					}
 
 					it2 = it1 + 2 + middleCount;
 					cores->emplace_back(it1 - extension_size, it2, fn_index(begin, it1 - extension_size, it2), fn_size, fn_rep, fn_data, use_map);
+					run_hits++;
 
 					continue;
 				}
 
-				if (isLMIN(it1, gt, lt)) {
+				if (isLMIN(curr, next)) {
 
 					if (isSSEQ(it1, it2)) {
 						cores->emplace_back(it2 - 1 - extension_size, it1 + 1, fn_index(begin, it2 - 1 - extension_size, it1 + 1), fn_size, fn_rep, fn_data, use_map);
+						sseq_hits++;
 					}
 					it2 = it1 + 3;
 					cores->emplace_back(it1 - extension_size, it2, fn_index(begin, it1 - extension_size, it2), fn_size, fn_rep, fn_data, use_map);
+					lmin_hits++;
 
 					continue;
 				}
@@ -252,18 +408,224 @@ namespace lcp {
 					continue;
 				}
 
-				if (isLMAX(it1, end, gt, lt)) {
+				if (it1 + 3 < end && isLMAX(prev, curr, next, after)) {
 
 					if (isSSEQ(it1, it2)) {
 						cores->emplace_back(it2 - 1 - extension_size, it1 + 1, fn_index(begin, it2 - 1 - extension_size, it1 + 1), fn_size, fn_rep, fn_data, use_map);
+						sseq_hits++;
 					}
 					it2 = it1 + 3;
 					cores->emplace_back(it1 - extension_size, it2, fn_index(begin, it1 - extension_size, it2), fn_size, fn_rep, fn_data, use_map);
+					lmax_hits++;
 
 					continue;
 				}
 			}
+
+			if (stats::enabled()) {
+				stats::count_rules(run_hits, lmin_hits, lmax_hits, sseq_hits);
+			}
+
+			return it1;
 		};
+
+		/**
+		 * @brief Level 1 form of `parse` that finds cores of a character sequence from bitmasks.
+		 *
+		 * The sequence is processed in chunks of `SIMD_CHUNK_SIZE` characters. Each chunk is translated
+		 * into byte codes with `table`, and the equal, greater-than and less-than relations of all
+		 * neighbouring characters are computed as bitmasks by the kernels in simd.h. Runs, local minima
+		 * and local maxima are then found for 64 positions at once, and only the positions that
+		 * produce a core are visited. The cores are the same as the ones `parse` finds with the
+		 * comparators of `table`.
+		 *
+		 * The sequence is given either by `const char *` or by `rc_iterator`, the latter reading the
+		 * input backwards for reverse complement parsing.
+		 *
+		 * @param table The alphabet the comparators are based on, e.g. `alphabet` or `rc_alphabet`.
+		 *
+		 * The rest of the parameters are the same as in `parse`. The comparators are used to measure
+		 * runs, and to fall back to `parse` if the codes of `table` do not fit into a byte.
+		 */
+		template <typename Iterator, typename Container, typename Compare, typename Index, typename Size, typename Representation, typename Data>
+		static inline void parse_chars(Iterator begin, Iterator end, Container *cores, const int *table, Compare gt, Compare lt, Compare eq, Index fn_index, Size fn_size, Representation fn_rep, Data fn_data, bool use_map) {
+
+			Iterator it2 = end;
+
+			parse_chars_range(begin, begin, it2, end, true, cores, table, gt, lt, eq, fn_index, fn_size, fn_rep, fn_data, use_map);
+		};
+
+		/**
+		 * @brief Level 1 parse of a character sequence with the alphabet set by `encoding::init`.
+		 *
+		 * The default DNA alphabet is parsed with the compile-time `dna_*` rules, custom alphabets
+		 * with the `char_*` rules reading `alphabet`. Both produce the same cores. The alphabet is the
+		 * one of the current context.
+		 *
+		 * @param begin The beginning of the sequence.
+		 * @param end The end of the sequence.
+		 * @param cores The container receiving the cores.
+		 * @param use_map Whether to use the label dictionary.
+		 */
+		template <typename Container>
+		static inline void parse_alphabet(const char *begin, const char *end, Container *cores, bool use_map) {
+
+			const char *it2 = end;
+
+			parse_alphabet_range(begin, begin, it2, end, true, cores, char_index, use_map);
+		};
+
+		/**
+		 * @brief Resumable form of `parse_alphabet`, with the same state and return value as `parse_range`.
+		 */
+		template <typename Container, typename Index>
+		static inline const char *parse_alphabet_range(const char *begin, const char *it1, const char *&it2, const char *end, bool final, Container *cores, Index fn_index, bool use_map) {
+
+			const struct context &ctx = context::current();
+
+			if (ctx.dna_alphabet) {
+				return parse_chars_range(begin, it1, it2, end, final, cores, ctx.alphabet, dna_gt, dna_lt, dna_eq, fn_index, dna_size, dna_rep, dna_data, use_map);
+			}
+
+			return parse_chars_range(begin, it1, it2, end, final, cores, ctx.alphabet, char_gt, char_lt, char_eq, fn_index, char_size, char_rep, char_data, use_map);
+		};
+
+		/**
+		 * @brief Resumable form of `parse_chars`, with the same state and return value as `parse_range`.
+		 */
+		template <typename Iterator, typename Container, typename Compare, typename Index, typename Size, typename Representation, typename Data>
+		static inline Iterator parse_chars_range(Iterator begin, Iterator it1, Iterator &it2, Iterator end, bool final, Container *cores, const int *table, Compare gt, Compare lt, Compare eq, Index fn_index, Size fn_size, Representation fn_rep, Data fn_data, bool use_map) {
+
+			int8_t code_table[256];
+
+			if (!simd::build_table(table, code_table)) {
+				return parse_range(begin, it1, it2, end, final, cores, 0, gt, lt, eq, fn_index, fn_size, fn_rep, fn_data, use_map);
+			}
+
+			// positions in [first, last) are processed, the bounds of the loop in parse_range
+			const size_t length = end - begin;
+			const size_t reach = final ? 2 : 3;
+			const size_t first = it1 - begin;
+			const size_t last = reach < length ? length - reach : 0;
+
+			if (last <= first) {
+				return it1;
+			}
+
+			// codes[k] is the code of position chunk - 1 + k, so that the left neighbour of the
+			// first position and three characters after the last position are available
+			const size_t word_count = SIMD_CHUNK_SIZE / 64 + 2;
+			int8_t codes[64 * word_count + 64];
+			uint64_t eq_mask[word_count], gt_mask[word_count], lt_mask[word_count];
+
+			uint64_t run_hits = 0, lmin_hits = 0, lmax_hits = 0, sseq_hits = 0;
+
+			for (size_t chunk = first; chunk < last; chunk += SIMD_CHUNK_SIZE) {
+
+				const size_t chunk_size = last - chunk < SIMD_CHUNK_SIZE ? last - chunk : SIMD_CHUNK_SIZE;
+				const size_t code_begin = chunk == 0 ? 0 : chunk - 1;
+				const size_t code_end = chunk + chunk_size + 3 < length ? chunk + chunk_size + 3 : length;
+				const size_t offset = chunk == 0 ? 1 : 0;
+
+				// only the words reached by the positions of the chunk are computed, short sequences
+				// such as reads do not pay for a full chunk
+				const size_t chunk_words = (chunk_size + 3) / 64 + 2;
+
+				codes[0] = 0;
+				simd::translate(begin + code_begin, begin + code_end, code_table, codes + offset);
+				std::fill(codes + offset + (code_end - code_begin), codes + 64 * chunk_words + 1, 0);
+				simd::compare(codes, chunk_words, eq_mask, gt_mask, lt_mask);
+
+				for (size_t pos = 0; pos < chunk_size; pos += 64) {
+
+					// bit k of the masks below describes position chunk + pos + k
+					uint64_t curr_eq = simd::bits(eq_mask, pos + 1), next_eq = simd::bits(eq_mask, pos + 2);
+					uint64_t prev_gt = simd::bits(gt_mask, pos), curr_gt = simd::bits(gt_mask, pos + 1), next_gt = simd::bits(gt_mask, pos + 2);
+					uint64_t curr_lt = simd::bits(lt_mask, pos + 1), next_lt = simd::bits(lt_mask, pos + 2), after_lt = simd::bits(lt_mask, pos + 3);
+
+					uint64_t run = ~curr_eq & next_eq;
+					uint64_t lmin = curr_gt & next_lt;
+					uint64_t lmax = curr_lt & next_gt & ~prev_gt & ~after_lt;
+
+					// local maximum needs a left neighbour and 3 elements ahead
+					size_t lmax_count = length - 3 - (chunk + pos);
+					lmax &= lmax_count < 64 ? (1ULL << lmax_count) - 1 : ~0ULL;
+					if (chunk + pos == 0) {
+						lmax &= ~1ULL;
+					}
+
+					size_t count = chunk_size - pos;
+					uint64_t candidates = (run | lmin | lmax) & (count < 64 ? (1ULL << count) - 1 : ~0ULL);
+
+					while (candidates) {
+
+						int bit = __builtin_ctzll(candidates);
+						candidates &= candidates - 1;
+
+						Iterator it = begin + chunk + pos + bit;
+
+						if ((run >> bit) & 1) {
+
+							size_t middleCount = countMiddle(it, end, eq);
+
+							// run may continue after end
+							if (!final && middleCount == 0) {
+								if (stats::enabled()) {
+									stats::count_rules(run_hits, lmin_hits, lmax_hits, sseq_hits);
+								}
+								return it;
+							}
+
+							if (middleCount > 1) {
+
+								if (isSSEQ(it, it2)) {
+									cores->emplace_back(it2 - 1, it + 1, fn_index(begin, it2 - 1, it + 1), fn_size, fn_rep, fn_data, use_map);
+									sseq_hits++;
+								}
+
+								it2 = it + 2 + middleCount;
+								cores->emplace_back(it, it2, fn_index(begin, it, it2), fn_size, fn_rep, fn_data, use_map);
+								run_hits++;
+							}
+
+							continue;
+						}
+
+						if (isSSEQ(it, it2)) {
+							cores->emplace_back(it2 - 1, it + 1, fn_index(begin, it2 - 1, it + 1), fn_size, fn_rep, fn_data, use_map);
+							sseq_hits++;
+						}
+
+						it2 = it + 3;
+						cores->emplace_back(it, it2, fn_index(begin, it, it2), fn_size, fn_rep, fn_data, use_map);
+						lmin_hits += (lmin >> bit) & 1;
+						lmax_hits += (lmax >> bit) & 1;
+					}
+				}
+			}
+
+			if (stats::enabled()) {
+				stats::count_rules(run_hits, lmin_hits, lmax_hits, sseq_hits);
+			}
+
+			return begin + last;
+		};
+
+	  private:
+		/**
+		 * @brief Performs Deterministic Coin Tossing (DCT) compression on binary sequences.
+		 *
+		 * This function is a central part of the LCP (Locally Consisted Parsing) algorithm. It identifies differences
+		 * between consecutive binary strings, compressing the information by focusing on the position and value of
+		 * the first divergent bit from the right-end of the strings. This difference is used to generate a compact
+		 * 'core' that encapsulates the unique elements of each sequence in a smaller binary form.
+		 *
+		 * This compression significantly reduces redundant information, making further analysis of the sequences
+		 * within the LCP framework more efficient and manageable.
+		 *
+		 * @return True if dct is performed, False if no enough cores are available for dct.
+		 */
+		bool dct();
 	};
 
 	/**
@@ -0,0 +1,411 @@
+/**
+ * @file parallel.h
+ * @brief Minimal thread helpers shared by the parallel parsing modes.
+ *
+ * The helpers in this file distribute a fixed number of independent tasks
+ * over a fixed number of worker threads. Tasks are claimed through an atomic
+ * counter, so workers that finish early keep pulling work until all tasks are
+ * done. When a single thread is requested, tasks are executed in order on the
+ * calling thread without spawning any worker.
+ *
+ * Example usage:
+ * @code
+ *   std::vector<int> squares(100);
+ *   lcp::parallel::run(squares.size(), 8, [&](size_t index) {
+ *       squares[index] = index * index;
+ *   });
+ * @endcode
+ *
+ * When the same kind of work is repeated many times, e.g. for batches of short
+ * reads, `pool` keeps its worker threads alive between calls so that threads
+ * are not spawned for every batch.
+ *
+ * When tasks arrive one by one and their results must be consumed in the order
+ * the tasks arrived, e.g. records of a file that are written to another file,
+ * `ordered` processes them concurrently while bounding the work in flight.
+ *
+ * Workers parse in the context of the thread that handed them the tasks, see
+ * context.h.
+ *
+ * @namespace lcp::parallel
+ *
+ * @note Task functions must be safe to call concurrently for different indices.
+ *
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "context.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lcp {
+
+	namespace parallel {
+
+		/**
+		 * @brief Executes `fn(index)` for every index in [0, task_count) using up to
+		 * `thread_number` threads.
+		 *
+		 * @tparam Function Callable type accepting a `size_t` task index.
+		 * @param task_count The number of tasks to execute.
+		 * @param thread_number The maximum number of threads to use. Values of 0 or 1
+		 * execute every task serially on the calling thread.
+		 * @param fn The task function.
+		 */
+		template <typename Function>
+		void run(size_t task_count, size_t thread_number, Function fn) {
+
+			if (thread_number > task_count) {
+				thread_number = task_count;
+			}
+
+			if (thread_number <= 1) {
+				for (size_t index = 0; index < task_count; index++) {
+					fn(index);
+				}
+				return;
+			}
+
+			std::atomic<size_t> next_task(0);
+			std::vector<std::thread> threads;
+			threads.reserve(thread_number);
+			struct context &owner = context::current();
+
+			for (size_t thread_index = 0; thread_index < thread_number; thread_index++) {
+				threads.emplace_back([&]() {
+					context::scope bind(owner);
+					size_t index;
+					while ((index = next_task.fetch_add(1)) < task_count) {
+						fn(index);
+					}
+				});
+			}
+
+			for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); it++) {
+				it->join();
+			}
+		};
+
+		/**
+		 * @brief Fixed set of worker threads reused by consecutive `run` calls.
+		 *
+		 * The calling thread takes part in every `run`, so a pool of `thread_number`
+		 * threads spawns `thread_number - 1` workers.
+		 */
+		struct pool {
+		  public:
+			/**
+			 * @brief Starts the worker threads.
+			 *
+			 * @param thread_number The number of threads executing tasks, including the caller.
+			 */
+			pool(size_t thread_number) : owner(nullptr), task_count(0), next_task(0), active(0), generation(0), stop(false) {
+				for (size_t thread_index = 1; thread_index < thread_number; thread_index++) {
+					this->threads.emplace_back([this]() { this->work(); });
+				}
+			};
+
+			/**
+			 * @brief Stops and joins the worker threads.
+			 */
+			~pool() {
+				{
+					std::lock_guard<std::mutex> lock(this->mutex);
+					this->stop = true;
+				}
+				this->start.notify_all();
+
+				for (std::vector<std::thread>::iterator it = this->threads.begin(); it != this->threads.end(); it++) {
+					it->join();
+				}
+			};
+
+			pool(const struct pool &other) = delete;
+			struct pool &operator=(const struct pool &other) = delete;
+
+			/**
+			 * @brief Executes `fn(index)` for every index in [0, task_count) and waits for all of them.
+			 *
+			 * @param task_count The number of tasks to execute.
+			 * @param fn The task function.
+			 */
+			void run(size_t task_count, std::function<void(size_t)> fn) {
+
+				if (this->threads.empty() || task_count <= 1) {
+					for (size_t index = 0; index < task_count; index++) {
+						fn(index);
+					}
+					return;
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(this->mutex);
+					this->task = fn;
+					this->owner = &context::current();
+					this->task_count = task_count;
+					this->next_task = 0;
+					this->active = this->threads.size();
+					this->generation++;
+				}
+				this->start.notify_all();
+
+				this->claim();
+
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->done.wait(lock, [this]() { return this->active == 0; });
+				this->task = nullptr;
+			};
+
+			/**
+			 * @brief Returns the number of threads executing tasks, including the caller.
+			 */
+			size_t size() const {
+				return this->threads.size() + 1;
+			};
+
+		  private:
+			std::vector<std::thread> threads;
+			std::mutex mutex;
+			std::condition_variable start;
+			std::condition_variable done;
+			std::function<void(size_t)> task;
+			struct context *owner;
+			size_t task_count;
+			std::atomic<size_t> next_task;
+			size_t active;
+			size_t generation;
+			bool stop;
+
+			void claim() {
+				size_t index;
+				while ((index = this->next_task.fetch_add(1)) < this->task_count) {
+					this->task(index);
+				}
+			};
+
+			void work() {
+				size_t seen = 0;
+
+				while (true) {
+					{
+						std::unique_lock<std::mutex> lock(this->mutex);
+						this->start.wait(lock, [&]() { return this->stop || this->generation != seen; });
+
+						if (this->stop) {
+							return;
+						}
+						seen = this->generation;
+					}
+
+					{
+						context::scope bind(*this->owner);
+						this->claim();
+					}
+
+					std::lock_guard<std::mutex> lock(this->mutex);
+					if (--this->active == 0) {
+						this->done.notify_one();
+					}
+				}
+			};
+		};
+
+		/**
+		 * @brief Processes a stream of tasks concurrently and emits their results in the order
+		 * the tasks were pushed.
+		 *
+		 * The calling thread pushes tasks, worker threads turn them into results with `work`,
+		 * and a writer thread passes the results to `emit` in push order. Every task carries a
+		 * cost (e.g. its size in bytes) that is held until its result is emitted; `push` blocks
+		 * while the costs in flight would exceed the budget, so memory stays bounded no matter
+		 * how far the workers or the writer fall behind. A task is always accepted when nothing
+		 * is in flight, so a task costing more than the budget is processed alone.
+		 *
+		 * With a single thread, every task is processed and emitted by `push` on the calling
+		 * thread, without spawning any thread.
+		 *
+		 * @tparam Task The type of the tasks, moved into the workers.
+		 * @tparam Result The type of the results, moved to the writer.
+		 */
+		template <typename Task, typename Result>
+		struct ordered {
+		  public:
+			/**
+			 * @brief Starts the worker threads and the writer thread.
+			 *
+			 * @param thread_number The number of threads executing `work`.
+			 * @param budget The maximum sum of the costs of the tasks in flight.
+			 * @param work The task function, called from a worker thread.
+			 * @param emit The result function, called from the writer thread in push order.
+			 */
+			ordered(size_t thread_number, size_t budget, std::function<Result(Task &)> work, std::function<void(Result &)> emit)
+				: work(work), emit(emit), pushed(0), emitted(0), in_flight(0), budget(budget), closed(false) {
+
+				if (thread_number <= 1) {
+					return;
+				}
+
+				struct context &owner = context::current();
+
+				for (size_t thread_index = 0; thread_index < thread_number; thread_index++) {
+					this->workers.emplace_back([this, &owner]() {
+						context::scope bind(owner);
+						this->process();
+					});
+				}
+				this->writer = std::thread([this, &owner]() {
+					context::scope bind(owner);
+					this->write();
+				});
+			};
+
+			/**
+			 * @brief Waits for every pushed task to be emitted.
+			 */
+			~ordered() {
+				this->finish();
+			};
+
+			ordered(const struct ordered &other) = delete;
+			struct ordered &operator=(const struct ordered &other) = delete;
+
+			/**
+			 * @brief Queues a task, waiting until the budget allows it.
+			 *
+			 * @param task The task to be processed.
+			 * @param cost The share of the budget held by the task until its result is emitted.
+			 */
+			void push(Task task, size_t cost) {
+
+				if (this->workers.empty()) {
+					Result result = this->work(task);
+					this->emit(result);
+					return;
+				}
+
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->space.wait(lock, [&]() { return this->in_flight == 0 || this->in_flight + cost <= this->budget; });
+
+				this->in_flight += cost;
+				this->tasks.push_back(item{this->pushed++, std::move(task), cost});
+				lock.unlock();
+
+				this->task_ready.notify_one();
+			};
+
+			/**
+			 * @brief Emits the results of every pushed task and joins the threads.
+			 *
+			 * No task can be pushed afterwards.
+			 */
+			void finish() {
+
+				if (this->workers.empty()) {
+					return;
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(this->mutex);
+					this->closed = true;
+				}
+				this->task_ready.notify_all();
+				this->result_ready.notify_all();
+
+				for (typename std::vector<std::thread>::iterator it = this->workers.begin(); it != this->workers.end(); it++) {
+					it->join();
+				}
+				this->writer.join();
+
+				this->workers.clear();
+			};
+
+		  private:
+			struct item {
+				size_t index;
+				Task task;
+				size_t cost;
+			};
+
+			std::function<Result(Task &)> work;
+			std::function<void(Result &)> emit;
+			std::vector<std::thread> workers;
+			std::thread writer;
+			std::mutex mutex;
+			std::condition_variable task_ready;
+			std::condition_variable result_ready;
+			std::condition_variable space;
+			std::deque<struct item> tasks;
+			std::map<size_t, std::pair<Result, size_t>> results;
+			size_t pushed;
+			size_t emitted;
+			size_t in_flight;
+			size_t budget;
+			bool closed;
+
+			void process() {
+				while (true) {
+					std::unique_lock<std::mutex> lock(this->mutex);
+					this->task_ready.wait(lock, [this]() { return this->closed || !this->tasks.empty(); });
+
+					if (this->tasks.empty()) {
+						return;
+					}
+
+					struct item curr = std::move(this->tasks.front());
+					this->tasks.pop_front();
+					lock.unlock();
+
+					Result result = this->work(curr.task);
+
+					lock.lock();
+					this->results.emplace(curr.index, std::make_pair(std::move(result), curr.cost));
+					lock.unlock();
+
+					this->result_ready.notify_one();
+				}
+			};
+
+			void write() {
+				while (true) {
+					std::unique_lock<std::mutex> lock(this->mutex);
+					this->result_ready.wait(lock, [this]() {
+						return this->results.count(this->emitted) != 0 || (this->closed && this->emitted == this->pushed);
+					});
+
+					if (this->results.count(this->emitted) == 0) {
+						return;
+					}
+
+					// results are emitted outside of the lock, in push order
+					typename std::map<size_t, std::pair<Result, size_t>>::iterator it = this->results.find(this->emitted);
+					std::pair<Result, size_t> curr = std::move(it->second);
+					this->results.erase(it);
+					lock.unlock();
+
+					this->emit(curr.first);
+
+					lock.lock();
+					this->in_flight -= curr.second;
+					this->emitted++;
+					lock.unlock();
+
+					this->space.notify_one();
+				}
+			};
+		};
+
+	}; // namespace parallel
+
+}; // namespace lcp
+
+#endif
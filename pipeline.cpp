@@ -0,0 +1,195 @@
+#include "pipeline.h"
+#include <algorithm>
+
+namespace lcp {
+
+	pipeline::pipeline(int lcp_level, callback fn, bool use_map, size_t buffer_size) {
+		this->level = lcp_level;
+		this->fn = fn;
+		this->use_map = use_map;
+		// a parser needs enough elements to look ahead before it can decide anything
+		this->buffer_size = std::max(buffer_size, static_cast<size_t>(16));
+		this->emitted = 0;
+
+		this->reset();
+	};
+
+	void pipeline::reset() {
+		this->chars.clear();
+		this->offset = 0;
+		this->it1 = 0;
+		this->it2 = 0;
+		this->has_prev = false;
+
+		this->stages.clear();
+		this->stages.resize(this->level > 1 ? this->level - 1 : 0);
+
+		for (std::vector<struct stage>::iterator st = this->stages.begin(); st != this->stages.end(); st++) {
+			st->received = 0;
+			st->offset = 0;
+			// deepening parses from the DCT_ITERATION_COUNT-th core with the same extension
+			st->it1 = 2 * DCT_ITERATION_COUNT;
+			st->it2 = 0;
+			st->has_prev = false;
+		}
+	};
+
+	void pipeline::push(const char *begin, const char *end) {
+		this->chars.append(begin, end);
+
+		if (this->chars.size() + this->offset - this->it1 >= this->buffer_size) {
+			this->parse_chars(false);
+		}
+	};
+
+	void pipeline::push(const std::string &str) {
+		this->push(str.data(), str.data() + str.size());
+	};
+
+	void pipeline::finish() {
+		this->parse_chars(true);
+
+		for (size_t stage_index = 0; stage_index < this->stages.size(); stage_index++) {
+			this->parse_cores(stage_index, true);
+		}
+
+		this->reset();
+	};
+
+	size_t pipeline::size() const {
+		return this->emitted;
+	};
+
+	void pipeline::parse_chars(bool final) {
+
+		const char *data = this->chars.data();
+		const char *end = data + this->chars.size();
+		const char *it1 = data + (this->it1 - this->offset);
+		const char *it2 = this->has_prev ? data + (this->it2 - this->offset) : end;
+
+		size_t offset = this->offset;
+		std::vector<struct core> cores;
+
+		// positions are relative to the beginning of the sequence, not of the buffer
+		stats::stage parsing(1, stats::PARSE_TIME);
+		it1 = lps::parse_alphabet_range(data, it1, it2, end, final, &cores, [offset, data](const char *, const char *first, const char *last) { return std::make_pair(offset + (first - data), offset + (last - data)); }, this->use_map);
+		parsing.stop();
+
+		this->has_prev = this->has_prev || !cores.empty();
+		this->it1 = offset + (it1 - data);
+		this->it2 = offset + (it2 - data);
+
+		if (!final) {
+			// release characters no future core can reach
+			size_t keep = this->it1 > 0 ? this->it1 - 1 : 0;
+			if (this->has_prev) {
+				keep = std::min(keep, this->it2 - 1);
+			}
+
+			this->chars.erase(0, keep - this->offset);
+			this->offset = keep;
+		}
+
+		this->emit(0, cores);
+	};
+
+	void pipeline::parse_cores(size_t stage_index, bool final) {
+
+		struct stage &st = this->stages[stage_index];
+
+		// not enough cores for dct, the level ends here as in lps::deepen
+		if (st.received < DCT_ITERATION_COUNT + 2) {
+			return;
+		}
+
+		std::vector<struct core>::iterator begin = st.cores.begin();
+		std::vector<struct core>::iterator end = st.cores.end();
+		std::vector<struct core>::iterator it1 = begin + (st.it1 - st.offset);
+		std::vector<struct core>::iterator it2 = st.has_prev ? begin + (st.it2 - st.offset) : end;
+
+		size_t offset = st.offset;
+		std::vector<struct core> cores;
+
+		// positions are taken from the cores or relative to the DCT_ITERATION_COUNT-th core of the level
+		stats::stage parsing(stage_index + 2, stats::PARSE_TIME);
+		it1 = lps::parse_range(offset == 0 ? begin + DCT_ITERATION_COUNT : begin, it1, it2, end, final, &cores, DCT_ITERATION_COUNT, core_compare,
+							   [offset, begin](std::vector<struct core>::iterator, std::vector<struct core>::iterator first, std::vector<struct core>::iterator last) {
+#ifdef STATS
+								   (void)offset;
+								   (void)begin;
+								   return std::make_pair(first->start, (last - 1)->end);
+#else
+								   return std::make_pair(offset + (first - begin) - DCT_ITERATION_COUNT, offset + (last - begin) - DCT_ITERATION_COUNT);
+#endif
+							   },
+							   core_size, core_rep, core_data, this->use_map);
+		parsing.stop();
+
+		st.has_prev = st.has_prev || !cores.empty();
+		st.it1 = offset + (it1 - begin);
+		st.it2 = offset + (it2 - begin);
+
+		if (!final) {
+			// release cores no future core can reach
+			size_t keep = st.it1 - 1;
+			if (st.has_prev) {
+				keep = std::min(keep, st.it2 - 1);
+			}
+			keep = keep > DCT_ITERATION_COUNT ? keep - DCT_ITERATION_COUNT : 0;
+			keep = std::max(keep, st.offset);
+
+			st.cores.erase(st.cores.begin(), st.cores.begin() + (keep - st.offset));
+			st.offset = keep;
+		}
+
+		this->emit(stage_index + 1, cores);
+	};
+
+	void pipeline::feed(size_t stage_index, struct core &cr) {
+
+		struct stage &st = this->stages[stage_index];
+
+		// streaming dct, every core is compressed against its uncompressed left neighbour
+		for (size_t dct_index = 0; dct_index < DCT_ITERATION_COUNT; dct_index++) {
+			struct core uncompressed(cr);
+
+			if (dct_index < st.received) {
+				cr.compress(st.last[dct_index]);
+			}
+
+			if (st.last.size() <= dct_index) {
+				st.last.push_back(std::move(uncompressed));
+			} else {
+				st.last[dct_index] = std::move(uncompressed);
+			}
+		}
+
+		st.received++;
+		st.cores.push_back(std::move(cr));
+	};
+
+	void pipeline::emit(size_t stage_index, std::vector<struct core> &cores) {
+
+		// cores of the target level
+		if (this->stages.size() <= stage_index) {
+			for (std::vector<struct core>::iterator it = cores.begin(); it != cores.end(); it++) {
+				this->fn(*it);
+			}
+			this->emitted += cores.size();
+			return;
+		}
+
+		stats::stage compressing(stage_index + 2, stats::DCT_TIME);
+		for (std::vector<struct core>::iterator it = cores.begin(); it != cores.end(); it++) {
+			this->feed(stage_index, *it);
+		}
+		compressing.stop();
+
+		struct stage &st = this->stages[stage_index];
+
+		if (st.cores.size() + st.offset - st.it1 >= this->buffer_size) {
+			this->parse_cores(stage_index, false);
+		}
+	};
+
+}; // namespace lcp
@@ -0,0 +1,126 @@
+/**
+ * @file pipeline.h
+ * @brief Streaming LCP parser that emits the cores of a target level without
+ * keeping the lower levels in memory.
+ *
+ * The `pipeline` struct connects one parser per level. Characters pushed into
+ * the pipeline are parsed into level 1 cores, which are compressed and handed
+ * to the level 2 parser, and so on until the target level, whose cores are
+ * passed to a callback. Every parser only keeps a bounded buffer of its input:
+ * positions are parsed as soon as their decision no longer depends on unseen
+ * input, and the elements that no future core can reach are released. Peak
+ * memory is therefore proportional to the buffer size rather than to the
+ * length of the sequence.
+ *
+ * The emitted cores are identical to the ones obtained by constructing an
+ * `lps` object over the whole sequence and deepening it to the target level,
+ * including their positions when `STATS` is defined.
+ *
+ * Example usage:
+ * @code
+ *   size_t count = 0;
+ *   lcp::pipeline stream(4, [&](lcp::core &c) { count++; });
+ *   stream.push(chunk1);
+ *   stream.push(chunk2);
+ *   stream.finish();
+ * @endcode
+ *
+ * @see lps.h
+ *
+ * @namespace lcp
+ * @struct pipeline
+ *
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "constant.h"
+#include "core.h"
+#include "lps.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lcp {
+
+	struct pipeline {
+	  public:
+		typedef std::function<void(struct core &)> callback;
+
+		/**
+		 * @brief Constructs a pipeline emitting cores of the given level.
+		 *
+		 * @param lcp_level The level of the emitted cores.
+		 * @param fn The function called with every core of the target level, in order.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @param buffer_size (Optional) Number of unprocessed elements a parser collects before it
+		 * parses them. Defaults to PIPELINE_BUFFER_SIZE.
+		 */
+		pipeline(int lcp_level, callback fn, bool use_map = LCP_USE_MAP, size_t buffer_size = PIPELINE_BUFFER_SIZE);
+
+		/**
+		 * @brief Appends characters of the sequence.
+		 *
+		 * @param begin Pointer to the first character.
+		 * @param end Pointer past the last character.
+		 */
+		void push(const char *begin, const char *end);
+
+		/**
+		 * @brief Appends characters of the sequence.
+		 *
+		 * @param str The characters to append.
+		 */
+		void push(const std::string &str);
+
+		/**
+		 * @brief Marks the end of the sequence, emits the remaining cores and resets the
+		 * pipeline, so that it can be used for another sequence.
+		 */
+		void finish();
+
+		/**
+		 * @brief Returns the total number of cores emitted by the pipeline.
+		 *
+		 * @return size_t Number of emitted cores.
+		 */
+		size_t size() const;
+
+	  private:
+		// parser of a level above 1, fed with the cores of the level below
+		struct stage {
+			std::vector<struct core> cores;
+			std::vector<struct core> last;
+			size_t received;
+			size_t offset;
+			size_t it1;
+			size_t it2;
+			bool has_prev;
+		};
+
+		int level;
+		callback fn;
+		bool use_map;
+		size_t buffer_size;
+		size_t emitted;
+
+		// level 1 parser state
+		std::string chars;
+		size_t offset;
+		size_t it1;
+		size_t it2;
+		bool has_prev;
+
+		std::vector<struct stage> stages;
+
+		void reset();
+		void parse_chars(bool final);
+		void parse_cores(size_t stage_index, bool final);
+		void feed(size_t stage_index, struct core &cr);
+		void emit(size_t stage_index, std::vector<struct core> &cores);
+	};
+
+}; // namespace lcp
+
+#endif
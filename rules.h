@@ -1,12 +1,24 @@
 #ifndef RULES_H
 #define RULES_H
 
+#include "context.h"
 #include "core.h"
+#include "core_array.h"
+#include "dct_array.h"
+#include <iterator>
 #include <string>
 #include <vector>
 
 namespace lcp {
 
+	/**
+	 * @brief Iterator walking a character sequence from its last character to its first one.
+	 *
+	 * Reverse complement parsing reads the input through this iterator, so the input is
+	 * neither reversed in place nor copied.
+	 */
+	typedef std::reverse_iterator<const char *> rc_iterator;
+
 	// MARK: Properties
 
 	/**
@@ -20,7 +32,7 @@ namespace lcp {
 	 * @param it2 The second iterator whose index is to be computed.
 	 * @return A pair of indices representing the positions of `it1` and `it2` relative to `begin`.
 	 */
-	inline std::pair<size_t, size_t> char_index(std::string::iterator begin, std::string::iterator it1, std::string::iterator it2) {
+	inline std::pair<size_t, size_t> char_index(const char *begin, const char *it1, const char *it2) {
 		return std::make_pair(std::distance(begin, it1), std::distance(begin, it2));
 	};
 
@@ -51,9 +63,9 @@ namespace lcp {
 	 *          It will return alphabet_bit_size value.
 	 * @return A bit length of the encoding of the given character (i.e. alphabet_bit_size)
 	 */
-	inline uint64_t char_size(std::string::iterator it) {
+	inline uint64_t char_size(const char *it) {
 		(void)it;
-		return alphabet_bit_size;
+		return context::current().alphabet_bit_size;
 	};
 
 	/**
@@ -72,9 +84,9 @@ namespace lcp {
 	 * @param it An iterator pointing to the character.
 	 * @return An encoding of the character.
 	 */
-	inline ublock *char_rep(std::string::iterator it) {
+	inline ublock *char_rep(const char *it) {
 		thread_local static ublock temp;
-		temp = static_cast<ublock>(alphabet[static_cast<unsigned char>(*it)]);
+		temp = static_cast<ublock>(context::current().alphabet[static_cast<unsigned char>(*it)]);
 		return &temp;
 	};
 
@@ -84,9 +96,9 @@ namespace lcp {
 	 * @param it An iterator pointing to the character.
 	 * @return An encoding of the character.
 	 */
-	inline ublock *char_rev_rep(std::string::iterator it) {
+	inline ublock *char_rev_rep(const char *it) {
 		thread_local static ublock temp;
-		temp = static_cast<ublock>(rc_alphabet[static_cast<unsigned char>(*it)]);
+		temp = static_cast<ublock>(context::current().rc_alphabet[static_cast<unsigned char>(*it)]);
 		return &temp;
 	};
 
@@ -101,24 +113,23 @@ namespace lcp {
 	};
 
 	/**
-	 * @brief Extracts character data from a range of string iterators and returns it as a dynamically allocated array.
+	 * @brief Extracts character data from a range of characters to be labeled.
 	 *
-	 * Copies characters from the range specified by the `begin` and `end` iterators into a newly allocated `char` array.
-	 * The caller is responsible for deleting the returned array.
+	 * Packs the length of the range minus two, and the codes of the first, second-to-last and last
+	 * characters. Characters are encoded with the same lookup as the comparison rules, so the core
+	 * and its label agree on every character, including the ones the alphabet does not encode.
 	 *
 	 * @param begin An iterator pointing to the start of the string range.
 	 * @param end An iterator pointing to the end of the string range.
-	 * @return A pointer to a dynamically allocated array containing the characters in the specified range.
-	 */
-	inline ulabel char_data(const std::string::iterator begin, const std::string::iterator end) {
-		thread_local static int double_shift = 2 * alphabet_bit_size;
-		thread_local static int triple_shift = 3 * alphabet_bit_size;
-		thread_local static ulabel data;
-		data = 0;
-		data |= ((std::distance(begin,end)-2) << triple_shift);
-		data |= (alphabet[(*(begin)) & 0xDF] << double_shift);
-		data |= (alphabet[(*(end-2)) & 0xDF] << alphabet_bit_size);
-		data |= (alphabet[(*(end-1)) & 0xDF]);
+	 * @return The data to be labeled.
+	 */
+	inline ulabel char_data(const char *begin, const char *end) {
+		const struct context &ctx = context::current();
+		ulabel data = 0;
+		data |= (static_cast<ulabel>(std::distance(begin,end)-2) << (3 * ctx.alphabet_bit_size));
+		data |= (static_cast<ulabel>(ctx.alphabet[static_cast<unsigned char>(*(begin))]) << (2 * ctx.alphabet_bit_size));
+		data |= (static_cast<ulabel>(ctx.alphabet[static_cast<unsigned char>(*(end-2))]) << ctx.alphabet_bit_size);
+		data |= (static_cast<ulabel>(ctx.alphabet[static_cast<unsigned char>(*(end-1))]));
 		return data;
 	};
 
@@ -142,6 +153,173 @@ namespace lcp {
 		return data;
 	};
 
+	/**
+	 * @brief Computes the positions of a range of cores stored in a `core_array`.
+	 *
+	 * If the array tracks positions, the start of the core at `it1` and the end of the core
+	 * preceding `it2` are returned. Otherwise, the distances of the iterators from `begin` are returned.
+	 *
+	 * @param begin The iterator pointing to the first core of the array.
+	 * @param it1 The first iterator whose index is to be computed.
+	 * @param it2 The second iterator whose index is to be computed.
+	 * @return A pair of indices representing the positions of `it1` and `it2`.
+	 */
+	inline std::pair<size_t, size_t> array_index(core_array::iterator begin, core_array::iterator it1, core_array::iterator it2) {
+		if (it1.array->positions) {
+			return std::make_pair(it1.array->starts[it1.index], it1.array->ends[it2.index - 1]);
+		}
+		return std::make_pair(std::distance(begin, it1), std::distance(begin, it2));
+	};
+
+	/**
+	 * Gets the bit length of the core that is given in `core_array` iterator.
+	 *
+	 * @param it An iterator pointing to the core.
+	 * @return A bit length of the core.
+	 */
+	inline uint64_t array_size(core_array::iterator it) {
+		return it.array->bit_sizes[it.index];
+	};
+
+	/**
+	 * Gets the representation of the core that is given in `core_array` iterator.
+	 *
+	 * @param it An iterator pointing to the core.
+	 * @return A pointer to the first block of the core.
+	 */
+	inline ublock *array_rep(core_array::iterator it) {
+		return &it.array->blocks[it.array->block_offset(it.index)];
+	};
+
+	/**
+	 * @brief Extracts core data from a range of `core_array` iterators.
+	 *
+	 * Same layout as `core_data`: the label of the first core after the DCT extension, the labels
+	 * of the last two cores in the range and the length of the range minus `DCT_ITERATION_COUNT` and two.
+	 *
+	 * @param begin An iterator pointing to the start of the core range.
+	 * @param end An iterator pointing to the end of the core range.
+	 * @return A pointer to a thread local array containing the core data.
+	 */
+	inline ulabel *array_data(const core_array::iterator begin, const core_array::iterator end) {
+		thread_local static ulabel data[4];
+		const std::vector<ulabel> &labels = begin.array->labels;
+		data[0] = labels[begin.index + DCT_ITERATION_COUNT];
+		data[1] = labels[end.index - 2];
+		data[2] = labels[end.index - 1];
+		data[3] = std::distance(begin, end) - DCT_ITERATION_COUNT - 2;
+		return data;
+	};
+
+	/**
+	 * @brief Computes the positions of a range of cores of a `dct_array`.
+	 *
+	 * Same as `core_index`, read from the cores the array was compressed from.
+	 *
+	 * @param begin The iterator pointing to the first core of the array.
+	 * @param it1 The first iterator whose index is to be computed.
+	 * @param it2 The second iterator whose index is to be computed.
+	 * @return A pair of indices representing the positions of `it1` and `it2`.
+	 */
+	inline std::pair<size_t, size_t> dct_index(dct_array::iterator begin, dct_array::iterator it1, dct_array::iterator it2) {
+		(void)begin;
+#ifdef STATS
+		return std::make_pair((*it1.array->cores)[it1.index].start, (*it2.array->cores)[it2.index - 1].end);
+#endif
+		return std::make_pair(std::distance(begin, it1), std::distance(begin, it2));
+	};
+
+	/**
+	 * Gets the bit length of the compressed core that is given in `dct_array` iterator.
+	 *
+	 * @param it An iterator pointing to the core.
+	 * @return A bit length of the compressed core.
+	 */
+	inline uint64_t dct_size(dct_array::iterator it) {
+		return it.array->size(it.index);
+	};
+
+	/**
+	 * Gets the compressed representation of the core that is given in `dct_array` iterator.
+	 *
+	 * @param it An iterator pointing to the core.
+	 * @return A pointer to the compressed representation.
+	 */
+	inline ublock *dct_rep(dct_array::iterator it) {
+		return it.array->rep(it.index);
+	};
+
+	/**
+	 * @brief Extracts core data from a range of `dct_array` iterators.
+	 *
+	 * Same layout as `core_data`, labels are not changed by compression.
+	 *
+	 * @param begin An iterator pointing to the start of the core range.
+	 * @param end An iterator pointing to the end of the core range.
+	 * @return A pointer to a thread local array containing the core data.
+	 */
+	inline ulabel *dct_data(const dct_array::iterator begin, const dct_array::iterator end) {
+		thread_local static ulabel data[4];
+		const std::vector<struct core> &cores = *begin.array->cores;
+		data[0] = cores[begin.index + DCT_ITERATION_COUNT].label;
+		data[1] = cores[end.index - 2].label;
+		data[2] = cores[end.index - 1].label;
+		data[3] = std::distance(begin, end) - DCT_ITERATION_COUNT - 2;
+		return data;
+	};
+
+	/**
+	 * @brief Computes the indices of two reverse iterators relative to the end of the string.
+	 *
+	 * @param begin The iterator pointing to the last character of the string.
+	 * @param it1 The first iterator whose index is to be computed.
+	 * @param it2 The second iterator whose index is to be computed.
+	 * @return A pair of indices in the reversed string.
+	 */
+	inline std::pair<size_t, size_t> rc_index(rc_iterator begin, rc_iterator it1, rc_iterator it2) {
+		return std::make_pair(std::distance(begin, it1), std::distance(begin, it2));
+	};
+
+	/**
+	 * Gets the bit length of the character encoding that is given in reverse iterator.
+	 *
+	 * @param it An iterator pointing to the character.
+	 * @return A bit length of the encoding of the given character (i.e. alphabet_bit_size)
+	 */
+	inline uint64_t rc_size(rc_iterator it) {
+		(void)it;
+		return context::current().alphabet_bit_size;
+	};
+
+	/**
+	 * Gets the character encoding from the reverse complement alphabet.
+	 *
+	 * @param it A reverse iterator pointing to the character.
+	 * @return An encoding of the character.
+	 */
+	inline ublock *rc_rep(rc_iterator it) {
+		thread_local static ublock temp;
+		temp = static_cast<ublock>(context::current().rc_alphabet[static_cast<unsigned char>(*it)]);
+		return &temp;
+	};
+
+	/**
+	 * @brief Extracts character data from a range of reverse iterators, same layout as `char_data`.
+	 *
+	 * @param begin An iterator pointing to the start of the reversed range.
+	 * @param end An iterator pointing to the end of the reversed range.
+	 * @return The data to be labeled.
+	 */
+	inline ulabel rc_data(rc_iterator begin, rc_iterator end) {
+		const struct context &ctx = context::current();
+		ulabel data = 0;
+		data |= (static_cast<ulabel>(std::distance(begin,end)-2) << (3 * ctx.alphabet_bit_size));
+		data |= (static_cast<ulabel>(ctx.alphabet[static_cast<unsigned char>(*(begin))]) << (2 * ctx.alphabet_bit_size));
+		data |= (static_cast<ulabel>(ctx.alphabet[static_cast<unsigned char>(*(end-2))]) << ctx.alphabet_bit_size);
+		data |= (static_cast<ulabel>(ctx.alphabet[static_cast<unsigned char>(*(end-1))]));
+		return data;
+	};
+
 	// MARK: Operators
 
 	/**
@@ -153,8 +331,9 @@ namespace lcp {
 	 *         pointed to by it2 based on the modularity of the alphabet mapping;
 	 *         false otherwise.
 	 */
-	inline bool char_gt(const std::string::iterator it1, const std::string::iterator it2) {
-		return (alphabet[static_cast<unsigned char>(*it1)]) > (alphabet[static_cast<unsigned char>(*it2)]);
+	inline bool char_gt(const char *it1, const char *it2) {
+		const int *codes = context::current().alphabet;
+		return codes[static_cast<unsigned char>(*it1)] > codes[static_cast<unsigned char>(*it2)];
 	};
 
 	/**
@@ -166,8 +345,9 @@ namespace lcp {
 	 *         pointed to by it2 based on the modularity of the alphabet mapping;
 	 *         false otherwise.
 	 */
-	inline bool char_lt(const std::string::iterator it1, const std::string::iterator it2) {
-		return (alphabet[static_cast<unsigned char>(*it1)]) < (alphabet[static_cast<unsigned char>(*it2)]);
+	inline bool char_lt(const char *it1, const char *it2) {
+		const int *codes = context::current().alphabet;
+		return codes[static_cast<unsigned char>(*it1)] < codes[static_cast<unsigned char>(*it2)];
 	};
 
 	/**
@@ -179,8 +359,9 @@ namespace lcp {
 	 *         pointed to by it2 based on the modularity of the alphabet mapping;
 	 *         false otherwise.
 	 */
-	inline bool char_eq(const std::string::iterator it1, const std::string::iterator it2) {
-		return (alphabet[static_cast<unsigned char>(*it1)]) == (alphabet[static_cast<unsigned char>(*it2)]);
+	inline bool char_eq(const char *it1, const char *it2) {
+		const int *codes = context::current().alphabet;
+		return codes[static_cast<unsigned char>(*it1)] == codes[static_cast<unsigned char>(*it2)];
 	};
 
 	/**
@@ -192,7 +373,7 @@ namespace lcp {
 	 *         object pointed to by it2; false otherwise.
 	 */
 	inline bool core_gt(const std::vector<struct core>::iterator it1, const std::vector<struct core>::iterator it2) {
-		return (*it1) > (*it2);
+		return compare(*it1, *it2) > 0;
 	};
 
 	/**
@@ -204,22 +385,143 @@ namespace lcp {
 	 *         object pointed to by it2; false otherwise.
 	 */
 	inline bool core_lt(const std::vector<struct core>::iterator it1, const std::vector<struct core>::iterator it2) {
-		return (*it1) < (*it2);
+		return compare(*it1, *it2) < 0;
 	};
 
 	/**
-	 * Compares two characters from a string using a custom alphabet mapping.
+	 * Compares two core objects pointed to by iterators for equality.
 	 *
-	 * @param it1 An iterator pointing to the first character.
-	 * @param it2 An iterator pointing to the second character.
-	 * @return true if the character pointed to by it1 is equal to the character
-	 *         pointed to by it2 based on the modularity of the alphabet mapping;
-	 *         false otherwise.
+	 * @param it1 An iterator pointing to the first core object.
+	 * @param it2 An iterator pointing to the second core object.
+	 * @return true if both core objects have the same representation; false otherwise.
 	 */
 	inline bool core_eq(const std::vector<struct core>::iterator it1, const std::vector<struct core>::iterator it2) {
 		return (*it1) == (*it2);
 	};
 
+	/**
+	 * Compares two core objects pointed to by iterators, in the order of the `core` comparison operators.
+	 *
+	 * @param it1 An iterator pointing to the first core object.
+	 * @param it2 An iterator pointing to the second core object.
+	 * @return A negative value if the first core is smaller, zero if both are equal, and a
+	 *         positive value if the first core is greater.
+	 */
+	inline int core_compare(const std::vector<struct core>::iterator it1, const std::vector<struct core>::iterator it2) {
+		return compare(*it1, *it2);
+	};
+
+	/**
+	 * Compares two cores stored in a `core_array`, in the same order as the `core` comparison operators.
+	 *
+	 * @param it1 An iterator pointing to the first core.
+	 * @param it2 An iterator pointing to the second core.
+	 * @return A negative value if the first core is smaller, zero if both are equal, and a
+	 *         positive value if the first core is greater.
+	 */
+	inline int array_compare(const core_array::iterator it1, const core_array::iterator it2) {
+		const core_array *array = it1.array;
+		ubit_size size1 = array->bit_sizes[it1.index], size2 = array->bit_sizes[it2.index];
+
+		if (size1 != size2) {
+			return size1 < size2 ? -1 : 1;
+		}
+
+		return compare_blocks(&array->blocks[array->block_offset(it1.index)], &array->blocks[array->block_offset(it2.index)], size1);
+	};
+
+	/**
+	 * Compares two cores stored in a `core_array` to determine their order.
+	 *
+	 * @param it1 An iterator pointing to the first core.
+	 * @param it2 An iterator pointing to the second core.
+	 * @return true if the first core is greater than the second core; false otherwise.
+	 */
+	inline bool array_gt(const core_array::iterator it1, const core_array::iterator it2) {
+		return array_compare(it1, it2) > 0;
+	};
+
+	/**
+	 * Compares two cores stored in a `core_array` to determine their order.
+	 *
+	 * @param it1 An iterator pointing to the first core.
+	 * @param it2 An iterator pointing to the second core.
+	 * @return true if the first core is less than the second core; false otherwise.
+	 */
+	inline bool array_lt(const core_array::iterator it1, const core_array::iterator it2) {
+		return array_compare(it1, it2) < 0;
+	};
+
+	/**
+	 * Compares two cores stored in a `core_array` for equality.
+	 *
+	 * @param it1 An iterator pointing to the first core.
+	 * @param it2 An iterator pointing to the second core.
+	 * @return true if both cores have the same representation; false otherwise.
+	 */
+	inline bool array_eq(const core_array::iterator it1, const core_array::iterator it2) {
+		return array_compare(it1, it2) == 0;
+	};
+
+	/**
+	 * Compares two compressed cores of a `dct_array`, in the same order as the `core` comparison operators.
+	 *
+	 * @param it1 An iterator pointing to the first core.
+	 * @param it2 An iterator pointing to the second core.
+	 * @return A negative value if the first core is smaller, zero if both are equal, and a
+	 *         positive value if the first core is greater.
+	 */
+	inline int dct_compare(const dct_array::iterator it1, const dct_array::iterator it2) {
+
+		// the length of a compressed core is the bit length of its value (at least 2),
+		// so ordering by length and then by value is ordering by value
+		if (DCT_ITERATION_COUNT <= it1.index && DCT_ITERATION_COUNT <= it2.index) {
+			ublock rep1 = it1.array->reps[it1.index], rep2 = it2.array->reps[it2.index];
+			return rep1 == rep2 ? 0 : (rep1 < rep2 ? -1 : 1);
+		}
+
+		ubit_size size1 = it1.array->size(it1.index), size2 = it2.array->size(it2.index);
+
+		if (size1 != size2) {
+			return size1 < size2 ? -1 : 1;
+		}
+
+		return compare_blocks(it1.array->rep(it1.index), it2.array->rep(it2.index), size1);
+	};
+
+	/**
+	 * Compares two compressed cores of a `dct_array` to determine their order.
+	 *
+	 * @param it1 An iterator pointing to the first core.
+	 * @param it2 An iterator pointing to the second core.
+	 * @return true if the first core is greater than the second core; false otherwise.
+	 */
+	inline bool dct_gt(const dct_array::iterator it1, const dct_array::iterator it2) {
+		return dct_compare(it1, it2) > 0;
+	};
+
+	/**
+	 * Compares two compressed cores of a `dct_array` to determine their order.
+	 *
+	 * @param it1 An iterator pointing to the first core.
+	 * @param it2 An iterator pointing to the second core.
+	 * @return true if the first core is less than the second core; false otherwise.
+	 */
+	inline bool dct_lt(const dct_array::iterator it1, const dct_array::iterator it2) {
+		return dct_compare(it1, it2) < 0;
+	};
+
+	/**
+	 * Compares two compressed cores of a `dct_array` for equality.
+	 *
+	 * @param it1 An iterator pointing to the first core.
+	 * @param it2 An iterator pointing to the second core.
+	 * @return true if both cores have the same compressed representation; false otherwise.
+	 */
+	inline bool dct_eq(const dct_array::iterator it1, const dct_array::iterator it2) {
+		return dct_compare(it1, it2) == 0;
+	};
+
 	/**
 	 * Compares two characters from a string using a custom alphabet mapping (reverse complement).
 	 *
@@ -229,8 +531,9 @@ namespace lcp {
 	 *         pointed to by it2 based on the modularity of the reverse complement alphabet mapping;
 	 *         false otherwise.
 	 */
-	inline bool char_rc_gt(const std::string::iterator it1, const std::string::iterator it2) {
-		return (rc_alphabet[static_cast<unsigned char>(*it1)]) > (rc_alphabet[static_cast<unsigned char>(*it2)]);
+	inline bool char_rc_gt(const char *it1, const char *it2) {
+		const int *codes = context::current().rc_alphabet;
+		return codes[static_cast<unsigned char>(*it1)] > codes[static_cast<unsigned char>(*it2)];
 	};
 
 	/**
@@ -242,8 +545,9 @@ namespace lcp {
 	 *         pointed to by it2 based on the modularity of the reverse complement alphabet mapping;
 	 *         false otherwise.
 	 */
-	inline bool char_rc_lt(const std::string::iterator it1, const std::string::iterator it2) {
-		return (rc_alphabet[static_cast<unsigned char>(*it1)]) < (rc_alphabet[static_cast<unsigned char>(*it2)]);
+	inline bool char_rc_lt(const char *it1, const char *it2) {
+		const int *codes = context::current().rc_alphabet;
+		return codes[static_cast<unsigned char>(*it1)] < codes[static_cast<unsigned char>(*it2)];
 	};
 
 	/**
@@ -255,8 +559,178 @@ namespace lcp {
 	 *         pointed to by it2 based on the modularity of the reverse complement alphabet mapping;
 	 *         false otherwise.
 	 */
-	inline bool char_rc_eq(const std::string::iterator it1, const std::string::iterator it2) {
-		return (rc_alphabet[static_cast<unsigned char>(*it1)]) == (rc_alphabet[static_cast<unsigned char>(*it2)]);
+	inline bool char_rc_eq(const char *it1, const char *it2) {
+		const int *codes = context::current().rc_alphabet;
+		return codes[static_cast<unsigned char>(*it1)] == codes[static_cast<unsigned char>(*it2)];
+	};
+
+	/**
+	 * Compares two characters read through reverse iterators using the reverse complement alphabet.
+	 *
+	 * @param it1 An iterator pointing to the first character.
+	 * @param it2 An iterator pointing to the second character.
+	 * @return true if the character pointed to by it1 is greater than the character pointed to by it2.
+	 */
+	inline bool rc_gt(const rc_iterator it1, const rc_iterator it2) {
+		const int *codes = context::current().rc_alphabet;
+		return codes[static_cast<unsigned char>(*it1)] > codes[static_cast<unsigned char>(*it2)];
+	};
+
+	/**
+	 * Compares two characters read through reverse iterators using the reverse complement alphabet.
+	 *
+	 * @param it1 An iterator pointing to the first character.
+	 * @param it2 An iterator pointing to the second character.
+	 * @return true if the character pointed to by it1 is less than the character pointed to by it2.
+	 */
+	inline bool rc_lt(const rc_iterator it1, const rc_iterator it2) {
+		const int *codes = context::current().rc_alphabet;
+		return codes[static_cast<unsigned char>(*it1)] < codes[static_cast<unsigned char>(*it2)];
+	};
+
+	/**
+	 * Compares two characters read through reverse iterators using the reverse complement alphabet.
+	 *
+	 * @param it1 An iterator pointing to the first character.
+	 * @param it2 An iterator pointing to the second character.
+	 * @return true if both characters have the same reverse complement encoding.
+	 */
+	inline bool rc_eq(const rc_iterator it1, const rc_iterator it2) {
+		const int *codes = context::current().rc_alphabet;
+		return codes[static_cast<unsigned char>(*it1)] == codes[static_cast<unsigned char>(*it2)];
+	};
+
+	// MARK: Default DNA alphabet
+
+	/*
+	 * The rules below are the same as the `char_*` and `rc_*` rules for the alphabet set by
+	 * `encoding::init()`, but read the codes from the compile-time tables of encoding.h, with a constant bit size
+	 * and without thread local storage, so the compiler can fold them into the parsing loops.
+	 * They are selected at runtime through `dna_alphabet`; custom alphabets keep using the
+	 * `alphabet` and `rc_alphabet` tables.
+	 */
+
+	/**
+	 * @brief Builds the label data of a range in the layout of `char_data`.
+	 */
+	constexpr ulabel dna_label_data(size_t length, int first, int second_last, int last) {
+		return (static_cast<ulabel>(length - 2) << (3 * dna_bit_size)) |
+			   (static_cast<ulabel>(first) << (2 * dna_bit_size)) |
+			   (static_cast<ulabel>(second_last) << dna_bit_size) |
+			   static_cast<ulabel>(last);
+	};
+
+	/**
+	 * @brief Same as `char_size` with the constant bit size of the default alphabet.
+	 */
+	constexpr struct dna_width dna_size = dna_width();
+
+	/*
+	 * Representation and data rules are function objects rather than functions, so that every
+	 * parse instantiated with them calls them directly and inlines them into core construction,
+	 * even where the parse itself is not inlined.
+	 */
+
+	/**
+	 * @brief Representation rule reading the codes of `dna_codes` from `dna_blocks`.
+	 */
+	struct dna_forward_rep {
+		template <typename Iterator>
+		const ublock *operator()(Iterator it) const {
+			return dna_blocks + 1 + dna_codes[static_cast<unsigned char>(*it)];
+		};
+	};
+
+	/**
+	 * @brief Representation rule reading the codes of `dna_rc_codes` from `dna_blocks`.
+	 */
+	struct dna_reverse_rep {
+		template <typename Iterator>
+		const ublock *operator()(Iterator it) const {
+			return dna_blocks + 1 + dna_rc_codes[static_cast<unsigned char>(*it)];
+		};
+	};
+
+	/**
+	 * @brief Data rule building the layout of `char_data` from `dna_codes`, for both strands.
+	 */
+	struct dna_label {
+		template <typename Iterator>
+		ulabel operator()(Iterator begin, Iterator end) const {
+			return dna_label_data(end - begin, dna_codes[static_cast<unsigned char>(*begin)], dna_codes[static_cast<unsigned char>(*(end - 2))], dna_codes[static_cast<unsigned char>(*(end - 1))]);
+		};
+	};
+
+	/**
+	 * @brief Same as `char_rep` read from `dna_blocks`.
+	 */
+	constexpr struct dna_forward_rep dna_rep = dna_forward_rep();
+
+	/**
+	 * @brief Same as `char_rev_rep` read from `dna_blocks`.
+	 */
+	constexpr struct dna_reverse_rep dna_rev_rep = dna_reverse_rep();
+
+	/**
+	 * @brief Same as `char_data` with compile-time shifts.
+	 */
+	constexpr struct dna_label dna_data = dna_label();
+
+	/**
+	 * @brief Same as `char_gt` for the default alphabet.
+	 */
+	inline bool dna_gt(const char *it1, const char *it2) {
+		return dna_codes[static_cast<unsigned char>(*it1)] > dna_codes[static_cast<unsigned char>(*it2)];
+	};
+
+	/**
+	 * @brief Same as `char_lt` for the default alphabet.
+	 */
+	inline bool dna_lt(const char *it1, const char *it2) {
+		return dna_codes[static_cast<unsigned char>(*it1)] < dna_codes[static_cast<unsigned char>(*it2)];
+	};
+
+	/**
+	 * @brief Same as `char_eq` for the default alphabet.
+	 */
+	inline bool dna_eq(const char *it1, const char *it2) {
+		return dna_codes[static_cast<unsigned char>(*it1)] == dna_codes[static_cast<unsigned char>(*it2)];
+	};
+
+	/**
+	 * @brief Same as `rc_size` with the constant bit size of the default alphabet.
+	 */
+	constexpr struct dna_width dna_rc_size = dna_width();
+
+	/**
+	 * @brief Same as `rc_rep` read from `dna_blocks`.
+	 */
+	constexpr struct dna_reverse_rep dna_rc_rep = dna_reverse_rep();
+
+	/**
+	 * @brief Same as `rc_data`, labels of reverse complement cores use the forward codes as well.
+	 */
+	constexpr struct dna_label dna_rc_data = dna_label();
+
+	/**
+	 * @brief Same as `rc_gt` for the default alphabet.
+	 */
+	inline bool dna_rc_gt(const rc_iterator it1, const rc_iterator it2) {
+		return dna_rc_codes[static_cast<unsigned char>(*it1)] > dna_rc_codes[static_cast<unsigned char>(*it2)];
+	};
+
+	/**
+	 * @brief Same as `rc_lt` for the default alphabet.
+	 */
+	inline bool dna_rc_lt(const rc_iterator it1, const rc_iterator it2) {
+		return dna_rc_codes[static_cast<unsigned char>(*it1)] < dna_rc_codes[static_cast<unsigned char>(*it2)];
+	};
+
+	/**
+	 * @brief Same as `rc_eq` for the default alphabet.
+	 */
+	inline bool dna_rc_eq(const rc_iterator it1, const rc_iterator it2) {
+		return dna_rc_codes[static_cast<unsigned char>(*it1)] == dna_rc_codes[static_cast<unsigned char>(*it2)];
 	};
 
 	// MARK: LCP rules
@@ -324,6 +798,80 @@ namespace lcp {
 		return middle_count;
 	};
 
+	/**
+	 * Three-way form of `isLMIN`, from the relations of the neighbouring pairs.
+	 *
+	 * @param curr The relation of the element at the position and the next one.
+	 * @param next The relation of the next two elements.
+	 * @return true if the element at the position is a local minimum; false otherwise.
+	 */
+	inline bool isLMIN(int curr, int next) {
+		return 0 < curr && next < 0;
+	};
+
+	/**
+	 * Three-way form of `isLMAX`, from the relations of the neighbouring pairs. The caller
+	 * checks that the three elements after the position exist.
+	 *
+	 * @param prev The relation of the previous element and the element at the position.
+	 * @param curr The relation of the element at the position and the next one.
+	 * @param next The relation of the next two elements.
+	 * @param after The relation of the two elements after them.
+	 * @return true if the element at the position is a local maximum; false otherwise.
+	 */
+	inline bool isLMAX(int prev, int curr, int next, int after) {
+		return curr < 0 && 0 < next && prev <= 0 && 0 <= after;
+	};
+
+	/**
+	 * Three-way form of `countMiddle`, given the relation `next` of the two elements after `it`.
+	 * The caller checks that `it + 2` is before `end`.
+	 *
+	 * @tparam Iterator The type of the iterator.
+	 * @tparam Order The three-way comparison function.
+	 * @param it The iterator pointing to the start of the range.
+	 * @param end The end iterator for the range being checked.
+	 * @param next The relation of the elements at `it + 1` and `it + 2`.
+	 * @param order The three-way comparison function.
+	 * @return The count of consecutive elements in the middle that are equal; returns 0 if
+	 *         the sequence runs to the end.
+	 */
+	template <typename Iterator, typename Order>
+	size_t countMiddle(const Iterator it, const Iterator end, int next, Order order) {
+		if (next != 0) {
+			return 1;
+		}
+		size_t middle_count = 2;
+		Iterator temp = it + 3;
+		while (temp < end && order((temp - 1), temp) == 0) {
+			temp++;
+			middle_count++;
+		}
+		if (temp == end) {
+			return 0;
+		}
+		return middle_count;
+	};
+
+	/**
+	 * Three-way comparison built from a pair of greater-than and less-than comparison
+	 * functions, for the rules that are not written as a three-way comparison.
+	 *
+	 * @tparam Compare The type of the comparison functions.
+	 */
+	template <typename Compare>
+	struct relation {
+		Compare gt;
+		Compare lt;
+
+		relation(Compare greater, Compare less) : gt(greater), lt(less) {};
+
+		template <typename Iterator>
+		inline int operator()(const Iterator it1, const Iterator it2) const {
+			return static_cast<int>(gt(it1, it2)) - static_cast<int>(lt(it1, it2));
+		};
+	};
+
 	/**
 	 * Checks if two sequences do not overlap, indicating that one sequence starts
 	 * after the other sequence ends.
@@ -0,0 +1,280 @@
+#include "shard.h"
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace lcp {
+
+	struct shard_header {
+		char magic[4];
+		uint16_t version;
+		uint16_t flags;
+		uint64_t id_count;
+		uint64_t string_count;
+		uint64_t core_count;
+	};
+
+	static_assert(sizeof(struct shard_header) == 32, "shard header must be 32 bytes");
+
+	shard::shard() {};
+
+	shard::shard(struct context &ctx) {
+
+		size_t count = ctx.next_id;
+		std::vector<ulabel> keys(4 * count);
+		std::vector<bool> seen(count, false);
+
+		this->kinds.assign((count + 63) / 64, 0);
+
+		auto take = [&](const ulabel *key, ulabel id, size_t key_size) {
+			if (count <= id || seen[id]) {
+				throw std::runtime_error("Dictionary IDs are not dense.");
+			}
+
+			seen[id] = true;
+			std::copy(key, key + key_size, keys.begin() + 4 * id);
+
+			if (key_size == 4) {
+				this->kinds[id / 64] |= static_cast<uint64_t>(1) << (id % 64);
+			}
+		};
+
+		ctx.str_map.for_each([&](const ulabel *key, ulabel id) { take(key, id, 1); });
+		ctx.cores_map.for_each([&](const ulabel *key, ulabel id) { take(key, id, 4); });
+
+		for (size_t id = 0; id < count; id++) {
+			if (!seen[id]) {
+				throw std::runtime_error("Dictionary IDs are not dense.");
+			}
+
+			if (this->kinds[id / 64] >> (id % 64) & 1) {
+				this->cores.insert(this->cores.end(), keys.begin() + 4 * id, keys.begin() + 4 * id + 4);
+			} else {
+				this->strings.push_back(keys[4 * id]);
+			}
+		}
+	};
+
+	size_t shard::size() const {
+		return this->strings.size() + this->cores.size() / 4;
+	};
+
+	void shard::merge(std::vector<ulabel> &ids, struct context &global) const {
+
+		context::scope bind(global);
+
+		size_t count = this->size();
+		const ulabel *strings = this->strings.data();
+		const ulabel *cores = this->cores.data();
+
+		ids.resize(count);
+
+		for (size_t id = 0; id < count; id++) {
+
+			if (!(this->kinds[id / 64] >> (id % 64) & 1)) {
+				ids[id] = hash::emplace(*strings++);
+				continue;
+			}
+
+			// the labels of the key were assigned before the key itself
+			ulabel data[4];
+			for (size_t word = 0; word < 3; word++) {
+				if (id <= cores[word]) {
+					throw std::runtime_error("Dictionary key refers to a later ID.");
+				}
+				data[word] = ids[cores[word]];
+			}
+			data[3] = cores[3];
+			cores += 4;
+
+			ids[id] = hash::emplace(data);
+		}
+	};
+
+	void shard::write(std::ofstream &out) const {
+
+		struct shard_header hdr;
+
+		memcpy(hdr.magic, SHARD_MAGIC, 4);
+		hdr.version = SHARD_VERSION;
+		hdr.flags = LCPT_WIDTH;
+		hdr.id_count = this->size();
+		hdr.string_count = this->strings.size();
+		hdr.core_count = this->cores.size() / 4;
+
+		out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+
+		lcpt::write_section(out, this->kinds.data(), this->kinds.size() * sizeof(uint64_t));
+		lcpt::write_section(out, this->strings.data(), this->strings.size() * sizeof(ulabel));
+		lcpt::write_section(out, this->cores.data(), this->cores.size() * sizeof(ulabel));
+	};
+
+	bool shard::read(std::ifstream &in) {
+
+		struct shard_header hdr;
+
+		if (!in.read(reinterpret_cast<char *>(&hdr), sizeof(hdr)) || memcmp(hdr.magic, SHARD_MAGIC, 4) != 0 || hdr.flags != LCPT_WIDTH || hdr.version != SHARD_VERSION || hdr.id_count != hdr.string_count + hdr.core_count) {
+			return false;
+		}
+
+		lcpt::read_section(in, this->kinds, (hdr.id_count + 63) / 64);
+		lcpt::read_section(in, this->strings, hdr.string_count);
+		lcpt::read_section(in, this->cores, 4 * hdr.core_count);
+
+		return static_cast<bool>(in);
+	};
+
+	static inline bool ids_of(const ulabel *labels, size_t size, const std::vector<ulabel> &ids) {
+		for (size_t index = 0; index < size; index++) {
+			if (ids.size() <= labels[index]) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	bool shard::remap(struct core_array &cores, const std::vector<ulabel> &ids) {
+
+		if ((cores.label_flags & LCPT_LABELS) != LCPT_IDS || !ids_of(cores.labels.data(), cores.labels.size(), ids)) {
+			return false;
+		}
+
+		for (std::vector<ulabel>::iterator it = cores.labels.begin(); it != cores.labels.end(); it++) {
+			*it = ids[*it];
+		}
+
+		cores.label_flags |= LCPT_MERGED;
+
+		return true;
+	};
+
+	bool shard::relabel(std::string &data, const std::vector<ulabel> &ids) {
+
+		lcpt::header hdr;
+
+		if (data.size() < sizeof(hdr)) {
+			return false;
+		}
+
+		memcpy(&hdr, data.data(), sizeof(hdr));
+
+		if (memcmp(hdr.magic, LCPT_MAGIC, 4) != 0 || (hdr.flags & LCPT_LABELS) != LCPT_IDS) {
+			return false;
+		}
+
+		// the labels follow the name and the gaps
+		size_t position = sizeof(hdr);
+
+		if (hdr.flags & LCPT_NAME) {
+			position += lcpt::section_size(hdr.name_length);
+		}
+
+		if (hdr.flags & LCPT_GAPS) {
+			uint64_t gap_count = 0;
+
+			if (data.size() < position + sizeof(gap_count)) {
+				return false;
+			}
+
+			memcpy(&gap_count, data.data() + position, sizeof(gap_count));
+			position += sizeof(gap_count) + lcpt::section_size(gap_count * sizeof(struct gap));
+		}
+
+		if (data.size() < position + hdr.size * sizeof(ulabel)) {
+			return false;
+		}
+
+		ulabel *labels = reinterpret_cast<ulabel *>(&data[position]);
+
+		if (!ids_of(labels, hdr.size, ids)) {
+			return false;
+		}
+
+		for (size_t index = 0; index < hdr.size; index++) {
+			labels[index] = ids[labels[index]];
+		}
+
+		return true;
+	};
+
+	int shard::remap(const std::string &filename, const std::vector<ulabel> &ids) {
+
+		std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+
+		if (!file.is_open()) {
+			return -1;
+		}
+
+		int count = 0;
+		lcpt::header hdr;
+		std::vector<ulabel> labels;
+
+		// the first pass checks every record and the second one writes, so a failure leaves the file unchanged
+		for (int pass = 0; pass < 2; pass++) {
+
+			file.clear();
+			file.seekg(0);
+			count = 0;
+
+			std::streampos start = file.tellg();
+
+			while (lcpt::read_header(file, hdr)) {
+
+				std::streampos position = file.tellg();
+				size_t length = hdr.size * sizeof(ulabel);
+
+				if (!(hdr.flags & LCPT_MERGED)) {
+
+					if ((hdr.flags & LCPT_LABELS) != LCPT_IDS) {
+						return -1;
+					}
+
+					lcpt::read_section(file, labels, hdr.size);
+
+					if (!file || !ids_of(labels.data(), labels.size(), ids)) {
+						return -1;
+					}
+
+					if (pass == 1) {
+						for (std::vector<ulabel>::iterator it = labels.begin(); it != labels.end(); it++) {
+							*it = ids[*it];
+						}
+
+						file.seekp(position);
+						file.write(reinterpret_cast<const char *>(labels.data()), length);
+
+						// the record is marked once its labels are written
+						uint16_t flags = hdr.flags | LCPT_MERGED;
+						file.seekp(start + static_cast<std::streamoff>(offsetof(lcpt::header, flags)));
+						file.write(reinterpret_cast<const char *>(&flags), sizeof(flags));
+					}
+
+					count++;
+				}
+
+				// the other columns are skipped
+				size_t skipped = lcpt::section_size(length) +
+								 lcpt::section_size(hdr.size * sizeof(ubit_size)) +
+								 lcpt::section_size(hdr.block_count * sizeof(ublock));
+
+				if (hdr.flags & LCPT_OFFSETS) {
+					skipped += lcpt::section_size((hdr.size + 1) * sizeof(uint64_t));
+				}
+
+				if (hdr.flags & LCPT_POSITIONS) {
+					skipped += 2 * lcpt::section_size(hdr.size * sizeof(uint64_t));
+				}
+
+				file.seekg(position + static_cast<std::streamoff>(skipped));
+				start = file.tellg();
+			}
+
+			if (file.bad()) {
+				return -1;
+			}
+		}
+
+		return count;
+	};
+
+}; // namespace lcp
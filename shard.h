@@ -0,0 +1,164 @@
+/**
+ * @file shard.h
+ * @brief Serialized label dictionaries, merged to make the cores of shards comparable.
+ *
+ * With the label dictionary, cores are labelled by IDs handed out in the order
+ * cores are first seen, so the IDs of collections parsed on different nodes, or
+ * in different contexts, do not match. A `shard` holds the dictionaries of a
+ * context in a compact form: IDs are dense, hence keys are stored in ID order
+ * without their IDs, along with one bit per ID telling which dictionary it
+ * belongs to. Shards are written next to their .lcpt files and merged into a
+ * global context afterwards, in ID order, so that the labels in the keys of
+ * higher level cores are translated before the keys are inserted. Merging yields
+ * the global ID of every local ID, and the labels of the .lcpt files of the
+ * shard are rewritten in place, without parsing them again.
+ *
+ * Merging the same shards in the same order always assigns the same global IDs,
+ * and a merged dictionary can be written as a shard itself and merged again with
+ * further shards later. Remapped cores and records are marked by `LCPT_MERGED`,
+ * so that their labels are never remapped twice.
+ *
+ * Example usage:
+ * @code
+ *   // on every node, after parsing with use_map
+ *   std::ofstream out("part1.lcpd", std::ios::binary);
+ *   lcp::shard(lcp::context::current()).write(out);
+ *
+ *   // merge step
+ *   lcp::context global;
+ *   lcp::shard local;
+ *   std::vector<ulabel> ids;
+ *   local.read(in);
+ *   local.merge(ids, global);
+ *   lcp::shard::remap("part1.lcpt", ids);
+ * @endcode
+ *
+ * @see context.h
+ * @see lcpt.h
+ *
+ * @namespace lcp
+ * @struct shard
+ *
+ * @note Only cores labelled with the dictionary can be remapped, labels computed
+ * by hashing are not IDs.
+ *
+ */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "constant.h"
+#include "context.h"
+#include "core_array.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define SHARD_MAGIC             "LCPD"
+#define SHARD_VERSION           1
+
+namespace lcp {
+
+	struct shard {
+	  public:
+		// bit `id % 64` of word `id / 64` is set if the ID is a key of `cores`, otherwise of `strings`
+		std::vector<uint64_t> kinds;
+		// keys of `hash::str_map` in ID order
+		std::vector<ulabel> strings;
+		// keys of `hash::cores_map` in ID order, four words each
+		std::vector<ulabel> cores;
+
+		/**
+		 * @brief Constructs an empty shard.
+		 */
+		shard();
+
+		/**
+		 * @brief Takes the keys of the dictionaries of a context.
+		 *
+		 * No thread may parse in the context meanwhile.
+		 *
+		 * @param ctx The context.
+		 * @throws std::runtime_error if the IDs of the context are not dense.
+		 */
+		shard(struct context &ctx);
+
+		/**
+		 * @brief Returns the number of IDs in the shard.
+		 */
+		size_t size() const;
+
+		/**
+		 * @brief Inserts the keys of the shard into the dictionaries of a context.
+		 *
+		 * Labels in the keys of `cores` are translated to the IDs of the context before
+		 * insertion, keys already present keep their ID.
+		 *
+		 * @param ids Receives the ID in the context of every ID of the shard.
+		 * @param global The context receiving the keys.
+		 * @throws std::runtime_error if a key refers to an ID that is not smaller than its own.
+		 */
+		void merge(std::vector<ulabel> &ids, struct context &global = context::current()) const;
+
+		/**
+		 * @brief Writes the shard to a file.
+		 *
+		 * @param out The output file stream.
+		 */
+		void write(std::ofstream &out) const;
+
+		/**
+		 * @brief Reads a shard written by `write`.
+		 *
+		 * @param in The input file stream.
+		 * @return True if a valid shard was read.
+		 */
+		bool read(std::ifstream &in);
+
+		/**
+		 * @brief Replaces the labels of cores by the IDs they were merged to.
+		 *
+		 * The cores are marked by `LCPT_MERGED` afterwards.
+		 *
+		 * @param cores The cores, labelled with the dictionary of the shard.
+		 * @param ids The IDs computed by `merge`.
+		 * @return False, leaving the cores unchanged, if the labels are not dictionary IDs, are
+		 * remapped already, or a label is not an ID of the shard.
+		 */
+		static bool remap(struct core_array &cores, const std::vector<ulabel> &ids);
+
+		/**
+		 * @brief Replaces the labels of a serialized record by the IDs its dictionary was merged to.
+		 *
+		 * Unlike `remap`, the record is not marked by `LCPT_MERGED`: it is meant for records parsed in
+		 * a context of their own and merged into the context they are written with, e.g. by lcptools,
+		 * so their labels are still the IDs of an unmerged dictionary.
+		 *
+		 * @param data The record, as appended by `core_array::write` to a byte buffer.
+		 * @param ids The IDs computed by `merge`.
+		 * @return False, leaving the record unchanged, if the buffer does not start with a record
+		 * holding dictionary IDs, or a label is not an ID of the shard.
+		 */
+		static bool relabel(std::string &data, const std::vector<ulabel> &ids);
+
+		/**
+		 * @brief Replaces the labels of every record of an .lcpt file in place.
+		 *
+		 * Only the label columns and the flags are read and written, the rest of every record
+		 * is skipped. Every record is checked before any is written, and a record is marked by
+		 * `LCPT_MERGED` once its labels are written. Records marked already are left as they
+		 * are, so an interrupted remap can be run again.
+		 *
+		 * @param filename The path of the .lcpt file.
+		 * @param ids The IDs computed by `merge`.
+		 * @return The number of records remapped, or -1, leaving the file unchanged, if the file
+		 * cannot be opened, a record does not hold dictionary IDs, or a label is not an ID of
+		 * the shard.
+		 */
+		static int remap(const std::string &filename, const std::vector<ulabel> &ids);
+	};
+
+}; // namespace lcp
+
+#endif
@@ -0,0 +1,165 @@
+#include "simd.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define LCP_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define LCP_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace lcp {
+
+	namespace simd {
+
+		bool build_table(const int *alphabet, int8_t *table) {
+			for (int index = 0; index < 256; index++) {
+				table[index] = -1;
+			}
+
+			for (int index = 0; index < 128; index++) {
+				if (alphabet[index] < INT8_MIN || INT8_MAX < alphabet[index]) {
+					return false;
+				}
+				table[index] = static_cast<int8_t>(alphabet[index]);
+			}
+
+			return true;
+		};
+
+		void translate(const char *begin, const char *end, const int8_t *table, int8_t *codes) {
+			for (; begin < end; begin++, codes++) {
+				*codes = table[static_cast<unsigned char>(*begin)];
+			}
+		};
+
+		void translate_reverse(const char *begin, const char *end, const int8_t *table, int8_t *codes) {
+			for (; begin < end; end--, codes++) {
+				*codes = table[static_cast<unsigned char>(*(end - 1))];
+			}
+		};
+
+		static void compare_scalar(const int8_t *codes, size_t word_count, uint64_t *eq, uint64_t *gt, uint64_t *lt) {
+			for (size_t word = 0; word < word_count; word++, codes += 64) {
+				uint64_t eq_word = 0, gt_word = 0, lt_word = 0;
+
+				for (int index = 0; index < 64; index++) {
+					eq_word |= static_cast<uint64_t>(codes[index] == codes[index + 1]) << index;
+					gt_word |= static_cast<uint64_t>(codes[index] > codes[index + 1]) << index;
+					lt_word |= static_cast<uint64_t>(codes[index] < codes[index + 1]) << index;
+				}
+
+				eq[word] = eq_word;
+				gt[word] = gt_word;
+				lt[word] = lt_word;
+			}
+		};
+
+#ifdef LCP_SIMD_X86
+		__attribute__((target("avx2"))) static void compare_avx2(const int8_t *codes, size_t word_count, uint64_t *eq, uint64_t *gt, uint64_t *lt) {
+			for (size_t word = 0; word < word_count; word++, codes += 64) {
+				uint64_t masks[3] = {0, 0, 0};
+
+				for (int half = 0; half < 2; half++) {
+					__m256i curr = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(codes + 32 * half));
+					__m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(codes + 32 * half + 1));
+
+					masks[0] |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(curr, next)))) << (32 * half);
+					masks[1] |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(curr, next)))) << (32 * half);
+					masks[2] |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(next, curr)))) << (32 * half);
+				}
+
+				eq[word] = masks[0];
+				gt[word] = masks[1];
+				lt[word] = masks[2];
+			}
+		};
+
+		__attribute__((target("avx512f,avx512bw"))) static void compare_avx512(const int8_t *codes, size_t word_count, uint64_t *eq, uint64_t *gt, uint64_t *lt) {
+			for (size_t word = 0; word < word_count; word++, codes += 64) {
+				__m512i curr = _mm512_loadu_si512(codes);
+				__m512i next = _mm512_loadu_si512(codes + 1);
+
+				eq[word] = _mm512_cmpeq_epi8_mask(curr, next);
+				gt[word] = _mm512_cmpgt_epi8_mask(curr, next);
+				lt[word] = _mm512_cmplt_epi8_mask(curr, next);
+			}
+		};
+#endif
+
+#ifdef LCP_SIMD_NEON
+		/**
+		 * @brief Packs the lanes of a comparison result, all ones or all zeros, into 16 bits.
+		 */
+		static inline uint64_t neon_mask(uint8x16_t lanes) {
+			static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+			uint8x16_t bits = vandq_u8(lanes, vld1q_u8(weights));
+			return static_cast<uint64_t>(vaddv_u8(vget_low_u8(bits))) | static_cast<uint64_t>(vaddv_u8(vget_high_u8(bits))) << 8;
+		};
+
+		static void compare_neon(const int8_t *codes, size_t word_count, uint64_t *eq, uint64_t *gt, uint64_t *lt) {
+			for (size_t word = 0; word < word_count; word++, codes += 64) {
+				uint64_t masks[3] = {0, 0, 0};
+
+				for (int quarter = 0; quarter < 4; quarter++) {
+					int8x16_t curr = vld1q_s8(codes + 16 * quarter);
+					int8x16_t next = vld1q_s8(codes + 16 * quarter + 1);
+
+					masks[0] |= neon_mask(vceqq_s8(curr, next)) << (16 * quarter);
+					masks[1] |= neon_mask(vcgtq_s8(curr, next)) << (16 * quarter);
+					masks[2] |= neon_mask(vcgtq_s8(next, curr)) << (16 * quarter);
+				}
+
+				eq[word] = masks[0];
+				gt[word] = masks[1];
+				lt[word] = masks[2];
+			}
+		};
+#endif
+
+		typedef void (*compare_fn)(const int8_t *, size_t, uint64_t *, uint64_t *, uint64_t *);
+
+		struct dispatch {
+			compare_fn fn;
+			const char *name;
+
+			dispatch() {
+				this->fn = compare_scalar;
+				this->name = "scalar";
+#ifdef LCP_SIMD_NEON
+				// NEON is part of every AArch64 processor
+				this->fn = compare_neon;
+				this->name = "neon";
+#endif
+#ifdef LCP_SIMD_X86
+				__builtin_cpu_init();
+				if (__builtin_cpu_supports("avx512bw")) {
+					this->fn = compare_avx512;
+					this->name = "avx512bw";
+				} else if (__builtin_cpu_supports("avx2")) {
+					this->fn = compare_avx2;
+					this->name = "avx2";
+				}
+#endif
+			};
+		};
+
+		static const struct dispatch &selected() {
+			static const struct dispatch instance;
+			return instance;
+		};
+
+		void compare(const int8_t *codes, size_t word_count, uint64_t *eq, uint64_t *gt, uint64_t *lt) {
+			selected().fn(codes, word_count, eq, gt, lt);
+		};
+
+		const char *kernel() {
+			return selected().name;
+		};
+
+	}; // namespace simd
+
+}; // namespace lcp
@@ -0,0 +1,112 @@
+/**
+ * @file simd.h
+ * @brief Bit-parallel comparison of neighbouring characters for level 1 parsing.
+ *
+ * Level 1 cores are decided only by whether a character is equal to, less than or
+ * greater than its right neighbour. The functions in this file translate a chunk of
+ * the sequence into one byte code per character and compute these three relations
+ * for 64 positions at a time as bitmasks, where bit `k` of word `w` describes the
+ * pair (`codes[64 * w + k]`, `codes[64 * w + k + 1]`).
+ *
+ * The comparison kernel is selected once at runtime: AVX-512BW or AVX2 on x86-64
+ * when the processor supports them, NEON on AArch64, and a portable scalar loop
+ * otherwise.
+ *
+ * Example usage:
+ * @code
+ *   int8_t table[256];
+ *   lcp::simd::build_table(alphabet, table);
+ *   lcp::simd::translate(sequence, sequence + 129, table, codes);
+ *   lcp::simd::compare(codes, 2, eq, gt, lt);
+ * @endcode
+ *
+ * @see lps.h
+ *
+ * @namespace lcp::simd
+ *
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace lcp {
+
+	namespace simd {
+
+		/**
+		 * @brief Builds a byte code table from an alphabet.
+		 *
+		 * Characters outside of the 128 entry alphabet get -1, like invalid characters.
+		 *
+		 * @param alphabet The alphabet to be used, e.g. `alphabet` or `rc_alphabet`.
+		 * @param table The table of 256 entries to be filled.
+		 * @return False if a code of the alphabet does not fit into a signed byte.
+		 */
+		bool build_table(const int *alphabet, int8_t *table);
+
+		/**
+		 * @brief Translates the characters in [begin, end) into byte codes.
+		 *
+		 * @param begin Pointer to the first character.
+		 * @param end Pointer past the last character.
+		 * @param table The table built by `build_table`.
+		 * @param codes The output buffer of at least `end - begin` bytes.
+		 */
+		void translate(const char *begin, const char *end, const int8_t *table, int8_t *codes);
+
+		/**
+		 * @brief Translates the characters in [begin, end) into byte codes, from the last one to the first one.
+		 *
+		 * @param begin Pointer to the first character.
+		 * @param end Pointer past the last character.
+		 * @param table The table built by `build_table`.
+		 * @param codes The output buffer of at least `end - begin` bytes, `codes[0]` is the code of `end[-1]`.
+		 */
+		void translate_reverse(const char *begin, const char *end, const int8_t *table, int8_t *codes);
+
+		/**
+		 * @brief Translates a range given by reverse iterators into byte codes, in the order they are read.
+		 */
+		inline void translate(std::reverse_iterator<const char *> begin, std::reverse_iterator<const char *> end, const int8_t *table, int8_t *codes) {
+			translate_reverse(end.base(), begin.base(), table, codes);
+		};
+
+		/**
+		 * @brief Compares every code with its right neighbour.
+		 *
+		 * @param codes The codes, at least `64 * word_count + 1` of them are read.
+		 * @param word_count The number of 64 position words to compute.
+		 * @param eq Output words, bit set if a code is equal to its right neighbour.
+		 * @param gt Output words, bit set if a code is greater than its right neighbour.
+		 * @param lt Output words, bit set if a code is less than its right neighbour.
+		 */
+		void compare(const int8_t *codes, size_t word_count, uint64_t *eq, uint64_t *gt, uint64_t *lt);
+
+		/**
+		 * @brief Returns the name of the comparison kernel in use.
+		 *
+		 * @return One of "avx512bw", "avx2", "neon" or "scalar".
+		 */
+		const char *kernel();
+
+		/**
+		 * @brief Returns the 64 bits of a mask starting at an arbitrary bit position.
+		 *
+		 * @param mask The mask words, the word following `position / 64` must be readable.
+		 * @param position The bit position of the first returned bit.
+		 * @return The bits [position, position + 64) of the mask.
+		 */
+		inline uint64_t bits(const uint64_t *mask, size_t position) {
+			size_t word = position / 64, shift = position % 64;
+			return shift == 0 ? mask[word] : (mask[word] >> shift) | (mask[word + 1] << (64 - shift));
+		};
+
+	}; // namespace simd
+
+}; // namespace lcp
+
+#endif
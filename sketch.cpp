@@ -0,0 +1,229 @@
+#include "sketch.h"
+#include "lcpt.h"
+#include "pipeline.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace lcp {
+
+	struct sketch_header {
+		char magic[4];
+		uint16_t version;
+		uint16_t flags;
+		int32_t level;
+		uint32_t size;
+		uint64_t capacity;
+		uint64_t threshold;
+	};
+
+	static_assert(sizeof(struct sketch_header) == 32, "sketch header must be 32 bytes");
+
+	/**
+	 * @brief Finalizer of MurmurHash3, a bijection spreading labels over the hash space.
+	 */
+	inline uint32_t mix(uint32_t h) {
+		h ^= h >> 16;
+		h *= 0x85ebca6b;
+		h ^= h >> 13;
+		h *= 0xc2b2ae35;
+		h ^= h >> 16;
+		return h;
+	};
+
+	sketch::sketch(size_t size, double scale) {
+		this->level = 0;
+		this->label_flags = 0;
+		this->capacity = size;
+		this->threshold = scale >= 1.0 ? (static_cast<uint64_t>(1) << 32) : static_cast<uint64_t>(scale * 4294967296.0);
+		this->sorted = 0;
+	};
+
+	void sketch::add(ulabel label) {
+
+#ifdef LCP_64BIT
+		uint32_t h = mix(static_cast<uint32_t>(label ^ (label >> 32)));
+#else
+		uint32_t h = mix(label);
+#endif
+
+		if (h >= this->threshold) {
+			return;
+		}
+
+		// a full bottom-k sketch only accepts hashes below its largest one
+		if (0 < this->capacity && this->capacity <= this->sorted && this->hashes[this->sorted - 1] <= h) {
+			return;
+		}
+
+		this->hashes.push_back(h);
+
+		if (std::max(std::max(this->capacity, this->sorted), static_cast<size_t>(1024)) <= this->hashes.size() - this->sorted) {
+			this->finish();
+		}
+	};
+
+	void sketch::labelled(uint16_t label_flags) {
+
+		if (!this->hashes.empty() && !lcpt::comparable(this->label_flags, label_flags)) {
+			throw std::invalid_argument("Labels computed differently are added.");
+		}
+
+		this->label_flags = label_flags;
+	};
+
+	void sketch::add(const lps &lps_obj) {
+
+		this->labelled(lps_obj.label_flags);
+		this->level = lps_obj.level;
+
+		if (lps_obj.cores != nullptr) {
+			for (std::vector<struct core>::const_iterator it = lps_obj.cores->begin(); it != lps_obj.cores->end(); it++) {
+				this->add(it->label);
+			}
+		}
+
+		this->finish();
+	};
+
+	void sketch::add(const core_array &cores) {
+
+		this->labelled(cores.label_flags);
+		this->level = cores.level;
+
+		for (std::vector<ulabel>::const_iterator it = cores.labels.begin(); it != cores.labels.end(); it++) {
+			this->add(*it);
+		}
+
+		this->finish();
+	};
+
+	void sketch::parse(const char *begin, const char *end, int lcp_level, bool use_map) {
+
+		this->labelled(lcpt::labelling(lcp_level, use_map));
+		this->level = lcp_level;
+
+		pipeline stream(lcp_level, [this](struct core &c) { this->add(c.label); }, use_map);
+		stream.push(begin, end);
+		stream.finish();
+
+		this->finish();
+	};
+
+	void sketch::parse(const std::string &str, int lcp_level, bool use_map) {
+		this->parse(str.data(), str.data() + str.size(), lcp_level, use_map);
+	};
+
+	void sketch::finish() {
+
+		// merge the new hashes into the sorted prefix
+		std::sort(this->hashes.begin() + this->sorted, this->hashes.end());
+		std::inplace_merge(this->hashes.begin(), this->hashes.begin() + this->sorted, this->hashes.end());
+		this->hashes.erase(std::unique(this->hashes.begin(), this->hashes.end()), this->hashes.end());
+
+		if (0 < this->capacity && this->capacity < this->hashes.size()) {
+			this->hashes.resize(this->capacity);
+		}
+
+		this->sorted = this->hashes.size();
+	};
+
+	uint64_t sketch::limit() const {
+
+		if (0 < this->capacity && this->capacity <= this->hashes.size()) {
+			return this->hashes.back();
+		}
+
+		return this->threshold - 1;
+	};
+
+	void sketch::compare(const sketch &other, size_t &union_count, size_t &shared_count, size_t &own_count) const {
+
+		if (!lcpt::comparable(this->label_flags, other.label_flags)) {
+			throw std::invalid_argument("Sketches of labels computed differently are compared.");
+		}
+
+		uint64_t max_hash = std::min(this->limit(), other.limit());
+
+		std::vector<uint32_t>::const_iterator it1 = this->hashes.begin(), it2 = other.hashes.begin();
+		std::vector<uint32_t>::const_iterator end1 = std::upper_bound(this->hashes.begin(), this->hashes.end(), max_hash);
+		std::vector<uint32_t>::const_iterator end2 = std::upper_bound(other.hashes.begin(), other.hashes.end(), max_hash);
+
+		union_count = 0;
+		shared_count = 0;
+		own_count = end1 - it1;
+
+		while (it1 != end1 && it2 != end2) {
+			if (*it1 == *it2) {
+				shared_count++;
+				it1++;
+				it2++;
+			} else if (*it1 < *it2) {
+				it1++;
+			} else {
+				it2++;
+			}
+			union_count++;
+		}
+
+		union_count += (end1 - it1) + (end2 - it2);
+	};
+
+	double sketch::jaccard(const sketch &other) const {
+
+		size_t union_count, shared_count, own_count;
+		this->compare(other, union_count, shared_count, own_count);
+
+		return union_count == 0 ? 0 : static_cast<double>(shared_count) / union_count;
+	};
+
+	double sketch::containment(const sketch &other) const {
+
+		size_t union_count, shared_count, own_count;
+		this->compare(other, union_count, shared_count, own_count);
+
+		return own_count == 0 ? 0 : static_cast<double>(shared_count) / own_count;
+	};
+
+	void sketch::clear() {
+		this->hashes.clear();
+		this->sorted = 0;
+	};
+
+	void sketch::write(std::ofstream &out) const {
+
+		struct sketch_header hdr;
+
+		memcpy(hdr.magic, SKETCH_MAGIC, 4);
+		hdr.version = SKETCH_VERSION;
+		hdr.flags = (this->label_flags & LCPT_LABELS) | LCPT_WIDTH;
+		hdr.level = this->level;
+		hdr.size = this->hashes.size();
+		hdr.capacity = this->capacity;
+		hdr.threshold = this->threshold;
+
+		out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+
+		lcpt::write_section(out, this->hashes.data(), this->hashes.size() * sizeof(uint32_t));
+	};
+
+	bool sketch::read(std::ifstream &in) {
+
+		struct sketch_header hdr;
+
+		if (!in.read(reinterpret_cast<char *>(&hdr), sizeof(hdr)) || memcmp(hdr.magic, SKETCH_MAGIC, 4) != 0 || (hdr.flags & ~LCPT_LABELS) != LCPT_WIDTH || hdr.version != SKETCH_VERSION) {
+			return false;
+		}
+
+		this->level = hdr.level;
+		this->label_flags = hdr.flags & LCPT_LABELS;
+		this->capacity = hdr.capacity;
+		this->threshold = hdr.threshold;
+
+		lcpt::read_section(in, this->hashes, hdr.size);
+		this->sorted = this->hashes.size();
+
+		return static_cast<bool>(in);
+	};
+
+}; // namespace lcp
@@ -0,0 +1,195 @@
+/**
+ * @file sketch.h
+ * @brief MinHash and FracMinHash sketches of the core labels of a sequence.
+ *
+ * The `sketch` struct keeps the smallest hashes of the distinct core labels of
+ * a sequence, which is enough to estimate the Jaccard similarity and the
+ * containment of two sequences. Two kinds of selection are supported and can be
+ * combined:
+ *
+ *   - bottom-k: the `size` smallest hashes are kept,
+ *   - fractional: only hashes below `scale * 2^32` are kept.
+ *
+ * Labels are hashed again with the MurmurHash3 finalizer, so that labels
+ * assigned by the dictionary or taken from the representation of short cores
+ * are spread uniformly.
+ *
+ * `parse` sketches a sequence through a `pipeline`, so the cores of the level
+ * are never materialized: memory is bounded by the pipeline buffers and the
+ * sketch, not by the length of the sequence.
+ *
+ * Example usage:
+ * @code
+ *   lcp::sketch first(1000), second(1000);
+ *   first.parse(sequence1, 4);
+ *   second.parse(sequence2, 4);
+ *   double similarity = first.jaccard(second);
+ * @endcode
+ *
+ * @see pipeline.h
+ *
+ * @namespace lcp
+ * @struct sketch
+ *
+ * @note Hashes added with `add` are only visible to queries after `finish`.
+ *
+ */
+
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include "constant.h"
+#include "core_array.h"
+#include "lps.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define SKETCH_MAGIC            "LCPS"
+#define SKETCH_VERSION          1
+
+namespace lcp {
+
+	struct sketch {
+	  public:
+		int level;
+
+		// How the sketched labels were computed, see `lcpt::labelling`
+		uint16_t label_flags;
+
+		size_t capacity;
+		uint64_t threshold;
+		std::vector<uint32_t> hashes;
+
+		/**
+		 * @brief Constructs an empty sketch.
+		 *
+		 * @param size The number of hashes kept, 0 to keep every hash below the threshold.
+		 * @param scale The fraction of the hash space kept (default is 1, all hashes).
+		 */
+		sketch(size_t size = SKETCH_SIZE, double scale = 1.0);
+
+		/**
+		 * @brief Adds a label to the sketch.
+		 *
+		 * The label is taken to be computed as `label_flags` tells.
+		 *
+		 * @param label The label of a core.
+		 */
+		void add(ulabel label);
+
+		/**
+		 * @brief Adds the labels of the cores of an `lps` object and finishes the sketch.
+		 *
+		 * @param lps_obj The parsed sequence.
+		 * @throws std::invalid_argument if the sketch holds labels computed differently.
+		 */
+		void add(const lps &lps_obj);
+
+		/**
+		 * @brief Adds the labels of a `core_array` and finishes the sketch.
+		 *
+		 * @param cores The parsed sequence.
+		 * @throws std::invalid_argument if the sketch holds labels computed differently.
+		 */
+		void add(const core_array &cores);
+
+		/**
+		 * @brief Sketches the cores of the given level of a sequence without storing them.
+		 *
+		 * The labels are added to the sketch, so that the records of an assembly can be
+		 * sketched one after another.
+		 *
+		 * @param begin Pointer to the first character of the sequence.
+		 * @param end Pointer past the last character of the sequence.
+		 * @param lcp_level The level of the sketched cores.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 * @throws std::invalid_argument if the sketch holds labels computed differently.
+		 */
+		void parse(const char *begin, const char *end, int lcp_level, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Sketches the cores of the given level of a sequence without storing them.
+		 *
+		 * @param str The input sequence.
+		 * @param lcp_level The level of the sketched cores.
+		 * @param use_map Whether to use the label dictionary (default is false).
+		 */
+		void parse(const std::string &str, int lcp_level, bool use_map = LCP_USE_MAP);
+
+		/**
+		 * @brief Sorts the added hashes and drops the ones that are not kept.
+		 */
+		void finish();
+
+		/**
+		 * @brief Estimates the Jaccard similarity of the label sets of two sketched sequences.
+		 *
+		 * Both sketches are compared below the smaller of their largest possible hashes,
+		 * so sketches of different sizes and scales can be compared.
+		 *
+		 * @param other The other sketch.
+		 * @return The estimated similarity, 0 if both sketches are empty.
+		 * @throws std::invalid_argument if the labels of the sketches were computed differently.
+		 */
+		double jaccard(const sketch &other) const;
+
+		/**
+		 * @brief Estimates the fraction of the labels of this sequence contained in the other one.
+		 *
+		 * @param other The other sketch.
+		 * @return The estimated containment, 0 if this sketch is empty.
+		 * @throws std::invalid_argument if the labels of the sketches were computed differently.
+		 */
+		double containment(const sketch &other) const;
+
+		/**
+		 * @brief Removes every hash, keeping the size and the scale.
+		 */
+		void clear();
+
+		/**
+		 * @brief Writes the sketch to a file.
+		 *
+		 * @param out The output file stream.
+		 */
+		void write(std::ofstream &out) const;
+
+		/**
+		 * @brief Reads a sketch written by `write`.
+		 *
+		 * @param in The input file stream.
+		 * @return True if a valid sketch was read.
+		 */
+		bool read(std::ifstream &in);
+
+		/**
+		 * @brief Returns the number of hashes in the sketch.
+		 */
+		inline size_t size() const {
+			return this->hashes.size();
+		};
+
+	  private:
+		size_t sorted;
+
+		/**
+		 * @brief Takes over the label flags of added labels, unless labels computed differently are held.
+		 */
+		void labelled(uint16_t label_flags);
+
+		/**
+		 * @brief Counts the hashes of the union and the intersection below the comparable limit.
+		 */
+		void compare(const sketch &other, size_t &union_count, size_t &shared_count, size_t &own_count) const;
+
+		/**
+		 * @brief Returns the largest hash the sketch could hold.
+		 */
+		uint64_t limit() const;
+	};
+
+}; // namespace lcp
+
+#endif
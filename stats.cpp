@@ -0,0 +1,304 @@
+#include "stats.h"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace lcp {
+
+	namespace stats {
+
+		std::atomic<bool> active(false);
+
+		struct live_counters;
+
+		/**
+		 * @brief Counters of the live threads, and the sum of the counters of finished threads.
+		 */
+		struct registry {
+			std::mutex mutex;
+			std::vector<struct live_counters *> live;
+			struct counters retired;
+
+			registry() {
+				memset(&this->retired, 0, sizeof(this->retired));
+			};
+		};
+
+		static struct registry &get_registry() {
+			static struct registry instance;
+			return instance;
+		};
+
+		/**
+		 * @brief Counters of a live thread, updated by the thread while other threads read or reset them.
+		 *
+		 * Every field is atomic and accessed with relaxed ordering, which compiles to plain loads and
+		 * stores besides the increments, so totals taken while parsing are approximate but well defined.
+		 */
+		struct live_level {
+			std::atomic<uint64_t> cores;
+			std::atomic<uint64_t> runs;
+			std::atomic<uint64_t> lmin;
+			std::atomic<uint64_t> lmax;
+			std::atomic<uint64_t> sseq;
+			std::atomic<uint64_t> parse_ns;
+			std::atomic<uint64_t> dct_ns;
+			std::atomic<uint64_t> bytes;
+		};
+
+		struct live_dictionary {
+			std::atomic<uint64_t> lookups;
+			std::atomic<uint64_t> inserts;
+			std::atomic<uint64_t> probes;
+			std::atomic<uint64_t> max_probe;
+			std::atomic<uint64_t> lock_waits;
+			std::atomic<uint64_t> lock_wait_ns;
+		};
+
+		struct live_counters {
+			struct live_level levels[STATS_LEVEL_COUNT];
+			struct live_dictionary maps[2];
+		};
+
+		static inline void add(std::atomic<uint64_t> &counter, uint64_t value) {
+			counter.fetch_add(value, std::memory_order_relaxed);
+		};
+
+		static inline uint64_t get(const std::atomic<uint64_t> &counter) {
+			return counter.load(std::memory_order_relaxed);
+		};
+
+		static inline void zero(std::atomic<uint64_t> &counter) {
+			counter.store(0, std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Adds the counters of a live thread to a snapshot.
+		 */
+		static void merge(struct counters &lhs, const struct live_counters &rhs) {
+			for (size_t index = 0; index < STATS_LEVEL_COUNT; index++) {
+				struct level &curr = lhs.levels[index];
+				const struct live_level &other = rhs.levels[index];
+
+				curr.cores += get(other.cores);
+				curr.runs += get(other.runs);
+				curr.lmin += get(other.lmin);
+				curr.lmax += get(other.lmax);
+				curr.sseq += get(other.sseq);
+				curr.parse_ns += get(other.parse_ns);
+				curr.dct_ns += get(other.dct_ns);
+				curr.bytes += get(other.bytes);
+			}
+
+			for (size_t index = 0; index < 2; index++) {
+				struct dictionary &curr = lhs.maps[index];
+				const struct live_dictionary &other = rhs.maps[index];
+
+				curr.lookups += get(other.lookups);
+				curr.inserts += get(other.inserts);
+				curr.probes += get(other.probes);
+				curr.max_probe = std::max(curr.max_probe, get(other.max_probe));
+				curr.lock_waits += get(other.lock_waits);
+				curr.lock_wait_ns += get(other.lock_wait_ns);
+			}
+		};
+
+		static void clear(struct live_counters &counts) {
+			for (size_t index = 0; index < STATS_LEVEL_COUNT; index++) {
+				struct live_level &curr = counts.levels[index];
+
+				zero(curr.cores);
+				zero(curr.runs);
+				zero(curr.lmin);
+				zero(curr.lmax);
+				zero(curr.sseq);
+				zero(curr.parse_ns);
+				zero(curr.dct_ns);
+				zero(curr.bytes);
+			}
+
+			for (size_t index = 0; index < 2; index++) {
+				struct live_dictionary &curr = counts.maps[index];
+
+				zero(curr.lookups);
+				zero(curr.inserts);
+				zero(curr.probes);
+				zero(curr.max_probe);
+				zero(curr.lock_waits);
+				zero(curr.lock_wait_ns);
+			}
+		};
+
+		/**
+		 * @brief Counters of a thread, registered while the thread is alive.
+		 */
+		struct slot {
+			struct live_counters data;
+			int current;
+
+			slot() {
+				clear(this->data);
+				this->current = 0;
+
+				struct registry &reg = get_registry();
+				std::lock_guard<std::mutex> lock(reg.mutex);
+				reg.live.push_back(&this->data);
+			};
+
+			~slot() {
+				struct registry &reg = get_registry();
+				std::lock_guard<std::mutex> lock(reg.mutex);
+				merge(reg.retired, this->data);
+				reg.live.erase(std::find(reg.live.begin(), reg.live.end(), &this->data));
+			};
+		};
+
+		static struct slot &get_slot() {
+			// the registry is created first so that it outlives every slot
+			get_registry();
+			thread_local struct slot instance;
+			return instance;
+		};
+
+		static inline int clamp(int level) {
+			return level < 0 ? 0 : (level < STATS_LEVEL_COUNT ? level : STATS_LEVEL_COUNT - 1);
+		};
+
+		void enable(bool on) {
+			active.store(on, std::memory_order_relaxed);
+		};
+
+		void reset() {
+			struct registry &reg = get_registry();
+			std::lock_guard<std::mutex> lock(reg.mutex);
+
+			memset(&reg.retired, 0, sizeof(reg.retired));
+			for (std::vector<struct live_counters *>::iterator it = reg.live.begin(); it != reg.live.end(); it++) {
+				clear(**it);
+			}
+		};
+
+		struct counters local() {
+			struct counters result;
+			memset(&result, 0, sizeof(result));
+			merge(result, get_slot().data);
+
+			return result;
+		};
+
+		struct counters total() {
+			struct registry &reg = get_registry();
+			std::lock_guard<std::mutex> lock(reg.mutex);
+
+			struct counters result = reg.retired;
+			for (std::vector<struct live_counters *>::const_iterator it = reg.live.begin(); it != reg.live.end(); it++) {
+				merge(result, **it);
+			}
+
+			return result;
+		};
+
+		void print(std::ostream &out) {
+			struct counters counts = total();
+
+			out << "level\tcores\truns\tlmin\tlmax\tsseq\tdct_ms\tparse_ms\tbytes\n";
+
+			for (size_t index = 0; index < STATS_LEVEL_COUNT; index++) {
+				const struct level &curr = counts.levels[index];
+
+				if (curr.cores == 0 && curr.parse_ns == 0 && curr.dct_ns == 0) {
+					continue;
+				}
+
+				out << index << '\t' << curr.cores << '\t' << curr.runs << '\t' << curr.lmin << '\t' << curr.lmax << '\t' << curr.sseq << '\t'
+					<< std::fixed << std::setprecision(3) << curr.dct_ns / 1e6 << '\t' << curr.parse_ns / 1e6 << '\t' << curr.bytes << '\n';
+			}
+
+			const char *names[] = {"str_map", "cores_map"};
+
+			out << "map\tlookups\tinserts\tmean_probe\tmax_probe\tlock_waits\tlock_wait_ms\n";
+
+			for (size_t index = 0; index < 2; index++) {
+				const struct dictionary &curr = counts.maps[index];
+
+				out << names[index] << '\t' << curr.lookups << '\t' << curr.inserts << '\t'
+					<< std::fixed << std::setprecision(3) << (curr.lookups ? static_cast<double>(curr.probes) / curr.lookups : 0) << '\t'
+					<< curr.max_probe << '\t' << curr.lock_waits << '\t' << curr.lock_wait_ns / 1e6 << '\n';
+			}
+		};
+
+		void count_rules(uint64_t runs, uint64_t lmin, uint64_t lmax, uint64_t sseq) {
+			struct slot &curr = get_slot();
+			struct live_level &lvl = curr.data.levels[curr.current];
+
+			add(lvl.runs, runs);
+			add(lvl.lmin, lmin);
+			add(lvl.lmax, lmax);
+			add(lvl.sseq, sseq);
+			add(lvl.cores, runs + lmin + lmax + sseq);
+		};
+
+		void count_bytes(int level, uint64_t bytes) {
+			add(get_slot().data.levels[clamp(level)].bytes, bytes);
+		};
+
+		void count_lookup(int index, uint64_t probes, bool inserted, bool waited, uint64_t wait_ns) {
+			struct live_dictionary &curr = get_slot().data.maps[index];
+
+			add(curr.lookups, 1);
+			add(curr.inserts, inserted);
+			add(curr.probes, probes);
+			add(curr.lock_waits, waited);
+			add(curr.lock_wait_ns, wait_ns);
+
+			// only the owning thread raises the maximum, a reset meanwhile may keep the old one
+			if (get(curr.max_probe) < probes) {
+				curr.max_probe.store(probes, std::memory_order_relaxed);
+			}
+		};
+
+		stage::stage(int level, enum timer kind) {
+			this->on = enabled();
+
+			if (!this->on) {
+				return;
+			}
+
+			struct slot &curr = get_slot();
+
+			this->level = clamp(level);
+			this->previous = curr.current;
+			this->kind = kind;
+			this->begin = now();
+
+			curr.current = this->level;
+		};
+
+		stage::~stage() {
+			this->stop();
+		};
+
+		void stage::stop() {
+			if (!this->on) {
+				return;
+			}
+
+			this->on = false;
+
+			struct slot &curr = get_slot();
+			uint64_t elapsed = now() - this->begin;
+
+			if (this->kind == PARSE_TIME) {
+				add(curr.data.levels[this->level].parse_ns, elapsed);
+			} else {
+				add(curr.data.levels[this->level].dct_ns, elapsed);
+			}
+
+			curr.current = this->previous;
+		};
+
+	}; // namespace stats
+
+}; // namespace lcp
@@ -0,0 +1,191 @@
+/**
+ * @file stats.h
+ * @brief Opt-in counters and timers of the parsing stages.
+ *
+ * Instrumentation is disabled by default and is switched on at runtime with
+ * `stats::enable()`, without rebuilding against the STATS library. Every thread
+ * counts into its own counters, which are summed up by `stats::total()`; the
+ * counters of finished threads are kept. While disabled, a parse only pays for
+ * a flag check per level and per dictionary insertion.
+ *
+ * The following are counted for every level:
+ *   - the cores emitted and which rule produced them (runs, LMIN, LMAX and the
+ *     SSEQ cores filling gaps between them),
+ *   - the time spent compressing the level below (DCT) and parsing the level,
+ *   - the bytes held by the cores of the level, as reported by `memsize()` of
+ *     `lps` and `core_array`.
+ *
+ * The label dictionaries are counted separately: lookups, insertions, probe
+ * lengths and how often, and how long, a shard lock had to be waited for.
+ *
+ * Example usage:
+ * @code
+ *   lcp::stats::enable();
+ *   lcp::lps str(sequence);
+ *   str.deepen(5);
+ *
+ *   lcp::stats::counters counts = lcp::stats::total();
+ *   size_t cores = counts.levels[5].cores;
+ *   lcp::stats::print(std::cerr);
+ * @endcode
+ *
+ * @namespace lcp::stats
+ *
+ * @note Totals are exact once the threads that parsed are joined or idle. They
+ * can be queried, and counters reset, while parsing is in progress, the counts
+ * of running threads are then the ones of some moment meanwhile.
+ *
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "constant.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace lcp {
+
+	namespace stats {
+
+		enum timer { PARSE_TIME, DCT_TIME };
+
+		enum map { STR_MAP, CORES_MAP };
+
+		/**
+		 * @brief Counters of a single level.
+		 */
+		struct level {
+			uint64_t cores;
+			uint64_t runs;
+			uint64_t lmin;
+			uint64_t lmax;
+			uint64_t sseq;
+			uint64_t parse_ns;
+			uint64_t dct_ns;
+			uint64_t bytes;
+		};
+
+		/**
+		 * @brief Counters of a label dictionary.
+		 */
+		struct dictionary {
+			uint64_t lookups;
+			uint64_t inserts;
+			uint64_t probes;
+			uint64_t max_probe;
+			uint64_t lock_waits;
+			uint64_t lock_wait_ns;
+		};
+
+		/**
+		 * @brief Counters of every level and dictionary.
+		 *
+		 * Levels at or above `STATS_LEVEL_COUNT` are counted into the last level. Level 0
+		 * collects parses that are not run by `lps`, `core_array`, `pipeline` or `hierarchy`.
+		 */
+		struct counters {
+			struct level levels[STATS_LEVEL_COUNT];
+			struct dictionary maps[2];
+		};
+
+		extern std::atomic<bool> active;
+
+		/**
+		 * @brief Returns whether the counters are updated.
+		 */
+		inline bool enabled() {
+			return active.load(std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Returns a monotonic timestamp in nanoseconds.
+		 */
+		inline uint64_t now() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		};
+
+		/**
+		 * @brief Switches the instrumentation on or off, the counters are kept.
+		 *
+		 * @param on Whether the counters should be updated.
+		 */
+		void enable(bool on = true);
+
+		/**
+		 * @brief Sets the counters of every thread to zero.
+		 */
+		void reset();
+
+		/**
+		 * @brief Returns a copy of the counters of the calling thread.
+		 */
+		struct counters local();
+
+		/**
+		 * @brief Returns the sum of the counters of every thread.
+		 */
+		struct counters total();
+
+		/**
+		 * @brief Prints the totals of every level that emitted cores and of both dictionaries.
+		 *
+		 * @param out The stream to print to.
+		 */
+		void print(std::ostream &out);
+
+		/**
+		 * @brief Adds the rule hits of a parse to the level being parsed by the calling thread.
+		 */
+		void count_rules(uint64_t runs, uint64_t lmin, uint64_t lmax, uint64_t sseq);
+
+		/**
+		 * @brief Adds the bytes held by the cores of a level.
+		 */
+		void count_bytes(int level, uint64_t bytes);
+
+		/**
+		 * @brief Adds a dictionary lookup.
+		 *
+		 * @param index The dictionary, `STR_MAP` or `CORES_MAP`.
+		 * @param probes The number of slots visited.
+		 * @param inserted Whether the key was inserted.
+		 * @param waited Whether the shard lock was held by another thread.
+		 * @param wait_ns The time waited for the shard lock, 0 if it was free or not timed.
+		 */
+		void count_lookup(int index, uint64_t probes, bool inserted, bool waited, uint64_t wait_ns);
+
+		/**
+		 * @brief Attributes the parsing of the enclosing scope to a level and times it.
+		 *
+		 * Stages can be nested, the level of the outer stage is restored when the inner one ends.
+		 */
+		struct stage {
+		  public:
+			/**
+			 * @param level The level that is produced.
+			 * @param kind Whether the scope parses (`PARSE_TIME`) or compresses (`DCT_TIME`).
+			 */
+			stage(int level, enum timer kind);
+			~stage();
+
+			/**
+			 * @brief Ends the stage before the end of the scope.
+			 */
+			void stop();
+
+		  private:
+			bool on;
+			int level;
+			int previous;
+			enum timer kind;
+			uint64_t begin;
+		};
+
+	}; // namespace stats
+
+}; // namespace lcp
+
+#endif
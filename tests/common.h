@@ -0,0 +1,106 @@
+/**
+ * @file common.h
+ * @brief Deterministic inputs shared by the tests and the benchmarks.
+ *
+ * Every input is generated by the same linear congruential generator from a
+ * fixed seed, so a test or a benchmark sees the same data on every run.
+ *
+ * Example usage:
+ * @code
+ *   std::string sequence = generate_sequence(10000, 42);
+ *   std::string with_runs = generate_sequence(10000, 42, "ACGT", 64, 40);
+ *
+ *   lcg random(7);
+ *   size_t length = 100 + random.below(151);
+ * @endcode
+ *
+ * @struct lcg
+ *
+ */
+
+#ifndef TESTS_COMMON_H
+#define TESTS_COMMON_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+struct lcg {
+  public:
+	unsigned int seed;
+
+	explicit lcg(unsigned int seed) : seed(seed) {};
+
+	/**
+	 * @brief Advances the generator and returns its new state.
+	 */
+	inline unsigned int next() {
+		this->seed = this->seed * 1103515245 + 12345;
+		return this->seed;
+	};
+
+	/**
+	 * @brief Returns a value in [0, bound) taken from the high bits of the next state.
+	 */
+	inline unsigned int below(unsigned int bound) {
+		return (this->next() >> 16) % bound;
+	};
+};
+
+/**
+ * @brief Generates a pseudo-random sequence over an alphabet.
+ *
+ * @param length The number of characters drawn.
+ * @param seed The seed of the generator.
+ * @param alphabet (Optional) The characters drawn from. Defaults to "ACGT".
+ * @param run_period (Optional) If not 0, one in `run_period` characters on average is repeated.
+ * @param run_length (Optional) The number of copies of a repeated character.
+ * @return The sequence, longer than `length` if characters are repeated.
+ */
+inline std::string generate_sequence(size_t length, unsigned int seed, const char *alphabet = "ACGT", unsigned int run_period = 0, size_t run_length = 1) {
+
+	lcg random(seed);
+	const size_t alphabet_size = strlen(alphabet);
+
+	std::string sequence;
+	sequence.reserve(length);
+
+	for (size_t i = 0; i < length; i++) {
+		unsigned int state = random.next();
+		char c = alphabet[(state >> 16) % alphabet_size];
+		sequence.append(run_period != 0 && (state >> 8) % run_period == 0 ? run_length : 1, c);
+	}
+
+	return sequence;
+};
+
+/**
+ * @brief Generates a sequence of pseudo-random stretches, runs of 'A' and tandem repeats of "ACG".
+ *
+ * @param length The minimum length of the sequence.
+ * @param seed The seed of the generator.
+ * @return The sequence, less than 60000 characters longer than `length`.
+ */
+inline std::string generate_repeats(size_t length, unsigned int seed) {
+
+	lcg random(seed);
+	std::string sequence;
+
+	while (sequence.size() < length) {
+		size_t stretch = random.below(3000);
+
+		if (sequence.size() % 7 == 0) {
+			sequence.append(stretch, 'A');
+		} else if (sequence.size() % 7 == 1) {
+			for (size_t i = 0; i < stretch; i++) {
+				sequence.push_back("ACG"[i % 3]);
+			}
+		} else {
+			sequence += generate_sequence(20 * stretch, random.next());
+		}
+	}
+
+	return sequence;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "batch.h"
+#include "common.h"
+#include "core.h"
+#include "lcpt.h"
+#include "lps.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+std::vector<std::string> generate_reads(size_t count, unsigned int seed) {
+
+	// generate deterministic pseudo-random reads of 100 to 250 characters
+	lcg random(seed);
+	std::vector<std::string> reads(count);
+	for (size_t i = 0; i < count; i++) {
+		size_t length = 100 + random.below(151);
+		for (size_t j = 0; j < length; j++) {
+			reads[i].push_back("ACGT"[random.below(4)]);
+		}
+	}
+
+	return reads;
+};
+
+bool equal(const lcp::lps &lps_obj, const lcp::core_array &cores) {
+
+	if (lps_obj.size() != cores.size() || lps_obj.level != cores.level) {
+		return false;
+	}
+
+	for (size_t index = 0; index < cores.size(); index++) {
+		lcp::core temp = cores.get(index);
+		const lcp::core &other = (*lps_obj.cores)[index];
+
+		if (temp != other || temp.label != other.label) {
+			return false;
+		}
+	}
+
+	return true;
+};
+
+void test_batch_pool() {
+
+	lcp::parallel::pool threads(4);
+	std::vector<std::atomic<int>> counts(1000);
+
+	// the same pool runs several times
+	for (int round = 0; round < 5; round++) {
+		threads.run(counts.size(), [&](size_t index) { counts[index]++; });
+	}
+
+	for (size_t i = 0; i < counts.size(); i++) {
+		assert(counts[i] == 5 && "Every task should run once per round");
+	}
+
+	log("...  test_batch_pool passed!");
+};
+
+void test_batch_ordered() {
+
+	for (size_t thread_number = 1; thread_number <= 4; thread_number += 3) {
+
+		std::vector<size_t> emitted;
+		std::atomic<size_t> in_flight(0), max_in_flight(0);
+
+		{
+			// every task costs 10, so at most 3 are in flight
+			lcp::parallel::ordered<size_t, size_t> tasks(
+				thread_number, 30,
+				[&](size_t &task) {
+					size_t curr = ++in_flight;
+					size_t seen = max_in_flight;
+					while (seen < curr && !max_in_flight.compare_exchange_weak(seen, curr))
+						;
+					std::this_thread::sleep_for(std::chrono::microseconds((task * 7919) % 500));
+					in_flight--;
+					return task * task;
+				},
+				[&](size_t &result) { emitted.push_back(result); });
+
+			for (size_t task = 0; task < 200; task++) {
+				tasks.push(task, 10);
+			}
+		}
+
+		assert(emitted.size() == 200 && "Every result should be emitted");
+		for (size_t i = 0; i < emitted.size(); i++) {
+			assert(emitted[i] == i * i && "Results should be emitted in push order");
+		}
+		assert(max_in_flight <= 3 && "Tasks in flight should stay within the budget");
+	}
+
+	log("...  test_batch_ordered passed!");
+};
+
+void test_batch_process() {
+
+	lcp::encoding::init();
+
+	std::vector<std::string> reads = generate_reads(500, 42);
+
+	for (size_t thread_number = 1; thread_number <= 3; thread_number += 2) {
+
+		lcp::batch batch_obj(3, thread_number);
+		std::vector<char> matched(reads.size(), false);
+
+		// two batches reuse the same buffers
+		for (int round = 0; round < 2; round++) {
+
+			for (size_t i = 0; i < reads.size(); i++) {
+				batch_obj.push(reads[i]);
+			}
+
+			assert(batch_obj.size() == reads.size() && "Every read should be in the batch");
+
+			batch_obj.process([&](size_t index, const lcp::core_array &cores) {
+				lcp::lps lps_obj(reads[index].data(), reads[index].data() + reads[index].size());
+				lps_obj.deepen(3);
+				matched[index] = equal(lps_obj, cores);
+			});
+
+			batch_obj.clear();
+
+			for (size_t i = 0; i < reads.size(); i++) {
+				assert(matched[i] && "Batched cores should match the cores of lps");
+			}
+		}
+	}
+
+	log("...  test_batch_process passed!");
+};
+
+void test_batch_write() {
+
+	lcp::encoding::init();
+
+	std::vector<std::string> reads = generate_reads(300, 7);
+
+	std::string filename = "batch_test.lcpt";
+	std::ofstream outfile(filename, std::ios::binary);
+
+	lcp::batch batch_obj(2, 4);
+	for (size_t i = 0; i < reads.size(); i++) {
+		batch_obj.push(reads[i]);
+	}
+	batch_obj.write(outfile);
+	outfile.close();
+
+	{
+		lcp::lcpt::view file(filename);
+
+		assert(file.records.size() == reads.size() && "There should be one record per read");
+
+		// records are in the order of the reads
+		for (size_t i = 0; i < reads.size(); i++) {
+			lcp::lps lps_obj(reads[i].data(), reads[i].data() + reads[i].size());
+			lps_obj.deepen(2);
+
+			assert(lcp::core_array(file.records[i]).labels == lcp::core_array(*lps_obj.cores, lps_obj.level).labels && "Records should match the reads in order");
+		}
+	}
+
+	std::remove(filename.c_str());
+
+	log("...  test_batch_write passed!");
+};
+
+int main() {
+
+	log("Running test_batch...");
+
+	test_batch_pool();
+	test_batch_ordered();
+	test_batch_process();
+	test_batch_write();
+
+	log("All tests in test_batch completed successfully!");
+
+	return 0;
+}
@@ -0,0 +1,156 @@
+#include "common.h"
+#include "context.h"
+#include "encoding.h"
+#include "lps.h"
+#include "parallel.h"
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+std::vector<ulabel> labels(const lcp::lps &str) {
+	std::vector<ulabel> result;
+	for (std::vector<lcp::core>::const_iterator it = str.cores->begin(); it != str.cores->end(); it++) {
+		result.push_back(it->label);
+	}
+	return result;
+};
+
+void test_context_binding() {
+
+	lcp::encoding::init();
+
+	assert(&lcp::context::current() == &lcp::context::global() && "Threads should start in the global context");
+	assert(&lcp::alphabet[0] == &lcp::context::global().alphabet[0] && "Global tables should be the ones of the global context");
+
+	lcp::context first, second;
+	{
+		lcp::context::scope outer(first);
+		assert(&lcp::context::current() == &first && "Scope should bind the context");
+		{
+			lcp::context::scope inner(second);
+			assert(&lcp::context::current() == &second && "Scopes should nest");
+		}
+		assert(&lcp::context::current() == &first && "Leaving a scope should restore the previous context");
+	}
+	assert(&lcp::context::current() == &lcp::context::global() && "Leaving every scope should restore the global context");
+
+	// workers parse in the context of the thread handing out the tasks
+	{
+		lcp::context::scope bind(first);
+		std::vector<lcp::context *> seen(8, nullptr);
+		lcp::parallel::run(seen.size(), 4, [&](size_t index) { seen[index] = &lcp::context::current(); });
+
+		lcp::parallel::pool workers(3);
+		std::vector<lcp::context *> pooled(8, nullptr);
+		workers.run(pooled.size(), [&](size_t index) { pooled[index] = &lcp::context::current(); });
+
+		for (size_t i = 0; i < seen.size(); i++) {
+			assert(seen[i] == &first && pooled[i] == &first && "Workers should inherit the context");
+		}
+	}
+
+	log("...  test_context_binding passed!");
+};
+
+void test_context_alphabets() {
+
+	std::string sequence = generate_sequence(20000, 17);
+
+	lcp::encoding::init();
+	lcp::lps expected(sequence);
+	expected.deepen(3);
+
+	// a reversed alphabet in another context does not change the global one
+	lcp::context tenant;
+	{
+		lcp::context::scope bind(tenant);
+		std::map<char, int> map = {{'A', 3}, {'C', 2}, {'G', 1}, {'T', 0}};
+		std::map<char, int> rc_map = {{'A', 0}, {'C', 1}, {'G', 2}, {'T', 3}};
+		lcp::encoding::init(map, rc_map);
+
+		assert(lcp::context::current().alphabet['A'] == 3 && !lcp::context::current().dna_alphabet && "Bound context should get the custom alphabet");
+		assert(lcp::alphabet['A'] == 0 && lcp::dna_alphabet && "Global alphabet should be unchanged");
+	}
+
+	lcp::lps again(sequence);
+	again.deepen(3);
+	assert(again == expected && labels(again) == labels(expected) && "Global parse should not see the custom alphabet");
+
+	log("...  test_context_alphabets passed!");
+};
+
+void test_context_dictionaries() {
+
+	std::string sequence = generate_sequence(50000, 23);
+
+	lcp::encoding::init();
+	size_t global_size = lcp::hash::size;
+	ulabel global_id = lcp::hash::next_id;
+
+	// every context assigns IDs from 0, so serial parses in fresh contexts agree
+	std::vector<std::vector<ulabel>> results(4);
+	std::vector<std::thread> threads;
+
+	for (size_t thread_index = 0; thread_index < results.size(); thread_index++) {
+		threads.emplace_back([&, thread_index]() {
+			lcp::context tenant;
+			lcp::context::scope bind(tenant);
+			lcp::encoding::init();
+
+			lcp::lps str(sequence, true);
+			str.deepen(4, true);
+			results[thread_index] = labels(str);
+
+			assert(tenant.size > 0 && tenant.next_id == tenant.size && "Labels should be drawn from the bound context");
+		});
+	}
+
+	for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); it++) {
+		it->join();
+	}
+
+	for (size_t i = 1; i < results.size(); i++) {
+		assert(results[i] == results[0] && "Independent contexts should assign the same IDs");
+	}
+	assert(lcp::hash::size == global_size && lcp::hash::next_id == global_id && "Global dictionaries should be untouched");
+
+	// a cleared context starts over
+	lcp::context tenant;
+	{
+		lcp::context::scope bind(tenant);
+		lcp::encoding::init();
+
+		lcp::lps first(sequence, true);
+		first.deepen(4, true);
+		assert(labels(first) == results[0] && "Labels should match the other contexts");
+
+		tenant.clear();
+		assert(tenant.size == 0 && tenant.next_id == 0 && tenant.cores_map.capacity() == 0 && "Clear should free the dictionaries");
+
+		lcp::lps second(sequence, true);
+		second.deepen(4, true);
+		assert(labels(second) == results[0] && "A cleared context should assign the same IDs again");
+	}
+
+	log("...  test_context_dictionaries passed!");
+};
+
+int main() {
+
+	log("Running test_context...");
+
+	test_context_binding();
+	test_context_alphabets();
+	test_context_dictionaries();
+
+	log("All tests in test_context completed successfully!");
+
+	return 0;
+};
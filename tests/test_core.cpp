@@ -1,4 +1,6 @@
+#include "common.h"
 #include "core.h"
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
@@ -43,6 +45,100 @@ void test_core_compress() {
 	log("...  test_core_compress passed!");
 };
 
+// bit by bit reference of the DCT representation, reading bit i from the right
+ublock reference_rep(const std::vector<ublock> &rep, ubit_size bit_size, const std::vector<ublock> &other, ubit_size other_bit_size) {
+
+	auto bit = [](const std::vector<ublock> &blocks, ubit_size size, ubit_size i) -> ublock {
+		size_t block = (size - 1) / UBLOCK_BIT_SIZE - i / UBLOCK_BIT_SIZE;
+		return block < blocks.size() && i < ((size - 1) / UBLOCK_BIT_SIZE + 1) * UBLOCK_BIT_SIZE ? (blocks[block] >> (i % UBLOCK_BIT_SIZE)) & 1 : 0;
+	};
+
+	ubit_size size = std::min(bit_size, other_bit_size), i = 0;
+	while (i < size && bit(rep, bit_size, i) == bit(other, other_bit_size, i)) {
+		i++;
+	}
+
+	return 2 * static_cast<ublock>(i) + bit(rep, bit_size, i);
+};
+
+void test_core_compress_kernel() {
+
+	lcg generator(3);
+	auto random = [&generator]() {
+		return generator.next() >> 8;
+	};
+
+	// random sequences sharing a random number of trailing bits
+	for (size_t round = 0; round < 20000; round++) {
+		ubit_size bit_size = 1 + random() % (3 * UBLOCK_BIT_SIZE), other_bit_size = 1 + random() % (3 * UBLOCK_BIT_SIZE);
+		if (round % 4 == 0) {
+			other_bit_size = bit_size;
+		}
+
+		std::vector<ublock> rep((bit_size - 1) / UBLOCK_BIT_SIZE + 1), other((other_bit_size - 1) / UBLOCK_BIT_SIZE + 1);
+		for (size_t i = 0; i < rep.size(); i++) {
+			rep[i] = static_cast<ublock>(random()) << (UBLOCK_BIT_SIZE - 24) ^ random();
+		}
+		for (size_t i = 0; i < other.size(); i++) {
+			other[i] = static_cast<ublock>(random()) << (UBLOCK_BIT_SIZE - 24) ^ random();
+		}
+
+		// copy shared trailing bits from the right
+		ubit_size shared = random() % (std::min(bit_size, other_bit_size) + 1);
+		for (ubit_size i = 0; i < shared; i++) {
+			ublock mask = static_cast<ublock>(1) << (i % UBLOCK_BIT_SIZE);
+			ublock &target = other[other.size() - 1 - i / UBLOCK_BIT_SIZE];
+			target = (target & ~mask) | (rep[rep.size() - 1 - i / UBLOCK_BIT_SIZE] & mask);
+		}
+
+		// unused bits of the highest block are zero
+		if (bit_size % UBLOCK_BIT_SIZE) {
+			rep[0] &= (static_cast<ublock>(1) << (bit_size % UBLOCK_BIT_SIZE)) - 1;
+		}
+		if (other_bit_size % UBLOCK_BIT_SIZE) {
+			other[0] &= (static_cast<ublock>(1) << (other_bit_size % UBLOCK_BIT_SIZE)) - 1;
+		}
+
+		ublock result;
+		ubit_size result_size = lcp::compress_rep(rep.data(), bit_size, other.data(), other_bit_size, result);
+		ublock expected = reference_rep(rep, bit_size, other, other_bit_size);
+
+		assert(result == expected && "Compressed representation should match the bit by bit reference");
+		assert((result_size == 2 || (result >> (result_size - 1)) == 1) && 2 <= result_size && "Bit length should match the representation");
+	}
+
+	// batch form matches pairwise compression, also in place
+	std::vector<ublock> reps(1000);
+	std::vector<ubit_size> sizes(reps.size());
+	for (size_t index = 0; index < reps.size(); index++) {
+		sizes[index] = 1 + random() % UBLOCK_BIT_SIZE;
+		reps[index] = index % 7 == 0 && index ? reps[index - 1] : static_cast<ublock>(random()) << (UBLOCK_BIT_SIZE - 24) ^ random();
+		if (index % 7 == 0) {
+			sizes[index] = UBLOCK_BIT_SIZE;
+		}
+		if (sizes[index] < UBLOCK_BIT_SIZE) {
+			reps[index] &= (static_cast<ublock>(1) << sizes[index]) - 1;
+		}
+	}
+
+	std::vector<ublock> results(reps.size());
+	std::vector<ubit_size> result_sizes(reps.size());
+	lcp::compress_reps(reps.data(), sizes.data(), reps.size(), results.data(), result_sizes.data());
+
+	for (size_t index = 1; index < reps.size(); index++) {
+		ublock expected;
+		ubit_size expected_size = lcp::compress_rep(&reps[index], sizes[index], &reps[index - 1], sizes[index - 1], expected);
+		assert(results[index] == expected && result_sizes[index] == expected_size && "Batch compression should match compress_rep");
+	}
+
+	lcp::compress_reps(reps.data(), sizes.data(), reps.size(), reps.data(), sizes.data());
+	for (size_t index = 1; index < reps.size(); index++) {
+		assert(reps[index] == results[index] && sizes[index] == result_sizes[index] && "In place batch compression should match");
+	}
+
+	log("...  test_core_compress_kernel passed!");
+};
+
 void test_core_file_io() {
 
 	// create a core object and write it to a file
@@ -92,13 +188,102 @@ void test_core_operator_overloads() {
 	log("...  test_core_operator_overloads passed!");
 };
 
+void test_core_compare() {
+
+	// cores of the same bit size are ordered by their blocks, from the most significant one
+	for (ubit_size bit_size : {ubit_size(30), ubit_size(60), ubit_size(100), ubit_size(200)}) {
+		size_t block_number = (bit_size + UBLOCK_BIT_SIZE - 1) / UBLOCK_BIT_SIZE;
+
+		std::vector<lcp::core> cores;
+		for (size_t variant = 0; variant < 4; variant++) {
+			ublock *rep = new ublock[block_number]();
+			// variants differ in the most and the least significant blocks
+			rep[0] = (variant / 2 + 1) << 2;
+			rep[block_number - 1] |= variant % 2;
+			cores.emplace_back(bit_size, rep, variant, 0, 0);
+		}
+
+		for (size_t i = 0; i < cores.size(); i++) {
+			for (size_t j = 0; j < cores.size(); j++) {
+				int expected = i < j ? -1 : (i == j ? 0 : 1);
+				int result = lcp::compare(cores[i], cores[j]);
+				assert((result < 0) == (expected < 0) && (result == 0) == (expected == 0) && "Three-way comparison should order by blocks");
+				assert((cores[i] < cores[j]) == (expected < 0) && (cores[i] > cores[j]) == (expected > 0) && "Operators should agree with the three-way comparison");
+				assert((cores[i] <= cores[j]) == (expected <= 0) && (cores[i] >= cores[j]) == (expected >= 0) && "Operators should agree with the three-way comparison");
+				assert((cores[i] == cores[j]) == (expected == 0) && (cores[i] != cores[j]) == (expected != 0) && "Operators should agree with the three-way comparison");
+			}
+		}
+	}
+
+	// shorter cores come first regardless of their blocks
+	lcp::core small(3, new ublock[1]{0b111}, 0, 0, 0);
+	lcp::core large(4, new ublock[1]{0b0001}, 0, 0, 0);
+	assert(lcp::compare(small, large) < 0 && lcp::compare(large, small) > 0 && "Bit size should be compared first");
+
+	log("...  test_core_compare passed!");
+};
+
+void test_core_copy_and_move() {
+
+	// single block representations are stored inline
+	ublock *p1 = new ublock[1];
+	p1[0] = 0b1011;
+	lcp::core core1(4, p1, 3, 1, 5);
+	assert(core1.is_inline() && "Single block core should be stored inline");
+
+	// multi block representations are stored on heap
+	ublock *p2 = new ublock[2];
+	p2[0] = 0b11;
+	p2[1] = 0b1010;
+	lcp::core core2(UBLOCK_BIT_SIZE + 2, p2, 4, 2, 40);
+	assert(!core2.is_inline() && "Multi block core should be stored on heap");
+
+	// copies are deep
+	lcp::core core3(core2);
+	assert(core3 == core2 && "Copied core should be equal to its source");
+	assert(core3.bit_rep != core2.bit_rep && "Copied core should own its representation");
+	assert(core3.label == 4 && core3.start == 2 && core3.end == 40 && "Copied core should keep metadata");
+
+	core3 = core1;
+	assert(core3 == core1 && core3.is_inline() && "Assigned core should be equal to its source");
+	assert(core3.label == 3 && "Assigned core should keep label");
+
+	// moves take over the representation
+	ublock *rep = core2.bit_rep;
+	lcp::core core4(std::move(core2));
+	assert(core4.bit_rep == rep && "Moved core should take over the representation");
+	assert(core2.bit_rep == nullptr && core2.bit_size == 0 && "Moved-from core should be empty");
+
+	lcp::core core5(std::move(core1));
+	assert(core5.is_inline() && core5.bit_rep[0] == 0b1011 && "Inline core should be moved by value");
+
+	core5 = std::move(core4);
+	assert(core5.bit_rep == rep && core5.label == 4 && "Move assigned core should take over the representation");
+
+	// vector reallocation keeps representations intact
+	std::vector<lcp::core> cores;
+	for (ublock i = 0; i < 100; i++) {
+		ublock *p = new ublock[1];
+		p[0] = i;
+		cores.emplace_back(UBLOCK_BIT_SIZE, p, i, i, i + 1);
+	}
+	for (ublock i = 0; i < 100; i++) {
+		assert(cores[i].is_inline() && cores[i].bit_rep[0] == i && "Cores should survive vector reallocation");
+	}
+
+	log("...  test_core_copy_and_move passed!");
+};
+
 int main() {
 	log("Running test_core...");
 
 	test_core_constructors();
 	test_core_compress();
+	test_core_compress_kernel();
 	test_core_file_io();
 	test_core_operator_overloads();
+	test_core_compare();
+	test_core_copy_and_move();
 
 	log("All tests in test_core completed successfully!");
 
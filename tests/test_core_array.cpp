@@ -0,0 +1,204 @@
+#include "common.h"
+#include "core.h"
+#include "core_array.h"
+#include "lps.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+// pseudo-random sequence with runs long enough to need more than one block
+std::string generate_runs(size_t length) {
+	return generate_sequence(length, 42, "ACGT", 64, 40);
+};
+
+bool equal(const lcp::lps &lps_obj, const lcp::core_array &array) {
+
+	if (lps_obj.size() != array.size() || lps_obj.level != array.level) {
+		return false;
+	}
+
+	for (size_t index = 0; index < array.size(); index++) {
+		lcp::core temp = array.get(index);
+		const lcp::core &other = (*lps_obj.cores)[index];
+
+		if (temp != other || temp.label != other.label || temp.start != other.start || temp.end != other.end) {
+			return false;
+		}
+	}
+
+	return true;
+};
+
+void test_core_array_parse() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_runs(20000);
+
+	// labels hashed in batches match the ones hashed core by core, with both functions
+	const lcp::hash::backend backends[] = {lcp::hash::MURMUR, lcp::hash::MIX};
+	for (lcp::hash::backend curr : backends) {
+		lcp::hash::set_backend(curr);
+
+		lcp::lps lps_obj(test_string);
+		lcp::core_array array(test_string, false, true);
+
+		assert(!array.offsets.empty() && "Runs should produce cores spanning multiple blocks");
+		assert(equal(lps_obj, array) && "Level 1 cores should match the lps cores");
+
+		for (int level = 2; level <= 4; level++) {
+			lps_obj.deepen(level);
+			array.deepen(level);
+
+			assert(equal(lps_obj, array) && array.pending.empty() && "Deepened cores should match the lps cores");
+		}
+
+		assert(array.blocks.size() == (array.offsets.empty() ? array.size() : array.offsets.back()) && "Blocks should be compacted after deepening");
+	}
+
+	lcp::hash::set_backend(LCP_HASH_BACKEND);
+
+	log("...  test_core_array_parse passed!");
+};
+
+void test_core_array_conversion() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_runs(5000);
+
+	lcp::lps lps_obj(test_string);
+	lps_obj.deepen(2);
+
+	lcp::core_array array(*lps_obj.cores, lps_obj.level);
+
+	assert(equal(lps_obj, array) && "Converted cores should match the lps cores");
+
+	std::vector<ulabel> lps_labels, array_labels;
+	lps_obj.get_labels(lps_labels);
+	array.get_labels(array_labels);
+
+	assert(lps_labels == array_labels && "Labels should match");
+
+	lps_obj.deepen(3);
+	array.deepen(3);
+
+	assert(equal(lps_obj, array) && "Converted cores should deepen like the lps cores");
+
+	log("...  test_core_array_conversion passed!");
+};
+
+void test_core_array_empty() {
+
+	lcp::encoding::init();
+
+	std::string test_string = "ACG";
+	lcp::core_array array(test_string);
+
+	assert(array.size() == 0 && "Short sequences should not produce cores");
+	array.deepen(2);
+
+	assert(array.size() == 0 && array.level == 1 && "Empty arrays can not be deepened");
+
+	log("...  test_core_array_empty passed!");
+};
+
+void test_core_array_update() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_runs(30000);
+	lcg random(7);
+
+	for (int level = 1; level <= 4; level++) {
+
+		lcp::core_array array(test_string, false, true);
+		array.deepen(level);
+
+		for (size_t edit = 0; edit < 12; edit++) {
+
+			unsigned int seed = random.next();
+
+			// substitutions, insertions and deletions, some of them at the ends of the sequence
+			size_t position = edit % 6 == 0 ? (seed >> 16) % 4 : edit % 6 == 1 ? test_string.size() - 1 - (seed >> 16) % 4 : (seed >> 8) % test_string.size();
+			size_t removed = edit % 3 == 1 ? 0 : 1 + (seed >> 4) % 8;
+			std::string inserted = edit % 3 == 2 ? "" : std::string(1 + (seed >> 12) % 8, "ACGT"[seed % 4]);
+
+			removed = position + removed < test_string.size() ? removed : test_string.size() - position;
+			test_string.replace(position, removed, inserted);
+
+			bool local = array.update(test_string.data(), test_string.data() + test_string.size(), position, removed, inserted.size());
+
+			lcp::core_array expected(test_string, false, true);
+			expected.deepen(level);
+
+			assert(local && "Edits should be re-parsed locally");
+			assert(array.size() == expected.size() && array.level == expected.level && "Updated cores should match a rebuild");
+			assert(array.labels == expected.labels && array.blocks == expected.blocks && "Updated cores should match a rebuild");
+			assert(array.starts == expected.starts && array.ends == expected.ends && "Updated positions should match a rebuild");
+		}
+	}
+
+	// without positions the cores are rebuilt
+	lcp::core_array array(test_string);
+	array.deepen(3);
+	test_string[100] = test_string[100] == 'A' ? 'C' : 'A';
+
+	assert(!array.update(test_string.data(), test_string.data() + test_string.size(), 100, 1, 1) && "Arrays without positions should be rebuilt");
+
+	lcp::core_array expected(test_string);
+	expected.deepen(3);
+	assert(array.labels == expected.labels && "Rebuilt cores should match");
+
+	log("...  test_core_array_update passed!");
+};
+
+void test_core_array_parallel_deepen() {
+
+	lcp::encoding::init();
+
+	// runs and tandem repeats, large enough for parallel levels
+	std::string test_string = generate_repeats(2000000, 7);
+
+	for (bool positions : {true, false}) {
+		lcp::core_array serial(test_string, false, positions);
+		std::vector<lcp::core_array> parallel(3, serial);
+		const size_t thread_numbers[] = {2, 3, 8};
+
+		for (int level = 2; level <= 5; level++) {
+			serial.deepen(level);
+
+			for (size_t index = 0; index < 3; index++) {
+				lcp::core_array &array = parallel[index];
+				array.deepen(level, false, thread_numbers[index]);
+
+				assert(array.level == serial.level && array.size() == serial.size() && "Parallel deepening should reach the same level and size");
+				assert(array.labels == serial.labels && array.bit_sizes == serial.bit_sizes && "Labels should match the serial parse");
+				assert(array.blocks == serial.blocks && array.offsets == serial.offsets && "Representations should match the serial parse");
+				assert(array.starts == serial.starts && array.ends == serial.ends && "Positions should match the serial parse");
+			}
+		}
+	}
+
+	log("...  test_core_array_parallel_deepen passed!");
+};
+
+int main() {
+
+	log("Running test_core_array...");
+
+	test_core_array_parse();
+	test_core_array_conversion();
+	test_core_array_empty();
+	test_core_array_update();
+	test_core_array_parallel_deepen();
+
+	log("All tests in test_core_array completed successfully!");
+
+	return 0;
+}
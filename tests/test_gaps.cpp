@@ -0,0 +1,188 @@
+#include "common.h"
+#include "core_array.h"
+#include "encoding.h"
+#include "gaps.h"
+#include "lcpt.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+// reference: every segment parsed on its own and appended with its position shifted
+void check_segments(const lcp::core_array &cores, const std::string &sequence, const std::vector<lcp::gap> &gaps, int lcp_level) {
+
+	size_t index = 0, first = 0;
+
+	for (size_t g = 0; g <= gaps.size(); g++) {
+
+		size_t last = g < gaps.size() ? gaps[g].start : sequence.size();
+
+		lcp::core_array segment(sequence.data() + first, sequence.data() + last, LCP_USE_MAP, true);
+		segment.deepen(lcp_level);
+
+		if (g < gaps.size()) {
+			assert(cores.gaps[g].index == index + segment.size() && "Gap index should point to the first core after the gap");
+		}
+
+		for (size_t i = 0; i < segment.size(); i++, index++) {
+			lcp::core expected = segment.get(i), actual = cores.get(index);
+			assert(expected == actual && expected.label == actual.label && "Cores of a segment should match the segment parsed alone");
+			assert(expected.start + first == actual.start && expected.end + first == actual.end && "Positions should be shifted by the segment start");
+		}
+
+		if (g < gaps.size()) {
+			first = gaps[g].start + gaps[g].length;
+		}
+	}
+
+	assert(index == cores.size() && "Every core should belong to a segment");
+};
+
+void test_find_gaps() {
+
+	lcp::encoding::init();
+
+	std::string sequence = "ACGTNNNNNNNNNNNNNNNNNNNNACGTnNnNACGTN";
+	std::vector<lcp::gap> gaps;
+	size_t total = lcp::find_gaps(sequence.data(), sequence.data() + sequence.size(), gaps);
+
+	assert(gaps.size() == 3 && "Every run of N should be a gap");
+	assert(gaps[0].start == 4 && gaps[0].length == 20 && "Long runs should be measured exactly");
+	assert(gaps[1].start == 28 && gaps[1].length == 4 && "Runs of mixed case should be gaps");
+	assert(gaps[2].start == 36 && gaps[2].length == 1 && "A run at the end should be a gap");
+	assert(total == 25 && "The total gap length should be returned");
+
+	// other IUPAC codes only split the sequence in IUPAC mode
+	sequence = "ACGTRYNNACGTKacgt";
+	gaps.clear();
+	lcp::find_gaps(sequence.data(), sequence.data() + sequence.size(), gaps);
+	assert(gaps.size() == 1 && gaps[0].start == 6 && gaps[0].length == 2 && "Only N should be a gap by default");
+
+	gaps.clear();
+	lcp::find_gaps(sequence.data(), sequence.data() + sequence.size(), gaps, true);
+	assert(gaps.size() == 2 && "Every unknown character should be a gap in IUPAC mode");
+	assert(gaps[0].start == 4 && gaps[0].length == 4 && gaps[1].start == 12 && gaps[1].length == 1 && "IUPAC runs should be merged");
+
+	// short runs are parsed as usual
+	gaps.clear();
+	lcp::find_gaps(sequence.data(), sequence.data() + sequence.size(), gaps, true, 2);
+	assert(gaps.size() == 1 && gaps[0].start == 4 && "Runs shorter than the minimum should not be gaps");
+
+	log("...  test_find_gaps passed!");
+};
+
+void test_gapped_parse() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(20000, 7) + std::string(5000, 'N') + generate_sequence(30000, 11) + "NN" + generate_sequence(10000, 13);
+	std::vector<lcp::gap> gaps;
+	lcp::find_gaps(sequence.data(), sequence.data() + sequence.size(), gaps);
+	assert(gaps.size() == 2 && "Both runs should be found");
+
+	lcp::core_array cores(sequence.data(), sequence.data() + sequence.size(), gaps, LCP_USE_MAP, true);
+	check_segments(cores, sequence, gaps, 1);
+
+	for (int lcp_level = 2; lcp_level <= 4; lcp_level++) {
+		cores.deepen();
+		assert(cores.level == lcp_level && "Gapped cores should deepen level by level");
+		check_segments(cores, sequence, gaps, lcp_level);
+	}
+
+	// no core spans a gap
+	for (size_t i = 0; i < cores.size(); i++) {
+		lcp::core temp = cores.get(i);
+		for (size_t g = 0; g < gaps.size(); g++) {
+			assert((temp.end <= gaps[g].start || gaps[g].start + gaps[g].length <= temp.start) && "Cores should not span gaps");
+		}
+	}
+
+	log("...  test_gapped_parse passed!");
+};
+
+void test_soft_masked() {
+
+	lcp::encoding::init();
+
+	std::string upper = generate_sequence(20000, 3);
+	std::string lower = upper;
+	for (size_t i = 5000; i < 15000; i++) {
+		lower[i] = static_cast<char>(lower[i] | 0x20);
+	}
+
+	std::vector<lcp::gap> gaps;
+	lcp::find_gaps(lower.data(), lower.data() + lower.size(), gaps, true);
+	assert(gaps.empty() && "Soft-masked bases should not be gaps");
+
+	lcp::core_array first(upper), second(lower);
+	first.deepen(3);
+	second.deepen(3);
+
+	assert(first.size() == second.size() && "Soft-masked sequences should be parsed like uppercase ones");
+	for (size_t i = 0; i < first.size(); i++) {
+		assert(first.get(i) == second.get(i) && first.get(i).label == second.get(i).label && "Soft-masked cores should match");
+	}
+
+	log("...  test_soft_masked passed!");
+};
+
+void test_gaps_lcpt() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(10000, 5) + std::string(300, 'n') + generate_sequence(10000, 9);
+	std::vector<lcp::gap> gaps;
+	lcp::find_gaps(sequence.data(), sequence.data() + sequence.size(), gaps);
+
+	lcp::core_array cores(sequence.data(), sequence.data() + sequence.size(), gaps);
+	cores.deepen(3);
+
+	std::string filename = "gaps_test.lcpt";
+	std::ofstream outfile(filename, std::ios::binary);
+	cores.write(outfile, "chr1");
+	outfile.close();
+
+	{
+		std::ifstream infile(filename, std::ios::binary);
+		lcp::core_array other;
+		assert(other.read(infile) && "Gapped record should be read");
+		infile.close();
+
+		assert(other.size() == cores.size() && other.level == cores.level && "Read cores should match");
+		assert(other.gaps.size() == 1 && "Gaps should be read");
+		assert(other.gaps[0].start == cores.gaps[0].start && other.gaps[0].length == 300 && other.gaps[0].index == cores.gaps[0].index && "Read gaps should match");
+	}
+
+	{
+		lcp::lcpt::view file(filename);
+		assert(file.is_open() && file.records.size() == 1 && "Gapped record should be mapped");
+		assert(file.records[0].gap_count == 1 && file.records[0].gaps[0].index == cores.gaps[0].index && "Mapped gaps should match");
+
+		lcp::core_array other(file.records[0]);
+		assert(other.gaps.size() == 1 && other.size() == cores.size() && "Gaps should survive copying a mapped record");
+	}
+
+	std::remove(filename.c_str());
+
+	log("...  test_gaps_lcpt passed!");
+};
+
+int main() {
+
+	log("Running test_gaps...");
+
+	test_find_gaps();
+	test_gapped_parse();
+	test_soft_masked();
+	test_gaps_lcpt();
+
+	log("All tests in test_gaps completed successfully!");
+
+	return 0;
+};
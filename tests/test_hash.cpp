@@ -0,0 +1,178 @@
+#include "common.h"
+#include "hash.h"
+#include "lps.h"
+#include <cassert>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+void test_hash_emplace() {
+
+	lcp::encoding::init();
+
+	ulabel first[4] = {1, 2, 3, 4};
+	ulabel second[4] = {1, 2, 3, 5};
+
+	size_t initial_size = lcp::hash::size;
+	ulabel first_id = lcp::hash::emplace(first);
+	ulabel second_id = lcp::hash::emplace(second);
+
+	assert(first_id != second_id && "Distinct cores should get distinct IDs");
+	assert(lcp::hash::emplace(first) == first_id && "Same core should get the same ID");
+	assert(lcp::hash::size == initial_size + 2 && "Only new cores should increase the size");
+
+	// length two strings have no middle character, so it is not part of the key
+	ulabel short_a = (lcp::alphabet['A'] << (2 * lcp::alphabet_bit_size)) | (lcp::alphabet['C'] << lcp::alphabet_bit_size) | lcp::alphabet['G'];
+	ulabel short_b = (lcp::alphabet['A'] << (2 * lcp::alphabet_bit_size)) | (lcp::alphabet['T'] << lcp::alphabet_bit_size) | lcp::alphabet['G'];
+	ulabel long_a = short_a | (1 << (3 * lcp::alphabet_bit_size));
+	ulabel long_b = short_b | (1 << (3 * lcp::alphabet_bit_size));
+
+	assert(lcp::hash::emplace(short_a) == lcp::hash::emplace(short_b) && "Middle character of short strings should be ignored");
+	assert(lcp::hash::emplace(long_a) != lcp::hash::emplace(long_b) && "Middle character of long strings should be kept");
+
+	log("...  test_hash_emplace passed!");
+};
+
+void test_hash_concurrent_emplace() {
+
+	const size_t key_count = 20000, thread_count = 4;
+
+	size_t initial_size = lcp::hash::size;
+	std::vector<std::vector<ulabel>> ids(thread_count, std::vector<ulabel>(key_count));
+	std::vector<std::thread> threads;
+
+	// multipliers coprime with key_count, so that every thread visits every key
+	const size_t multipliers[thread_count] = {1, 3, 7, 9};
+
+	// every thread inserts the same keys in a different order
+	for (size_t thread_index = 0; thread_index < thread_count; thread_index++) {
+		threads.emplace_back([&, thread_index]() {
+			for (size_t i = 0; i < key_count; i++) {
+				size_t key_index = (i * multipliers[thread_index] + thread_index * 7919) % key_count;
+				ulabel data[4] = {static_cast<ulabel>(key_index), 7, 11, 13};
+				ids[thread_index][key_index] = lcp::hash::emplace(data);
+			}
+		});
+	}
+
+	for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); it++) {
+		it->join();
+	}
+
+	for (size_t thread_index = 1; thread_index < thread_count; thread_index++) {
+		assert(ids[thread_index] == ids[0] && "Every thread should see the same IDs");
+	}
+
+	std::set<ulabel> distinct(ids[0].begin(), ids[0].end());
+
+	assert(distinct.size() == key_count && "Distinct keys should get distinct IDs");
+	assert(lcp::hash::size == initial_size + key_count && "Every key should be inserted exactly once");
+
+	log("...  test_hash_concurrent_emplace passed!");
+};
+
+void test_hash_parallel_split() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_sequence(20000, 7);
+
+	lcp::lps serial_obj(test_string, 3, 2000, 200, 1, true);
+	lcp::lps parallel_obj(test_string, 3, 2000, 200, 4, true);
+
+	assert(serial_obj == parallel_obj && "Cores should match between serial and parallel split using the dictionary");
+
+	std::vector<ulabel> serial_labels, parallel_labels;
+	serial_obj.get_labels(serial_labels);
+	parallel_obj.get_labels(parallel_labels);
+
+	assert(serial_labels == parallel_labels && "Labels of an already filled dictionary should not change");
+
+	log("...  test_hash_parallel_split passed!");
+};
+
+void test_hash_backend() {
+
+	lcp::encoding::init();
+
+	assert(lcp::hash::get_backend() == LCP_HASH_BACKEND && "Build default should be selected");
+
+	// mixer labels are pinned so that they stay the same on every platform
+	ulabel data[4] = {1, 2, 3, 4};
+	lcp::hash::set_backend(lcp::hash::MIX);
+#ifdef LCP_64BIT
+	assert(lcp::hash::simple(data) == 0xfd41df7584ae5f76ULL && "Mixer labels should not change");
+#else
+	assert(lcp::hash::simple(data) == 0x349252c8U && "Mixer labels should not change");
+#endif
+	assert(lcp::hash::mum(0xfedcba9876543210ULL, 0x0123456789abcdefULL) == 0x2317228f48165bb2ULL && "Folded product should not change");
+
+	// batches are hashed the same as single arrays, by both functions
+	std::vector<ulabel> tuples;
+	lcg random(3);
+	for (size_t i = 0; i < 4 * 10000; i++) {
+		unsigned int seed = random.next();
+		tuples.push_back(i % 4 == 3 ? (seed >> 16) % 8 : seed);
+	}
+
+	const lcp::hash::backend backends[] = {lcp::hash::MURMUR, lcp::hash::MIX};
+	for (lcp::hash::backend curr : backends) {
+		lcp::hash::set_backend(curr);
+
+		std::vector<ulabel> labels(tuples.size() / 4);
+		lcp::hash::simple(tuples.data(), labels.size(), labels.data());
+
+		std::set<ulabel> distinct;
+		for (size_t i = 0; i < labels.size(); i++) {
+			assert(labels[i] == lcp::hash::simple(&tuples[4 * i]) && "Batch labels should match single labels");
+			distinct.insert(labels[i]);
+		}
+		assert(labels.size() <= distinct.size() + 1 && "Distinct arrays should rarely collide");
+	}
+
+	// the function changes labels above level 1, not the cores
+	std::string sequence(tuples.size(), 'A');
+	for (size_t i = 0; i < sequence.size(); i++) {
+		sequence[i] = "ACGT"[tuples[i] % 4];
+	}
+
+	lcp::hash::set_backend(lcp::hash::MURMUR);
+	lcp::lps murmur_obj(sequence);
+	murmur_obj.deepen(3);
+
+	lcp::hash::set_backend(lcp::hash::MIX);
+	lcp::lps mix_obj(sequence);
+	mix_obj.deepen(3);
+
+	std::vector<ulabel> murmur_labels, mix_labels;
+	murmur_obj.get_labels(murmur_labels);
+	mix_obj.get_labels(mix_labels);
+
+	assert(murmur_obj.size() == mix_obj.size() && murmur_labels != mix_labels && "Only the labels should differ");
+
+	lcp::hash::set_backend(LCP_HASH_BACKEND);
+
+	log("...  test_hash_backend passed!");
+};
+
+int main() {
+
+	log("Running test_hash...");
+
+	lcp::hash::init();
+
+	test_hash_emplace();
+	test_hash_concurrent_emplace();
+	test_hash_parallel_split();
+	test_hash_backend();
+
+	log("All tests in test_hash completed successfully!");
+
+	return 0;
+}
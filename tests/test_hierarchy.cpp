@@ -0,0 +1,97 @@
+#include "common.h"
+#include "core.h"
+#include "hierarchy.h"
+#include "lps.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+void test_hierarchy_levels() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_sequence(50000, 42);
+
+	lcp::hierarchy index(test_string, 5);
+
+	assert(index.level() == 5 && "Every level up to the target should be kept");
+
+	lcp::lps lps_obj(test_string);
+
+	for (int level = 1; level <= 5; level++) {
+		lps_obj.deepen(level);
+
+		const lcp::core_array &cores = index.at(level);
+
+		assert(cores.level == level && "Levels should be stored in order");
+		assert(cores.size() == lps_obj.size() && "Every level should have the cores of lps");
+
+		for (size_t i = 0; i < cores.size(); i++) {
+			assert(cores.labels[i] == (*lps_obj.cores)[i].label && "Labels should match the lps cores");
+
+			// positions found through the children match the positions tracked by STATS
+			std::pair<size_t, size_t> position = index.position(level, i);
+			assert(position.first == (*lps_obj.cores)[i].start && "Start should match the lps cores");
+			assert(position.second == (*lps_obj.cores)[i].end && "End should match the lps cores");
+		}
+	}
+
+	log("...  test_hierarchy_levels passed!");
+};
+
+void test_hierarchy_children() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_sequence(20000, 42);
+
+	lcp::hierarchy index(test_string.data(), test_string.data() + test_string.size());
+	index.deepen(3);
+
+	for (int level = 2; level <= index.level(); level++) {
+		size_t lower_size = index.at(level - 1).size();
+
+		for (size_t i = 0; i < index.at(level).size(); i++) {
+			std::pair<size_t, size_t> children = index.children(level, i);
+			assert(children.first < children.second && children.second <= lower_size && "Children should be in the level below");
+
+			// a core covers the characters from its first to its last child
+			assert(index.position(level, i).first == index.position(level - 1, children.first).first && "Core should start at its first child");
+			assert(index.position(level, i).second == index.position(level - 1, children.second - 1).second && "Core should end at its last child");
+		}
+	}
+
+	log("...  test_hierarchy_children passed!");
+};
+
+void test_hierarchy_short() {
+
+	lcp::encoding::init();
+
+	std::string test_string = "ACGTAC";
+
+	lcp::hierarchy index(test_string, 4);
+
+	assert(index.level() < 4 && "Short sequences should stop deepening");
+	assert(index.memsize() > 0 && "Memory size should be positive");
+
+	log("...  test_hierarchy_short passed!");
+};
+
+int main() {
+
+	log("Running test_hierarchy...");
+
+	test_hierarchy_levels();
+	test_hierarchy_children();
+	test_hierarchy_short();
+
+	log("All tests in test_hierarchy completed successfully!");
+
+	return 0;
+}
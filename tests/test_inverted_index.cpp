@@ -0,0 +1,228 @@
+#include "common.h"
+#include "core_array.h"
+#include "inverted_index.h"
+#include "lps.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+std::vector<lcp::lps *> generate_collection(const std::string &base) {
+
+	// sequences sharing prefixes of different lengths with the base sequence
+	std::vector<lcp::lps *> collection;
+	for (size_t i = 0; i < 7; i++) {
+		std::string sequence = base.substr(0, base.size() * i / 7) + generate_sequence(base.size() * (7 - i) / 7, 100 + i);
+		lcp::lps *lps_obj = new lcp::lps(sequence);
+		lps_obj->deepen(2);
+		collection.push_back(lps_obj);
+	}
+
+	return collection;
+};
+
+std::set<ulabel> label_set(const lcp::lps &lps_obj) {
+	std::vector<ulabel> labels;
+	lps_obj.get_labels(labels);
+	return std::set<ulabel>(labels.begin(), labels.end());
+};
+
+void test_inverted_index_postings() {
+
+	lcp::encoding::init();
+
+	std::string base = generate_sequence(20000, 42);
+	std::vector<lcp::lps *> collection = generate_collection(base);
+
+	lcp::inverted_index serial(collection);
+	lcp::inverted_index threaded(collection, 3);
+
+	assert(serial.size() == collection.size() && "There should be one entry per sequence");
+	assert(serial.labels == threaded.labels && serial.offsets == threaded.offsets && "Threads should not change the labels");
+	assert(serial.sequences == threaded.sequences && serial.cores == threaded.cores && "Threads should not change the postings");
+
+	// every core is found through the postings of its label
+	size_t total = 0;
+	for (size_t sequence = 0; sequence < collection.size(); sequence++) {
+		const std::vector<lcp::core> &cores = *collection[sequence]->cores;
+		total += cores.size();
+
+		for (size_t index = 0; index < cores.size(); index++) {
+			std::pair<size_t, size_t> range = serial.postings(cores[index].label);
+			bool found = false;
+			for (size_t k = range.first; k < range.second; k++) {
+				assert(serial.labels[std::upper_bound(serial.offsets.begin(), serial.offsets.end(), k) - serial.offsets.begin() - 1] == cores[index].label && "Postings should belong to the label");
+				found |= serial.sequences[k] == sequence && serial.cores[k] == index;
+			}
+			assert(found && "Every core should be in the postings of its label");
+		}
+
+		assert(serial.distinct[sequence] == label_set(*collection[sequence]).size() && "Distinct counts should match");
+	}
+
+	assert(serial.sequences.size() == total && "There should be one posting per core");
+
+	for (size_t i = 0; i < collection.size(); i++) {
+		delete collection[i];
+	}
+
+	log("...  test_inverted_index_postings passed!");
+};
+
+void test_inverted_index_query() {
+
+	lcp::encoding::init();
+
+	std::string base = generate_sequence(20000, 42);
+	std::vector<lcp::lps *> collection = generate_collection(base);
+
+	lcp::inverted_index index(collection, 2);
+
+	lcp::lps query(base);
+	query.deepen(2);
+
+	std::vector<size_t> counts;
+	std::vector<double> scores;
+	std::set<ulabel> query_set = label_set(query);
+
+	assert(index.shared(query, counts) == query_set.size() && "Query labels should be counted once");
+	index.jaccard(query, scores);
+
+	for (size_t sequence = 0; sequence < collection.size(); sequence++) {
+		std::set<ulabel> other = label_set(*collection[sequence]);
+		size_t common = 0;
+		for (std::set<ulabel>::iterator it = query_set.begin(); it != query_set.end(); it++) {
+			common += other.count(*it);
+		}
+
+		assert(counts[sequence] == common && "Shared counts should match the label sets");
+		assert(scores[sequence] == static_cast<double>(common) / (query_set.size() + other.size() - common) && "Jaccard should match the label sets");
+	}
+
+	// the longest shared prefix gives the highest similarity
+	for (size_t sequence = 0; sequence + 1 < collection.size(); sequence++) {
+		assert(scores[sequence] < scores.back() && "Similarity should be highest for the longest shared prefix");
+	}
+
+	// core arrays give the same results
+	lcp::core_array query_array(*query.cores, query.level, query.label_flags);
+	std::vector<size_t> array_counts;
+	index.shared(query_array, array_counts);
+	assert(array_counts == counts && "Core arrays should be queried like lps");
+
+	for (size_t i = 0; i < collection.size(); i++) {
+		delete collection[i];
+	}
+
+	log("...  test_inverted_index_query passed!");
+};
+
+void test_inverted_index_file_io() {
+
+	lcp::encoding::init();
+
+	std::string base = generate_sequence(10000, 42);
+	std::vector<lcp::lps *> collection = generate_collection(base);
+
+	lcp::inverted_index index(collection);
+
+	std::string filename = "inverted_index_test.bin";
+	std::ofstream outfile(filename, std::ios::binary);
+	index.write(outfile);
+	outfile.close();
+
+	lcp::inverted_index other;
+	std::ifstream infile(filename, std::ios::binary);
+	assert(other.read(infile) && "Index should be read back");
+	infile.close();
+
+	assert(other.labels == index.labels && other.offsets == index.offsets && "Labels should match after reading");
+	assert(other.sequences == index.sequences && other.cores == index.cores && other.distinct == index.distinct && "Postings should match after reading");
+
+	std::remove(filename.c_str());
+
+	for (size_t i = 0; i < collection.size(); i++) {
+		delete collection[i];
+	}
+
+	log("...  test_inverted_index_file_io passed!");
+};
+
+void test_inverted_index_label_flags() {
+
+	lcp::encoding::init();
+
+	std::string base = generate_sequence(10000, 42);
+
+	lcp::hash::set_backend(lcp::hash::MIX);
+	std::vector<lcp::core_array> collection(2, lcp::core_array(base, false));
+	collection[0].deepen(2, false);
+	collection[1].deepen(2, false);
+
+	lcp::inverted_index index(collection);
+	std::vector<size_t> counts;
+
+	assert(index.label_flags == LCPT_MIX && "The index should record how its labels were computed");
+	assert(index.shared(collection[0], counts) == std::set<ulabel>(collection[0].labels.begin(), collection[0].labels.end()).size() && "Queries of the same labels should be answered");
+
+	// labels of another function do not match the indexed ones
+	lcp::hash::set_backend(lcp::hash::MURMUR);
+	lcp::core_array query(base, false);
+	query.deepen(2, false);
+
+	bool refused = false;
+	try {
+		index.shared(query, counts);
+	} catch (const std::invalid_argument &) {
+		refused = true;
+	}
+	assert(refused && "Queries of other label functions should be refused");
+
+	collection.push_back(query);
+
+	refused = false;
+	try {
+		lcp::inverted_index mixed(collection);
+	} catch (const std::invalid_argument &) {
+		refused = true;
+	}
+	assert(refused && "Sequences of different label functions should not be indexed together");
+
+	lcp::hash::set_backend(LCP_HASH_BACKEND);
+
+	std::string filename = "inverted_index_flags_test.bin";
+	std::ofstream outfile(filename, std::ios::binary);
+	index.write(outfile);
+	outfile.close();
+
+	lcp::inverted_index other;
+	std::ifstream infile(filename, std::ios::binary);
+	assert(other.read(infile) && other.label_flags == LCPT_MIX && "Label flags should match after reading");
+	infile.close();
+
+	std::remove(filename.c_str());
+
+	log("...  test_inverted_index_label_flags passed!");
+};
+
+int main() {
+
+	log("Running test_inverted_index...");
+
+	test_inverted_index_postings();
+	test_inverted_index_query();
+	test_inverted_index_file_io();
+	test_inverted_index_label_flags();
+
+	log("All tests in test_inverted_index completed successfully!");
+
+	return 0;
+}
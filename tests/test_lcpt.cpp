@@ -0,0 +1,272 @@
+#include "common.h"
+#include "core.h"
+#include "core_array.h"
+#include "lcpt.h"
+#include "lps.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+// pseudo-random sequence with runs spanning multiple blocks
+std::string generate_runs(size_t length, unsigned int seed) {
+	return generate_sequence(length, seed, "ACGT", 64, 40);
+};
+
+bool equal(const lcp::lps &lps_obj, const lcp::lcpt::record &rec) {
+
+	if (lps_obj.size() != rec.size() || lps_obj.level != rec.level) {
+		return false;
+	}
+
+	for (size_t index = 0; index < rec.size(); index++) {
+		lcp::core temp = rec.get(index);
+		const lcp::core &other = (*lps_obj.cores)[index];
+
+		if (temp != other || temp.label != other.label || temp.start != other.start || temp.end != other.end) {
+			return false;
+		}
+	}
+
+	return true;
+};
+
+void test_lcpt_stream_io() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_runs(10000, 42);
+
+	lcp::lps first(test_string);
+	lcp::lps second(test_string);
+	second.deepen(3);
+
+	std::string filename = "lcpt_test.lcpt";
+	std::ofstream outfile(filename, std::ios::binary);
+	first.write(outfile);
+	second.write(outfile);
+	outfile.close();
+
+	std::ifstream infile(filename, std::ios::binary);
+	lcp::lps first_from_file(infile);
+	lcp::lps second_from_file(infile);
+	infile.close();
+
+	assert(first == first_from_file && first.level == first_from_file.level && "First record should match after reading from file");
+	assert(second == second_from_file && second.level == second_from_file.level && "Second record should match after reading from file");
+
+	for (size_t i = 0; i < first.size(); i++) {
+		assert((*first.cores)[i].label == (*first_from_file.cores)[i].label && "Labels should match after reading from file");
+		assert((*first.cores)[i].start == (*first_from_file.cores)[i].start && "Positions should match after reading from file");
+	}
+
+	std::remove(filename.c_str());
+
+	log("...  test_lcpt_stream_io passed!");
+};
+
+void test_lcpt_view() {
+
+	lcp::encoding::init();
+
+	std::vector<lcp::lps *> records;
+	std::string filename = "lcpt_view_test.lcpt";
+	std::ofstream outfile(filename, std::ios::binary);
+
+	for (unsigned int seed = 1; seed <= 3; seed++) {
+		std::string test_string = generate_runs(5000 * seed, seed);
+		lcp::lps *record = new lcp::lps(test_string);
+		record->deepen(static_cast<int>(seed));
+		record->write(outfile);
+		records.push_back(record);
+	}
+
+	// completion marker written by lcptools
+	bool done = true;
+	outfile.write(reinterpret_cast<const char *>(&done), sizeof(done));
+	outfile.close();
+
+	{
+		lcp::lcpt::view file(filename);
+
+		assert(file.is_open() && "File should be mapped");
+		assert(file.records.size() == records.size() && "Every record should be indexed");
+		assert(file.records[0].offsets != nullptr && "Level 1 runs should need offsets");
+
+		for (size_t i = 0; i < records.size(); i++) {
+			assert(equal(*records[i], file.records[i]) && "Mapped cores should match the written cores");
+		}
+
+		// mapped records can be continued in memory
+		lcp::core_array array(file.records[0]);
+		records[0]->deepen(2);
+		array.deepen(2);
+
+		assert(array.size() == records[0]->size() && "Deepened mapped cores should match");
+		for (size_t i = 0; i < array.size(); i++) {
+			assert(array.get(i) == (*records[0]->cores)[i] && "Deepened mapped cores should match");
+		}
+	}
+
+	for (size_t i = 0; i < records.size(); i++) {
+		delete records[i];
+	}
+
+	std::remove(filename.c_str());
+
+	log("...  test_lcpt_view passed!");
+};
+
+void test_lcpt_legacy() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_runs(2000, 7);
+	lcp::lps lps_obj(test_string);
+
+	// legacy layout: level, size and each core
+	std::string filename = "lcpt_legacy_test.dat";
+	std::ofstream outfile(filename, std::ios::binary);
+	size_t size = lps_obj.size();
+	outfile.write(reinterpret_cast<const char *>(&lps_obj.level), sizeof(lps_obj.level));
+	outfile.write(reinterpret_cast<const char *>(&size), sizeof(size));
+	for (size_t i = 0; i < size; i++) {
+		(*lps_obj.cores)[i].write(outfile);
+	}
+	outfile.close();
+
+	std::ifstream infile(filename, std::ios::binary);
+	lcp::lps lps_obj_from_file(infile);
+	infile.close();
+
+	assert(lps_obj == lps_obj_from_file && "Legacy files should still be readable");
+
+	std::remove(filename.c_str());
+
+	log("...  test_lcpt_legacy passed!");
+};
+
+void test_lcpt_names() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_runs(3000, 11);
+	lcp::lps lps_obj(test_string);
+	lcp::core_array array(test_string);
+
+	// named and unnamed records can be mixed, names are padded like other sections
+	std::string filename = "lcpt_names_test.lcpt";
+	std::ofstream outfile(filename, std::ios::binary);
+	lps_obj.write(outfile, "chr1");
+	lps_obj.write(outfile);
+
+	std::string buffer;
+	array.write(buffer, "contig_0000123");
+	outfile.write(buffer.data(), buffer.size());
+	outfile.close();
+
+	{
+		lcp::lcpt::view file(filename);
+
+		assert(file.records.size() == 3 && "Every record should be indexed");
+		assert(std::string(file.records[0].name, file.records[0].name_length) == "chr1" && "Names should be mapped");
+		assert(file.records[1].name == nullptr && file.records[1].name_length == 0 && "Unnamed records should have no name");
+		assert(std::string(file.records[2].name, file.records[2].name_length) == "contig_0000123" && "Names should be mapped");
+
+		assert(equal(lps_obj, file.records[0]) && equal(lps_obj, file.records[1]) && "Named records should hold the same cores");
+		assert(file.records[2].size() == array.size() && file.records[2].get(0) == array.get(0) && "Named records should hold the same cores");
+	}
+
+	// streams skip names unless they are asked for
+	std::ifstream infile(filename, std::ios::binary);
+	lcp::lps first_from_file(infile);
+
+	lcp::lcpt::header hdr;
+	std::string name = "unchanged";
+	assert(lcp::lcpt::read_header(infile, hdr, &name) && name.empty() && "Unnamed records should read an empty name");
+	infile.seekg(-static_cast<std::streamoff>(sizeof(hdr)), std::ios::cur);
+	lcp::lps second_from_file(infile);
+
+	assert(lcp::lcpt::read_header(infile, hdr, &name) && name == "contig_0000123" && "Names should be read");
+	infile.close();
+
+	assert(first_from_file == lps_obj && second_from_file == lps_obj && "Cores should be read after a name");
+
+	std::remove(filename.c_str());
+
+	log("...  test_lcpt_names passed!");
+};
+
+void test_lcpt_label_flags() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_runs(20000, 5);
+
+	// the flags follow how the labels were computed, whatever the backend is when writing
+	lcp::hash::set_backend(lcp::hash::MIX);
+	lcp::core_array characters(test_string, false);
+	lcp::core_array mixed(test_string, false);
+	mixed.deepen(3, false);
+	lcp::core_array ids(test_string, true);
+	ids.deepen(2, true);
+
+	lcp::hash::set_backend(lcp::hash::MURMUR);
+	lcp::lps hashed(test_string);
+	hashed.deepen(3, false);
+
+	assert(characters.label_flags == 0 && "Level 1 labels do not depend on the label function");
+	assert(mixed.label_flags == LCPT_MIX && ids.label_flags == LCPT_IDS && hashed.label_flags == 0 && "Cores should record how their labels were computed");
+
+	std::string filename = "lcpt_label_flags_test.lcpt";
+	std::ofstream outfile(filename, std::ios::binary);
+	characters.write(outfile);
+	mixed.write(outfile);
+	ids.write(outfile);
+	hashed.write(outfile);
+	outfile.close();
+
+	{
+		lcp::lcpt::view file(filename);
+
+		assert(file.records.size() == 4 && "Every record should be indexed");
+		assert(file.records[0].label_flags == 0 && file.records[1].label_flags == LCPT_MIX && "Records should keep the label flags");
+		assert(file.records[2].label_flags == LCPT_IDS && file.records[3].label_flags == 0 && "Records should keep the label flags");
+		assert(lcp::core_array(file.records[1]).label_flags == LCPT_MIX && "Copies of records should keep the label flags");
+		assert(!lcp::lcpt::comparable(file.records[1].label_flags, file.records[3].label_flags) && "Labels of different functions should not be comparable");
+	}
+
+	std::ifstream infile(filename, std::ios::binary);
+	lcp::core_array first, second;
+	assert(first.read(infile) && second.read(infile) && "Records should be read");
+	lcp::lps third(infile), fourth(infile);
+	infile.close();
+
+	assert(first.label_flags == 0 && second.label_flags == LCPT_MIX && third.label_flags == LCPT_IDS && fourth.label_flags == 0 && "Reads should keep the label flags");
+
+	lcp::hash::set_backend(LCP_HASH_BACKEND);
+	std::remove(filename.c_str());
+
+	log("...  test_lcpt_label_flags passed!");
+};
+
+int main() {
+
+	log("Running test_lcpt...");
+
+	test_lcpt_stream_io();
+	test_lcpt_view();
+	test_lcpt_legacy();
+	test_lcpt_names();
+	test_lcpt_label_flags();
+
+	log("All tests in test_lcpt completed successfully!");
+
+	return 0;
+}
@@ -0,0 +1,109 @@
+#include "common.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+
+// the executable built by `make install`, tests run from the root of the repository
+#define LCPTOOLS "./lcptools"
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+std::string read_file(const std::string &filename) {
+	std::ifstream in(filename, std::ios::binary);
+	std::ostringstream content;
+	content << in.rdbuf();
+	return content.str();
+};
+
+// records parsed concurrently, some of them with runs of N for the gap-aware mode
+void write_fasta(const std::string &filename, unsigned int record_count) {
+	std::ofstream out(filename);
+
+	for (unsigned int index = 0; index < record_count; index++) {
+		std::string sequence = generate_sequence(20000 + 10000 * (index % 5), 101 + index);
+		if (index % 3 == 0) {
+			sequence.replace(sequence.size() / 2, 300, 300, 'N');
+		}
+
+		out << ">record" << index << "\n";
+		for (size_t line = 0; line < sequence.size(); line += 80) {
+			out << sequence.substr(line, 80) << "\n";
+		}
+	}
+};
+
+// runs falcpt on a file and returns its outputs, the .lcpt file followed by the .lcpd file
+std::string falcpt(const std::string &filename, const std::string &arguments, const std::string &prefix = std::string()) {
+	std::string command = prefix + LCPTOOLS + " falcpt " + filename + " " + arguments + " > /dev/null";
+	assert(std::system(command.c_str()) == 0 && "falcpt should succeed");
+
+	std::string output = read_file(filename + ".lcpt") + read_file(filename + ".lcpd");
+
+	std::remove((filename + ".lcpt").c_str());
+	std::remove((filename + ".lcpd").c_str());
+
+	return output;
+};
+
+void test_lcptools_dictionary() {
+
+	assert(std::ifstream(LCPTOOLS).good() && "lcptools should be built before the tests");
+
+	std::string filename = "lcptools_test.fa";
+	write_fasta(filename, 16);
+
+	for (const char *mode : {"", " --gaps"}) {
+		std::string serial = falcpt(filename, std::string("4 1000 1 --dictionary") + mode);
+		std::string first = falcpt(filename, std::string("4 1000 4 --dictionary") + mode);
+		std::string second = falcpt(filename, std::string("4 1000 4 --dictionary") + mode);
+
+		assert(!first.empty() && first == second && "Dictionary IDs should not depend on the scheduling of records");
+		assert(first == serial && "Dictionary IDs should not depend on the number of threads");
+	}
+
+	std::remove(filename.c_str());
+
+	log("...  test_lcptools_dictionary passed!");
+};
+
+void test_lcptools_fifo() {
+
+	assert(std::ifstream(LCPTOOLS).good() && "lcptools should be built before the tests");
+
+	// small enough for the pipe, so that the writer is gone before the file is read
+	std::string filename = "lcptools_test.fa", fifo = "lcptools_fifo_test.fa";
+	write_fasta(filename, 2);
+
+	std::remove(fifo.c_str());
+	assert(mkfifo(fifo.c_str(), 0600) == 0 && "The pipe should be created");
+
+	// a pipe can only be opened once, opening it again would wait for another writer
+	std::string expected = falcpt(filename, "4 1000 4");
+	std::string piped = falcpt(fifo, "4 1000 4", "cat " + filename + " > " + fifo + " & timeout 60 ");
+
+	assert(!piped.empty() && piped == expected && "Pipes should be read as streams");
+
+	std::remove(fifo.c_str());
+	std::remove(filename.c_str());
+
+	log("...  test_lcptools_fifo passed!");
+};
+
+int main() {
+
+	log("Running test_lcptools...");
+
+	test_lcptools_dictionary();
+	test_lcptools_fifo();
+
+	log("All tests in test_lcptools completed successfully!");
+
+	return 0;
+};
@@ -1,3 +1,5 @@
+#include "common.h"
+#include "context.h"
 #include "core.h"
 #include "lps.h"
 #include <cassert>
@@ -254,6 +256,130 @@ void test_lps_deepen() {
 	log("...  test_lps_deepen passed!");
 }
 
+void test_lps_parallel_split() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_sequence(20000, 42);
+
+	lcp::lps serial_obj(test_string, 3, 2000, 200, 1);
+	lcp::lps parallel_obj(test_string, 3, 2000, 200, 4);
+
+	assert(serial_obj.level == parallel_obj.level && "Levels should match between serial and parallel split");
+	assert(serial_obj.size() == parallel_obj.size() && "Core size should match between serial and parallel split");
+	assert(serial_obj == parallel_obj && "Cores should match between serial and parallel split");
+
+	// segments are joined exactly, also when the margin has to grow for the level
+	lcp::lps whole(test_string);
+	whole.deepen(5);
+
+	const size_t margins[] = {10000, 200, 8};
+	for (size_t index = 0; index < 3; index++) {
+		lcp::lps split_obj(test_string, 5, 1500, margins[index], 2);
+
+		assert(whole.level == split_obj.level && whole.size() == split_obj.size() && "Split parsing should reach the same level and size");
+		assert(whole == split_obj && "Split parsing should give the cores of the whole string");
+	}
+
+	log("...  test_lps_parallel_split passed!");
+};
+
+void test_lps_parallel_split_dictionary() {
+
+	std::string test_string = generate_sequence(30000, 43);
+
+	// dictionary IDs do not depend on the number of threads, also when windows are parsed again
+	const size_t margins[] = {200, 8};
+	for (size_t index = 0; index < 2; index++) {
+
+		std::vector<ulabel> expected;
+		ulabel expected_ids = 0;
+
+		for (size_t thread_number : {1, 2, 8}) {
+			lcp::context ctx;
+			lcp::context::scope bind(ctx);
+			lcp::encoding::init();
+
+			lcp::lps split_obj(test_string, 4, 1500, margins[index], thread_number, true);
+
+			std::vector<ulabel> labels;
+			split_obj.get_labels(labels);
+
+			assert(split_obj.level == 4 && split_obj.label_flags == LCPT_IDS && "Split parsing should label with the dictionary");
+
+			if (thread_number == 1) {
+				expected.swap(labels);
+				expected_ids = ctx.next_id;
+				continue;
+			}
+
+			assert(labels == expected && "Dictionary labels should not depend on the number of threads");
+			assert(ctx.next_id == expected_ids && "The dictionary should not depend on the number of threads");
+		}
+	}
+
+	log("...  test_lps_parallel_split_dictionary passed!");
+};
+
+void test_lps_parallel_deepen() {
+
+	lcp::encoding::init();
+
+	// pseudo-random sequence with runs and tandem repeats, large enough for parallel levels
+	std::string test_string = generate_repeats(2000000, 7);
+
+	lcp::lps serial_obj(test_string);
+	serial_obj.deepen(6);
+
+	for (size_t thread_number : {2, 3, 8}) {
+		lcp::lps parallel_obj(test_string);
+		parallel_obj.deepen(6, false, thread_number);
+
+		assert(serial_obj.level == parallel_obj.level && serial_obj.size() == parallel_obj.size() && "Parallel deepening should reach the same level and size");
+		assert(serial_obj == parallel_obj && "Parallel deepening should give the cores of the serial parse");
+
+		for (size_t index = 0; index < serial_obj.size(); index++) {
+			const lcp::core &lhs = (*serial_obj.cores)[index], &rhs = (*parallel_obj.cores)[index];
+			assert(lhs.label == rhs.label && lhs.start == rhs.start && lhs.end == rhs.end && "Labels and positions should match the serial parse");
+		}
+	}
+
+	log("...  test_lps_parallel_deepen passed!");
+};
+
+void test_lps_reverse_complement() {
+
+	lcp::encoding::init();
+
+	// pseudo-random sequence with invalid characters
+	std::string test_string = generate_sequence(20000, 7, "ACGTACGTN");
+
+	const std::string original = test_string;
+	std::string reversed(original.rbegin(), original.rend());
+
+	// reference: parse an explicitly reversed copy with the reverse complement rules
+	std::vector<struct lcp::core> expected;
+	lcp::lps::parse(reversed.data(), reversed.data() + reversed.size(), &expected, 0, lcp::char_rc_gt, lcp::char_rc_lt, lcp::char_rc_eq, lcp::char_index, lcp::char_size, lcp::char_rev_rep, lcp::char_data, false);
+
+	lcp::lps rc_obj(test_string, false, true);
+
+	assert(test_string == original && "Reverse complement parsing should not modify the input");
+	assert(rc_obj.size() == expected.size() && "Core size should match the reversed copy");
+	for (size_t i = 0; i < expected.size(); i++) {
+		assert((*rc_obj.cores)[i] == expected[i] && (*rc_obj.cores)[i].label == expected[i].label && "Cores should match the reversed copy");
+	}
+
+	// both strands from the same buffer
+	lcp::lps fwd_obj(original.data(), original.data() + original.size(), false, false);
+	lcp::lps rev_obj(original.data(), original.data() + original.size(), false, true);
+	lcp::lps fwd_str(test_string);
+
+	assert(fwd_obj == fwd_str && "Forward strand should be unaffected");
+	assert(rev_obj == rc_obj && "Reverse strand should match the string constructor");
+
+	log("...  test_lps_reverse_complement passed!");
+};
+
 int main() {
 
 	log("Running test_lps...");
@@ -261,6 +387,10 @@ int main() {
 	test_lps_constructor();
 	test_lps_file_io();
 	test_lps_deepen();
+	test_lps_parallel_split();
+	test_lps_parallel_split_dictionary();
+	test_lps_parallel_deepen();
+	test_lps_reverse_complement();
 
 	log("All tests in test_lps completed successfully!");
 
@@ -0,0 +1,107 @@
+#include "common.h"
+#include "core.h"
+#include "lps.h"
+#include "pipeline.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+// pseudo-random sequence with occasional runs
+std::string generate_runs(size_t length, unsigned int seed) {
+	return generate_sequence(length, seed, "ACGT", 32, 12);
+};
+
+bool equal(lcp::lps &lps_obj, const std::vector<struct lcp::core> &cores) {
+
+	if (lps_obj.size() != cores.size()) {
+		return false;
+	}
+
+	for (size_t index = 0; index < cores.size(); index++) {
+		const lcp::core &other = (*lps_obj.cores)[index];
+
+		if (cores[index] != other || cores[index].label != other.label || cores[index].start != other.start || cores[index].end != other.end) {
+			return false;
+		}
+	}
+
+	return true;
+};
+
+void test_pipeline_levels() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_runs(30000, 42);
+
+	for (int level = 1; level <= 4; level++) {
+
+		lcp::lps lps_obj(test_string);
+		lps_obj.deepen(level);
+
+		for (size_t buffer_size = 16; buffer_size <= 4096; buffer_size *= 16) {
+
+			std::vector<struct lcp::core> cores;
+			lcp::pipeline stream(level, [&](lcp::core &c) { cores.push_back(std::move(c)); }, false, buffer_size);
+
+			// push in uneven chunks
+			for (size_t begin = 0; begin < test_string.size(); begin += 997) {
+				stream.push(test_string.substr(begin, 997));
+			}
+			stream.finish();
+
+			assert(stream.size() == cores.size() && "Pipeline should count emitted cores");
+			assert(equal(lps_obj, cores) && "Pipeline cores should match the deepened lps cores");
+		}
+	}
+
+	log("...  test_pipeline_levels passed!");
+};
+
+void test_pipeline_reuse() {
+
+	lcp::encoding::init();
+
+	std::vector<struct lcp::core> cores;
+	lcp::pipeline stream(3, [&](lcp::core &c) { cores.push_back(std::move(c)); }, false, 64);
+
+	for (unsigned int seed = 1; seed <= 3; seed++) {
+
+		std::string test_string = generate_runs(5000, seed);
+
+		lcp::lps lps_obj(test_string);
+		lps_obj.deepen(3);
+
+		cores.clear();
+		stream.push(test_string);
+		stream.finish();
+
+		assert(equal(lps_obj, cores) && "Pipeline should restart after finish");
+	}
+
+	// too short to reach the target level
+	cores.clear();
+	stream.push(std::string("ACGTTGCA"));
+	stream.finish();
+
+	assert(cores.empty() && "Short sequences should not produce deep cores");
+
+	log("...  test_pipeline_reuse passed!");
+};
+
+int main() {
+
+	log("Running test_pipeline...");
+
+	test_pipeline_levels();
+	test_pipeline_reuse();
+
+	log("All tests in test_pipeline completed successfully!");
+
+	return 0;
+}
@@ -0,0 +1,232 @@
+#include "common.h"
+#include "context.h"
+#include "core_array.h"
+#include "encoding.h"
+#include "gaps.h"
+#include "shard.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+// parses a sequence with the dictionary of a context
+lcp::core_array parse(lcp::context &ctx, std::string &sequence, int lcp_level) {
+	lcp::context::scope bind(ctx);
+	lcp::encoding::init();
+
+	lcp::core_array cores(sequence, true);
+	cores.deepen(lcp_level, true);
+
+	return cores;
+};
+
+// labels of equal cores match in both arrays, and labels of different cores differ
+bool consistent(const std::vector<ulabel> &expected, const std::vector<ulabel> &actual, std::map<ulabel, ulabel> &forward, std::map<ulabel, ulabel> &backward) {
+	if (expected.size() != actual.size()) {
+		return false;
+	}
+
+	for (size_t i = 0; i < expected.size(); i++) {
+		if (forward.emplace(expected[i], actual[i]).first->second != actual[i] || backward.emplace(actual[i], expected[i]).first->second != expected[i]) {
+			return false;
+		}
+	}
+
+	return true;
+};
+
+void test_shard_merge() {
+
+	std::string sequence = generate_sequence(60000, 31);
+	std::string first_part = sequence.substr(0, 40000), second_part = sequence.substr(20000);
+
+	// two nodes, each with its own dictionary
+	lcp::context first_node, second_node;
+	lcp::core_array first = parse(first_node, first_part, 4);
+	lcp::core_array second = parse(second_node, second_part, 4);
+
+	// a single node parsing both
+	lcp::context joint;
+	lcp::core_array first_joint = parse(joint, first_part, 4);
+	lcp::core_array second_joint = parse(joint, second_part, 4);
+
+	lcp::shard first_shard(first_node), second_shard(second_node);
+	assert(first_shard.size() == first_node.next_id && "Every ID should be kept");
+
+	// shards survive a round trip through files
+	std::string filename = "shard_test.lcpd";
+	{
+		std::ofstream out(filename, std::ios::binary);
+		second_shard.write(out);
+	}
+	{
+		std::ifstream in(filename, std::ios::binary);
+		lcp::shard other;
+		assert(other.read(in) && "Shard should be read");
+		assert(other.kinds == second_shard.kinds && other.strings == second_shard.strings && other.cores == second_shard.cores && "Read shard should match");
+	}
+	std::remove(filename.c_str());
+
+	lcp::context global;
+	std::vector<ulabel> first_ids, second_ids;
+	first_shard.merge(first_ids, global);
+	second_shard.merge(second_ids, global);
+
+	assert(global.next_id == joint.next_id && "Merged dictionary should hold the keys of both shards once");
+	assert(lcp::shard::remap(first, first_ids) && lcp::shard::remap(second, second_ids) && "Labels should be remapped");
+
+	std::map<ulabel, ulabel> forward, backward;
+	assert(consistent(first_joint.labels, first.labels, forward, backward) && "Merged labels should match a single dictionary");
+	assert(consistent(second_joint.labels, second.labels, forward, backward) && "Merged labels should match a single dictionary");
+
+	// merging a merged dictionary into an empty context keeps its IDs
+	lcp::shard merged(global);
+	lcp::context again;
+	std::vector<ulabel> ids;
+	merged.merge(ids, again);
+	for (size_t id = 0; id < ids.size(); id++) {
+		assert(ids[id] == id && "A merged dictionary should keep its IDs");
+	}
+
+	log("...  test_shard_merge passed!");
+};
+
+void test_shard_remap_file() {
+
+	std::string first_part = generate_sequence(30000, 41), second_part = generate_sequence(20000, 43);
+
+	lcp::context node;
+	lcp::core_array first = parse(node, first_part, 3);
+	lcp::core_array second = parse(node, second_part, 5);
+
+	std::string filename = "shard_remap_test.lcpt";
+	{
+		std::ofstream out(filename, std::ios::binary);
+		first.write(out, "first");
+		second.write(out, "second");
+		bool done = true;
+		out.write(reinterpret_cast<const char *>(&done), sizeof(done));
+	}
+
+	lcp::context global;
+	std::vector<ulabel> ids;
+	{
+		// keys of another shard first, so that no ID stays the same by accident
+		lcp::context other;
+		std::string other_part = generate_sequence(10000, 47);
+		parse(other, other_part, 3);
+		lcp::shard(other).merge(ids, global);
+	}
+	lcp::shard(node).merge(ids, global);
+
+	assert(lcp::shard::remap(filename, ids) == 2 && "Every record should be remapped");
+	assert(lcp::shard::remap(first, ids) && lcp::shard::remap(second, ids) && "Labels should be remapped");
+
+	{
+		std::ifstream in(filename, std::ios::binary);
+		lcp::core_array first_file, second_file;
+		assert(first_file.read(in) && second_file.read(in) && "Remapped records should be read");
+
+		assert(first_file.labels == first.labels && second_file.labels == second.labels && "Labels in the file should be remapped");
+		assert(first_file.blocks == first.blocks && second_file.blocks == second.blocks && first_file.level == 3 && second_file.level == 5 && "Other columns should be unchanged");
+		assert(first_file.label_flags == (LCPT_IDS | LCPT_MERGED) && first.label_flags == (LCPT_IDS | LCPT_MERGED) && "Remapped cores should be marked");
+	}
+
+	// remapped labels are never remapped again
+	assert(lcp::shard::remap(filename, ids) == 0 && !lcp::shard::remap(first, ids) && "Remapped cores should be skipped");
+	{
+		std::ifstream in(filename, std::ios::binary);
+		lcp::core_array first_file, second_file;
+		assert(first_file.read(in) && second_file.read(in) && first_file.labels == first.labels && second_file.labels == second.labels && "Labels should be remapped once");
+	}
+
+	// labels computed by hashing are not IDs
+	lcp::encoding::init();
+	lcp::core_array hashed(first_part);
+	hashed.deepen(3);
+	std::vector<ulabel> labels = hashed.labels;
+	assert(!lcp::shard::remap(hashed, std::vector<ulabel>(4)) && hashed.labels == labels && "Labels that are not IDs should be rejected");
+
+	// a file with a record that cannot be remapped is left unchanged
+	lcp::core_array unmerged = parse(node, first_part, 3);
+	{
+		std::ofstream out(filename, std::ios::binary);
+		unmerged.write(out);
+		hashed.write(out);
+	}
+	assert(lcp::shard::remap(filename, ids) == -1 && "Files with labels that are not IDs should be rejected");
+	{
+		std::ifstream in(filename, std::ios::binary);
+		lcp::core_array first_file;
+		assert(first_file.read(in) && first_file.labels == unmerged.labels && first_file.label_flags == LCPT_IDS && "Records before the failing one should be unchanged");
+	}
+
+	std::remove(filename.c_str());
+
+	log("...  test_shard_remap_file passed!");
+};
+
+void test_shard_relabel() {
+
+	// named record with gaps, so the labels follow every optional section
+	std::string sequence = generate_sequence(20000, 53) + std::string(500, 'N') + generate_sequence(20000, 59);
+	std::vector<lcp::gap> gaps;
+	lcp::find_gaps(sequence.data(), sequence.data() + sequence.size(), gaps);
+
+	lcp::context local;
+	lcp::core_array cores;
+	{
+		lcp::context::scope bind(local);
+		lcp::encoding::init();
+		cores = lcp::core_array(sequence.data(), sequence.data() + sequence.size(), gaps, true);
+		cores.deepen(3, true);
+	}
+
+	std::string data;
+	cores.write(data, "gapped");
+
+	lcp::context global;
+	std::vector<ulabel> ids;
+	{
+		// keys of another shard first, so that no ID stays the same by accident
+		lcp::context other;
+		std::string other_part = generate_sequence(10000, 61);
+		parse(other, other_part, 3);
+		lcp::shard(other).merge(ids, global);
+	}
+	lcp::shard(local).merge(ids, global);
+
+	assert(lcp::shard::relabel(data, ids) && "Serialized labels should be relabelled");
+
+	for (std::vector<ulabel>::iterator it = cores.labels.begin(); it != cores.labels.end(); it++) {
+		*it = ids[*it];
+	}
+	std::string expected;
+	cores.write(expected, "gapped");
+	assert(data == expected && "Only the labels should change, and the record should not be marked");
+
+	// labels that are not IDs of the shard leave the record unchanged
+	assert(!lcp::shard::relabel(data, std::vector<ulabel>(1)) && data == expected && "Unknown IDs should be rejected");
+
+	log("...  test_shard_relabel passed!");
+};
+
+int main() {
+
+	log("Running test_shard...");
+
+	test_shard_merge();
+	test_shard_remap_file();
+	test_shard_relabel();
+
+	log("All tests in test_shard completed successfully!");
+
+	return 0;
+};
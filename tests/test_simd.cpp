@@ -0,0 +1,208 @@
+#include "common.h"
+#include "core.h"
+#include "lps.h"
+#include "simd.h"
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+std::string generate_mixed(size_t length, unsigned int seed) {
+
+	// pseudo-random sequence with runs of varying length, lowercase and invalid characters
+	lcg random(seed);
+	std::string sequence;
+	for (size_t i = 0; i < length; i++) {
+		unsigned int state = random.next();
+		char c = "ACGTACGTacgtNNRY"[(state >> 16) % 16];
+		sequence.append((state >> 8) % 32 == 0 ? 1 + (state >> 4) % 90 : 1, c);
+	}
+
+	return sequence;
+};
+
+bool equal(const std::vector<struct lcp::core> &lhs, const std::vector<struct lcp::core> &rhs) {
+
+	if (lhs.size() != rhs.size()) {
+		return false;
+	}
+
+	for (size_t index = 0; index < lhs.size(); index++) {
+		if (lhs[index] != rhs[index] || lhs[index].label != rhs[index].label || lhs[index].start != rhs[index].start || lhs[index].end != rhs[index].end) {
+			return false;
+		}
+	}
+
+	return true;
+};
+
+void test_simd_compare() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_mixed(64 * 8 + 1, 3);
+
+	int8_t table[256];
+	assert(lcp::simd::build_table(lcp::alphabet, table) && "Default alphabet should fit into bytes");
+	assert(table['N'] == -1 && table[200] == -1 && "Invalid characters should get -1");
+
+	std::vector<int8_t> codes(test_string.size());
+	lcp::simd::translate(test_string.data(), test_string.data() + test_string.size(), table, codes.data());
+
+	uint64_t eq[8], gt[8], lt[8];
+	lcp::simd::compare(codes.data(), 8, eq, gt, lt);
+
+	for (size_t index = 0; index < 64 * 8; index++) {
+		bool eq_bit = (eq[index / 64] >> (index % 64)) & 1;
+		bool gt_bit = (gt[index / 64] >> (index % 64)) & 1;
+		bool lt_bit = (lt[index / 64] >> (index % 64)) & 1;
+
+		assert(eq_bit == lcp::char_eq(&test_string[index], &test_string[index + 1]) && "Equal mask should match char_eq");
+		assert(gt_bit == lcp::char_gt(&test_string[index], &test_string[index + 1]) && "Greater-than mask should match char_gt");
+		assert(lt_bit == lcp::char_lt(&test_string[index], &test_string[index + 1]) && "Less-than mask should match char_lt");
+	}
+
+	assert(lcp::simd::bits(eq, 70) == ((eq[1] >> 6) | (eq[2] << 58)) && "Bits should span two words");
+
+	log("...  test_simd_compare passed!");
+};
+
+void test_simd_parse() {
+
+	lcp::encoding::init();
+
+	// lengths around chunk and word boundaries
+	size_t lengths[] = {0, 1, 2, 3, 4, 63, 64, 65, 200, SIMD_CHUNK_SIZE - 1, SIMD_CHUNK_SIZE, SIMD_CHUNK_SIZE + 3, 3 * SIMD_CHUNK_SIZE + 17};
+
+	for (size_t length : lengths) {
+		for (unsigned int seed = 1; seed <= 4; seed++) {
+
+			std::string test_string = generate_mixed(length, seed).substr(0, length);
+			const char *begin = test_string.data(), *end = begin + test_string.size();
+
+			std::vector<struct lcp::core> expected, cores, rc_expected, rc_cores;
+
+			lcp::lps::parse(begin, end, &expected, 0, lcp::char_gt, lcp::char_lt, lcp::char_eq, lcp::char_index, lcp::char_size, lcp::char_rep, lcp::char_data, false);
+			lcp::lps::parse_chars(begin, end, &cores, lcp::alphabet, lcp::char_gt, lcp::char_lt, lcp::char_eq, lcp::char_index, lcp::char_size, lcp::char_rep, lcp::char_data, false);
+
+			assert(equal(expected, cores) && "Bitmask parsing should find the same cores");
+
+			lcp::lps::parse(begin, end, &rc_expected, 0, lcp::char_rc_gt, lcp::char_rc_lt, lcp::char_rc_eq, lcp::char_index, lcp::char_size, lcp::char_rev_rep, lcp::char_data, false);
+			lcp::lps::parse_chars(begin, end, &rc_cores, lcp::rc_alphabet, lcp::char_rc_gt, lcp::char_rc_lt, lcp::char_rc_eq, lcp::char_index, lcp::char_size, lcp::char_rev_rep, lcp::char_data, false);
+
+			assert(equal(rc_expected, rc_cores) && "Bitmask parsing should find the same reverse complement cores");
+		}
+	}
+
+	log("...  test_simd_parse passed!");
+};
+
+void test_simd_parse_range() {
+
+	lcp::encoding::init();
+
+	std::string test_string = generate_mixed(20000, 11);
+	const char *begin = test_string.data();
+
+	// resume both scans over growing prefixes, as the pipeline does
+	std::vector<struct lcp::core> expected, cores;
+	const char *it1 = begin, *it2 = begin + test_string.size();
+	const char *simd_it1 = begin, *simd_it2 = begin + test_string.size();
+
+	for (size_t available = 0; available <= test_string.size(); available += 777) {
+
+		const char *end = begin + available;
+		bool final = available + 777 > test_string.size();
+
+		if (final) {
+			end = begin + test_string.size();
+		}
+
+		// it2 is the end of the last found core, or the end of the sequence if none is found yet
+		const char *curr_it2 = expected.empty() ? end : it2;
+		const char *curr_simd_it2 = cores.empty() ? end : simd_it2;
+
+		it1 = lcp::lps::parse_range(begin, it1, curr_it2, end, final, &expected, 0, lcp::char_gt, lcp::char_lt, lcp::char_eq, lcp::char_index, lcp::char_size, lcp::char_rep, lcp::char_data, false);
+		simd_it1 = lcp::lps::parse_chars_range(begin, simd_it1, curr_simd_it2, end, final, &cores, lcp::alphabet, lcp::char_gt, lcp::char_lt, lcp::char_eq, lcp::char_index, lcp::char_size, lcp::char_rep, lcp::char_data, false);
+
+		it2 = curr_it2;
+		simd_it2 = curr_simd_it2;
+
+		assert(it1 == simd_it1 && "Both scans should stop at the same position");
+		assert(equal(expected, cores) && "Both scans should find the same cores");
+
+		if (final) {
+			break;
+		}
+	}
+
+	log("...  test_simd_parse_range passed!");
+};
+
+void test_simd_dna_rules() {
+
+	lcp::encoding::init();
+	assert(lcp::dna_alphabet && "The default alphabet should select the compile-time rules");
+
+	for (int c = 0; c < 128; c++) {
+		const char character = static_cast<char>(c);
+		const char masked = static_cast<char>(c & 0xDF);
+		assert(*lcp::dna_rep(&character) == *lcp::char_rep(&character) && "Codes should match the alphabet");
+		assert(*lcp::dna_rev_rep(&character) == *lcp::char_rev_rep(&character) && "Codes should match the reverse complement alphabet");
+		assert(lcp::dna_codes[c] == lcp::alphabet[static_cast<unsigned char>(masked)] && "Labels should not depend on the case");
+	}
+
+	size_t lengths[] = {0, 3, 64, 200, SIMD_CHUNK_SIZE + 3, 3 * SIMD_CHUNK_SIZE + 17};
+
+	for (size_t length : lengths) {
+		for (unsigned int seed = 1; seed <= 4; seed++) {
+
+			std::string test_string = generate_mixed(length, seed).substr(0, length);
+			const char *begin = test_string.data(), *end = begin + test_string.size();
+			lcp::rc_iterator rc_begin(end), rc_end(begin);
+
+			std::vector<struct lcp::core> expected, generic, cores, alphabet_cores, rc_expected, rc_cores;
+
+			lcp::lps::parse_chars(begin, end, &expected, lcp::alphabet, lcp::char_gt, lcp::char_lt, lcp::char_eq, lcp::char_index, lcp::char_size, lcp::char_rep, lcp::char_data, false);
+			lcp::lps::parse(begin, end, &generic, 0, lcp::dna_gt, lcp::dna_lt, lcp::dna_eq, lcp::char_index, lcp::dna_size, lcp::dna_rep, lcp::dna_data, false);
+			lcp::lps::parse_chars(begin, end, &cores, lcp::alphabet, lcp::dna_gt, lcp::dna_lt, lcp::dna_eq, lcp::char_index, lcp::dna_size, lcp::dna_rep, lcp::dna_data, false);
+			lcp::lps::parse_alphabet(begin, end, &alphabet_cores, false);
+
+			assert(equal(expected, generic) && equal(expected, cores) && equal(expected, alphabet_cores) && "Compile-time rules should find the same cores");
+
+			lcp::lps::parse_chars(rc_begin, rc_end, &rc_expected, lcp::rc_alphabet, lcp::rc_gt, lcp::rc_lt, lcp::rc_eq, lcp::rc_index, lcp::rc_size, lcp::rc_rep, lcp::rc_data, false);
+			lcp::lps::parse_chars(rc_begin, rc_end, &rc_cores, lcp::rc_alphabet, lcp::dna_rc_gt, lcp::dna_rc_lt, lcp::dna_rc_eq, lcp::rc_index, lcp::dna_rc_size, lcp::dna_rc_rep, lcp::dna_rc_data, false);
+
+			assert(equal(rc_expected, rc_cores) && "Compile-time rules should find the same reverse complement cores");
+		}
+	}
+
+	// custom alphabets fall back to the tables
+	std::map<char, int> map = {{'A', 0}, {'C', 1}, {'G', 2}, {'T', 3}};
+	std::map<char, int> rc_map = {{'A', 3}, {'C', 2}, {'G', 1}, {'T', 0}};
+	lcp::encoding::init(map, rc_map);
+	assert(!lcp::dna_alphabet && "Custom alphabets should use the alphabet tables");
+
+	lcp::encoding::init();
+
+	log("...  test_simd_dna_rules passed!");
+};
+
+int main() {
+
+	log("Running test_simd...");
+
+	test_simd_compare();
+	test_simd_parse();
+	test_simd_parse_range();
+	test_simd_dna_rules();
+
+	log("All tests in test_simd completed successfully!");
+
+	return 0;
+}
@@ -0,0 +1,189 @@
+#include "common.h"
+#include "core_array.h"
+#include "lps.h"
+#include "sketch.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+double exact_jaccard(const lcp::lps &first, const lcp::lps &second) {
+	std::vector<ulabel> labels1, labels2;
+	first.get_labels(labels1);
+	second.get_labels(labels2);
+
+	std::set<ulabel> set1(labels1.begin(), labels1.end()), set2(labels2.begin(), labels2.end());
+	size_t common = 0;
+	for (std::set<ulabel>::iterator it = set1.begin(); it != set1.end(); it++) {
+		common += set2.count(*it);
+	}
+
+	return static_cast<double>(common) / (set1.size() + set2.size() - common);
+};
+
+void test_sketch_parse() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(100000, 42);
+
+	lcp::lps lps_obj(sequence);
+	lps_obj.deepen(3);
+
+	// sketching while parsing gives the sketch of the materialized cores
+	for (size_t size = 0; size <= 500; size += 500) {
+		lcp::sketch streamed(size, 0.5), materialized(size, 0.5);
+		streamed.parse(sequence, 3);
+		materialized.add(lps_obj);
+
+		assert(streamed.hashes == materialized.hashes && "Streamed sketch should match the sketch of the cores");
+		assert((size == 0 || streamed.size() == size) && "Bottom-k sketch should be full");
+		assert(streamed.jaccard(materialized) == 1 && "Identical sketches should have similarity 1");
+
+		for (size_t i = 1; i < streamed.size(); i++) {
+			assert(streamed.hashes[i - 1] < streamed.hashes[i] && streamed.hashes[i] < streamed.threshold && "Hashes should be sorted, distinct and below the threshold");
+		}
+	}
+
+	// core arrays give the same sketch
+	lcp::sketch from_lps, from_array;
+	from_lps.add(lps_obj);
+	from_array.add(lcp::core_array(*lps_obj.cores, lps_obj.level));
+	assert(from_lps.hashes == from_array.hashes && "Core arrays should be sketched like lps");
+
+	log("...  test_sketch_parse passed!");
+};
+
+void test_sketch_similarity() {
+
+	lcp::encoding::init();
+
+	std::string base = generate_sequence(200000, 42);
+	std::string other = base.substr(0, 120000) + generate_sequence(80000, 7);
+
+	lcp::lps first(base), second(other);
+	first.deepen(3);
+	second.deepen(3);
+
+	double expected = exact_jaccard(first, second);
+
+	// unbounded and unscaled sketches are exact
+	lcp::sketch exact1(0), exact2(0);
+	exact1.add(first);
+	exact2.add(second);
+	assert(std::fabs(exact1.jaccard(exact2) - expected) < 1e-12 && "Full sketches should give the exact similarity");
+
+	lcp::sketch bottom1(2000), bottom2(2000);
+	bottom1.parse(base, 3);
+	bottom2.parse(other, 3);
+	assert(std::fabs(bottom1.jaccard(bottom2) - expected) < 0.05 && "Bottom-k estimate should be close");
+
+	lcp::sketch fraction1(0, 0.1), fraction2(0, 0.1);
+	fraction1.parse(base, 3);
+	fraction2.parse(other, 3);
+	assert(std::fabs(fraction1.jaccard(fraction2) - expected) < 0.05 && "Fractional estimate should be close");
+
+	// the shared prefix covers most of the second sequence
+	assert(fraction2.containment(fraction1) > fraction2.jaccard(fraction1) && "Containment should exceed similarity");
+
+	// sketches of different kinds can be compared
+	assert(std::fabs(bottom1.jaccard(fraction2) - expected) < 0.05 && "Mixed estimate should be close");
+
+	log("...  test_sketch_similarity passed!");
+};
+
+void test_sketch_file_io() {
+
+	lcp::encoding::init();
+
+	lcp::sketch sk(300, 0.5);
+	sk.parse(generate_sequence(50000, 42), 2);
+
+	std::string filename = "sketch_test.bin";
+	std::ofstream outfile(filename, std::ios::binary);
+	sk.write(outfile);
+	outfile.close();
+
+	lcp::sketch other;
+	std::ifstream infile(filename, std::ios::binary);
+	assert(other.read(infile) && "Sketch should be read back");
+	infile.close();
+
+	assert(other.hashes == sk.hashes && other.capacity == sk.capacity && other.threshold == sk.threshold && other.level == 2 && "Sketch should match after reading");
+	assert(other.label_flags == sk.label_flags && "Label flags should match after reading");
+
+	std::remove(filename.c_str());
+
+	log("...  test_sketch_file_io passed!");
+};
+
+void test_sketch_label_flags() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(50000, 42);
+
+	lcp::sketch murmur, mix, dictionary;
+
+	lcp::hash::set_backend(lcp::hash::MURMUR);
+	murmur.parse(sequence, 2);
+
+	lcp::hash::set_backend(lcp::hash::MIX);
+	mix.parse(sequence, 2);
+	dictionary.parse(sequence, 2, true);
+
+	lcp::hash::set_backend(LCP_HASH_BACKEND);
+
+	assert(murmur.label_flags == 0 && mix.label_flags == LCPT_MIX && dictionary.label_flags == LCPT_IDS && "Sketches should record how their labels were computed");
+	assert(mix.jaccard(mix) == 1.0 && "Sketches of the same labels should be compared");
+
+	// labels of different functions do not match, comparing them is refused
+	bool refused = false;
+	try {
+		murmur.jaccard(mix);
+	} catch (const std::invalid_argument &) {
+		refused = true;
+	}
+	assert(refused && "Sketches of different label functions should not be compared");
+
+	refused = false;
+	try {
+		dictionary.containment(mix);
+	} catch (const std::invalid_argument &) {
+		refused = true;
+	}
+	assert(refused && "Sketches of dictionary IDs and hashes should not be compared");
+
+	refused = false;
+	try {
+		mix.parse(sequence, 2, true);
+	} catch (const std::invalid_argument &) {
+		refused = true;
+	}
+	assert(refused && "Labels computed differently should not be added to a sketch");
+
+	log("...  test_sketch_label_flags passed!");
+};
+
+int main() {
+
+	log("Running test_sketch...");
+
+	test_sketch_parse();
+	test_sketch_similarity();
+	test_sketch_file_io();
+	test_sketch_label_flags();
+
+	log("All tests in test_sketch completed successfully!");
+
+	return 0;
+}
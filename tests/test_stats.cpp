@@ -0,0 +1,191 @@
+#include "common.h"
+#include "core_array.h"
+#include "lps.h"
+#include "stats.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+void test_stats_levels() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(200000, 42);
+
+	lcp::stats::reset();
+	lcp::stats::enable();
+
+	// sizes of every level, deepened one level at a time
+	std::vector<size_t> sizes(1, 0);
+	lcp::lps lps_obj(sequence);
+	sizes.push_back(lps_obj.size());
+	for (int level = 2; level <= 4; level++) {
+		lps_obj.deepen(level);
+		sizes.push_back(lps_obj.size());
+	}
+
+	lcp::stats::enable(false);
+	lcp::stats::counters counts = lcp::stats::total();
+
+	for (int level = 1; level <= 4; level++) {
+		const lcp::stats::level &curr = counts.levels[level];
+
+		assert(curr.cores == sizes[level] && "Emitted cores should match the size of the level");
+		assert(curr.runs + curr.lmin + curr.lmax + curr.sseq == curr.cores && "Every core should be produced by a rule");
+		assert(0 < curr.lmin && 0 < curr.lmax && "Local minima and maxima should be found");
+		assert(0 < curr.parse_ns && 0 < curr.bytes && "Parsing should be timed and sized");
+		assert((level == 1 || 0 < curr.dct_ns) && "Compression should be timed");
+	}
+
+	assert(counts.levels[0].cores == 0 && counts.levels[5].cores == 0 && "Other levels should not be counted");
+
+	// core arrays are counted the same way
+	lcp::stats::reset();
+	lcp::stats::enable();
+
+	lcp::core_array cores(sequence);
+	cores.deepen(4);
+
+	lcp::stats::enable(false);
+
+	lcp::stats::counters array_counts = lcp::stats::total();
+	for (int level = 1; level <= 4; level++) {
+		assert(array_counts.levels[level].cores == counts.levels[level].cores && array_counts.levels[level].lmin == counts.levels[level].lmin && "Core arrays should emit the same cores by the same rules");
+	}
+
+	std::ostringstream out;
+	lcp::stats::print(out);
+	assert(out.str().find("cores_map") != std::string::npos && "Summary should list the dictionaries");
+
+	log("...  test_stats_levels passed!");
+};
+
+void test_stats_disabled() {
+
+	lcp::encoding::init();
+
+	lcp::stats::reset();
+
+	std::string sequence = generate_sequence(50000, 7);
+	lcp::lps lps_obj(sequence, true);
+	lps_obj.deepen(3, true);
+
+	lcp::stats::counters counts = lcp::stats::total();
+
+	for (int level = 0; level < STATS_LEVEL_COUNT; level++) {
+		assert(counts.levels[level].cores == 0 && counts.levels[level].parse_ns == 0 && "Disabled instrumentation should not count");
+	}
+	assert(counts.maps[lcp::stats::STR_MAP].lookups == 0 && counts.maps[lcp::stats::CORES_MAP].lookups == 0 && "Disabled instrumentation should not count lookups");
+
+	log("...  test_stats_disabled passed!");
+};
+
+void test_stats_dictionary() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(100000, 11);
+
+	lcp::stats::reset();
+	lcp::stats::enable();
+
+	lcp::lps lps_obj(sequence, true);
+	lps_obj.deepen(3, true);
+
+	lcp::stats::enable(false);
+	lcp::stats::counters counts = lcp::stats::total();
+
+	// every core is labelled by one lookup, level 1 cores in the string dictionary
+	const lcp::stats::dictionary &strs = counts.maps[lcp::stats::STR_MAP];
+	const lcp::stats::dictionary &cores = counts.maps[lcp::stats::CORES_MAP];
+
+	assert(strs.lookups == counts.levels[1].cores && "Level 1 cores should be looked up in the string dictionary");
+	assert(cores.lookups == counts.levels[2].cores + counts.levels[3].cores && "Deeper cores should be looked up in the core dictionary");
+	// the dictionaries are shared by every test, short strings are already known
+	assert(strs.inserts <= strs.lookups && 0 < cores.inserts && cores.inserts <= cores.lookups && "Insertions should not exceed lookups");
+	assert(strs.lookups <= strs.probes && 1 <= strs.max_probe && cores.lookups <= cores.probes && "Every lookup should probe a slot");
+	assert(strs.lock_waits == 0 && cores.lock_waits == 0 && "A single thread should never wait");
+
+	log("...  test_stats_dictionary passed!");
+};
+
+void test_stats_threads() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(400000, 23);
+
+	lcp::stats::reset();
+	lcp::stats::enable();
+
+	// threads are joined before the constructor returns, their counters are kept
+	lcp::lps lps_obj(sequence, 4, 50000, 5000, 4, false);
+
+	lcp::stats::enable(false);
+	lcp::stats::counters counts = lcp::stats::total();
+
+	// overlapping segments parse some cores twice
+	assert(lps_obj.size() <= counts.levels[4].cores && "Cores of every thread should be counted");
+	assert(counts.levels[4].cores < 2 * lps_obj.size() && "Overlaps should be small");
+
+	log("...  test_stats_threads passed!");
+};
+
+void test_stats_concurrent_total() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(100000, 29);
+
+	lcp::stats::reset();
+	lcp::stats::enable();
+
+	// totals are taken while another thread counts
+	std::atomic<bool> parsing(true);
+	std::thread parser([&]() {
+		for (int round = 0; round < 5; round++) {
+			lcp::lps lps_obj(sequence);
+			lps_obj.deepen(4);
+		}
+		parsing = false;
+	});
+
+	uint64_t seen = 0;
+	while (parsing) {
+		uint64_t cores = lcp::stats::total().levels[1].cores;
+		assert(seen <= cores && "Totals should only grow while nothing is reset");
+		seen = cores;
+	}
+	parser.join();
+
+	lcp::stats::enable(false);
+	assert(seen <= lcp::stats::total().levels[1].cores && "Counters of finished threads should be kept");
+
+	lcp::stats::reset();
+	assert(lcp::stats::total().levels[1].cores == 0 && lcp::stats::local().levels[1].cores == 0 && "Reset should clear every counter");
+
+	log("...  test_stats_concurrent_total passed!");
+};
+
+int main() {
+
+	log("Running test_stats...");
+
+	test_stats_levels();
+	test_stats_disabled();
+	test_stats_dictionary();
+	test_stats_threads();
+	test_stats_concurrent_total();
+
+	log("All tests in test_stats completed successfully!");
+
+	return 0;
+}
@@ -0,0 +1,178 @@
+#include "common.h"
+#include "core_array.h"
+#include "encoding.h"
+#include "writer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+void log(const std::string &message) {
+	std::cout << message << std::endl;
+};
+
+void test_writer_order() {
+
+	std::vector<std::string> chunks;
+	std::string expected;
+	lcg random(7);
+
+	// chunks from a few bytes up to several buffers
+	for (size_t i = 0; i < 500; i++) {
+		size_t length = random.below(i % 50 == 0 ? 5000 : 300);
+		std::string chunk(length, static_cast<char>('a' + i % 26));
+		chunks.push_back(chunk);
+		expected += chunk;
+	}
+
+	for (size_t buffer_size : {1, 64, 1000, 1 << 20}) {
+		for (size_t buffer_count : {0, 2, 5}) {
+			std::ostringstream out;
+			{
+				lcp::writer output(out, buffer_size, buffer_count);
+				for (const std::string &chunk : chunks) {
+					output.write(chunk);
+				}
+				assert(output.size() == expected.size() && "Size should count every byte written");
+			}
+			assert(out.str() == expected && "Bytes should reach the stream in order");
+		}
+	}
+
+	// flushing makes everything written so far visible
+	std::ostringstream out;
+	lcp::writer output(out, 1 << 20);
+	output.write("lcp", 3);
+	assert(output.flush() && out.str() == "lcp" && "Flushed bytes should reach the stream");
+	output.write("tools", 5);
+	assert(output.finish() && out.str() == "lcptools" && "Remaining bytes should be written at the end");
+
+	log("...  test_writer_order passed!");
+};
+
+void test_writer_filter() {
+
+	// every buffer is prefixed by its length
+	auto prefix = [](const std::string &buffer, std::string &filtered) {
+		uint64_t length = buffer.size();
+		filtered.append(reinterpret_cast<const char *>(&length), sizeof(length));
+		filtered.append(buffer);
+	};
+
+	std::string expected;
+	std::ostringstream out;
+	{
+		lcp::writer output(out, 100, 3, prefix);
+		for (size_t i = 0; i < 1000; i++) {
+			std::string chunk(i % 37, static_cast<char>('A' + i % 26));
+			output.write(chunk);
+			expected += chunk;
+		}
+	}
+
+	std::string filtered = out.str(), restored;
+	size_t position = 0;
+	while (position < filtered.size()) {
+		uint64_t length;
+		memcpy(&length, filtered.data() + position, sizeof(length));
+		assert(length != 0 && "Empty buffers should not be written");
+		position += sizeof(length);
+		restored.append(filtered, position, length);
+		position += length;
+	}
+
+	assert(position == filtered.size() && restored == expected && "Every buffer should be filtered on its own");
+
+	log("...  test_writer_filter passed!");
+};
+
+void test_writer_records() {
+
+	lcp::encoding::init();
+
+	std::vector<lcp::core_array> records;
+	std::string expected;
+
+	for (unsigned int seed = 1; seed <= 20; seed++) {
+		std::string sequence = generate_sequence(1000 * seed, seed);
+		records.emplace_back(sequence);
+		records.back().deepen(3);
+		records.back().write(expected, "read" + std::to_string(seed));
+	}
+
+	std::ostringstream out;
+	{
+		// buffers smaller than most records
+		lcp::writer output(out, 4096, 2);
+		for (size_t index = 0; index < records.size(); index++) {
+			records[index].write(output, "read" + std::to_string(index + 1));
+		}
+		assert(output.size() == expected.size() && "Records should be counted");
+	}
+
+	assert(out.str() == expected && "Records should match direct serialization");
+
+	log("...  test_writer_records passed!");
+};
+
+void test_writer_large() {
+
+	lcp::encoding::init();
+
+	std::string sequence = generate_sequence(50000, 67);
+	lcp::core_array cores(sequence);
+	cores.deepen(2);
+
+	std::string record;
+	cores.write(record, "large");
+
+	// sizes of the buffers reaching the stream
+	std::vector<size_t> sizes;
+	auto measure = [&sizes](const std::string &buffer, std::string &filtered) {
+		sizes.push_back(buffer.size());
+		filtered.append(buffer);
+	};
+
+	const size_t buffer_size = 4096;
+	std::string moved(3 * buffer_size + 5, 'm'), copied(5 * buffer_size + 7, 'c');
+	std::string expected = "head" + moved + copied + record + "tail";
+
+	std::ostringstream out;
+	{
+		lcp::writer output(out, buffer_size, 2, measure);
+		output.write("head", 4);
+		output.write(std::string(moved));
+		output.write(copied);
+		cores.write(output, "large");
+		output.write(std::string("tail"));
+		assert(output.size() == expected.size() && "Size should count every byte written");
+	}
+
+	assert(out.str() == expected && "Large payloads should reach the stream in order");
+
+	// large payloads are written as they are, everything else in buffers of at most buffer_size
+	for (size_t size : sizes) {
+		assert((size <= buffer_size || size == moved.size() || size == record.size()) && "Large payloads should not be collected in buffers");
+	}
+	assert(std::count(sizes.begin(), sizes.end(), moved.size()) == 1 && std::count(sizes.begin(), sizes.end(), record.size()) == 1 && "Moved strings and large records should be written on their own");
+
+	log("...  test_writer_large passed!");
+};
+
+int main() {
+
+	log("Running test_writer...");
+
+	test_writer_order();
+	test_writer_filter();
+	test_writer_records();
+	test_writer_large();
+
+	log("All tests in test_writer completed successfully!");
+
+	return 0;
+};
@@ -0,0 +1,168 @@
+#include "writer.h"
+#include <algorithm>
+
+namespace lcp {
+
+	writer::writer(std::ostream &out, size_t buffer_size, size_t buffer_count, filter fn)
+		: out(out), fn(fn), buffer_size(buffer_size < 1 ? 1 : buffer_size), written(0), buffers(buffer_count < 2 ? 2 : buffer_count), pending(0), stopped(false), failed(false) {
+
+		this->current = &this->buffers[0];
+		for (size_t index = 1; index < this->buffers.size(); index++) {
+			this->free.push_back(&this->buffers[index]);
+		}
+
+		this->thread = std::thread([this]() { this->run(); });
+	};
+
+	writer::~writer() {
+		this->finish();
+	};
+
+	void writer::write(const char *data, size_t length) {
+		this->written += length;
+
+		// the current buffer is handed off whenever it is full, so it never grows past buffer_size
+		while (0 < length) {
+			size_t part = std::min(length, this->buffer_size - this->current->size());
+			this->current->append(data, part);
+			data += part;
+			length -= part;
+
+			if (this->buffer_size <= this->current->size()) {
+				this->hand_off();
+			}
+		}
+	};
+
+	void writer::write(const std::string &data) {
+		this->write(data.data(), data.size());
+	};
+
+	void writer::write(std::string &&data) {
+
+		if (data.size() < this->buffer_size) {
+			this->write(data.data(), data.size());
+			return;
+		}
+
+		this->written += data.size();
+
+		// the bytes before it are handed off first, then the string takes the place of an empty buffer
+		this->hand_off();
+		this->current->swap(data);
+		this->hand_off();
+	};
+
+	void writer::write(const struct lcpt::record &rec) {
+		size_t size = lcpt::record_size(rec);
+
+		if (this->buffer_size <= size) {
+			std::string data;
+			data.reserve(size);
+			lcpt::write(data, rec);
+			this->write(std::move(data));
+			return;
+		}
+
+		if (this->buffer_size - this->current->size() < size) {
+			this->hand_off();
+		}
+
+		lcpt::write(*this->current, rec);
+		this->written += size;
+
+		if (this->buffer_size <= this->current->size()) {
+			this->hand_off();
+		}
+	};
+
+	bool writer::flush() {
+		this->hand_off();
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->released.wait(lock, [this]() { return this->pending == 0; });
+		this->out.flush();
+
+		return !this->failed && this->out.good();
+	};
+
+	bool writer::finish() {
+
+		if (this->stopped) {
+			return !this->failed;
+		}
+
+		bool good = this->flush();
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stopped = true;
+		}
+		this->ready.notify_one();
+		this->thread.join();
+
+		return good;
+	};
+
+	size_t writer::size() const {
+		return this->written;
+	};
+
+	void writer::hand_off() {
+
+		if (this->current->empty()) {
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->full.push_back(this->current);
+		this->pending++;
+		this->ready.notify_one();
+
+		// blocks while every other buffer is waiting to be written
+		this->released.wait(lock, [this]() { return !this->free.empty(); });
+		this->current = this->free.front();
+		this->free.pop_front();
+	};
+
+	void writer::run() {
+		std::string filtered;
+
+		while (true) {
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->ready.wait(lock, [this]() { return this->stopped || !this->full.empty(); });
+
+			if (this->full.empty()) {
+				return;
+			}
+
+			std::string *buffer = this->full.front();
+			this->full.pop_front();
+			lock.unlock();
+
+			if (this->fn) {
+				filtered.clear();
+				this->fn(*buffer, filtered);
+				this->out.write(filtered.data(), filtered.size());
+			} else {
+				this->out.write(buffer->data(), buffer->size());
+			}
+
+			// the capacity is kept for the next round, unless the buffer held a payload of its own
+			if (2 * this->buffer_size < buffer->capacity()) {
+				std::string().swap(*buffer);
+			} else {
+				buffer->clear();
+			}
+
+			lock.lock();
+			this->failed = this->failed || !this->out;
+			this->free.push_back(buffer);
+			this->pending--;
+			lock.unlock();
+
+			this->released.notify_all();
+		}
+	};
+
+}; // namespace lcp
@@ -0,0 +1,164 @@
+/**
+ * @file writer.h
+ * @brief Asynchronous buffered output of .lcpt records.
+ *
+ * Records are serialized into large buffers on the calling thread, and full
+ * buffers are written to the stream by a background thread, so the output of a
+ * record overlaps with parsing the next one, also when parsing is serial. A
+ * fixed number of buffers grows once and is recycled: when every buffer is
+ * waiting to be written, writing blocks until the stream catches up, so memory
+ * stays bounded when the output is slower than parsing, e.g. on network file
+ * systems. Bytes reach the stream in the order they were written.
+ *
+ * Payloads of a buffer or more, e.g. the record of a chromosome, are never
+ * collected in a buffer: records are serialized into memory of their own,
+ * strings passed by rvalue are handed to the background thread as they are,
+ * and other bytes are copied in pieces of a buffer. A buffer holding more than
+ * twice `buffer_size` is freed once it is written, so the buffers never keep
+ * the memory of the largest record seen.
+ *
+ * A filter can be passed to transform every full buffer before it is written,
+ * e.g. a zstd or lz4 frame compressor. Each buffer is filtered on its own, so a
+ * compressor producing one frame per buffer yields a valid compressed stream of
+ * the .lcpt file, which has to be decompressed before it is read.
+ *
+ * Example usage:
+ * @code
+ *   std::ofstream out("genome.fa.lcpt", std::ios::binary);
+ *   lcp::writer output(out);
+ *   for (...) {
+ *       lcp::core_array cores(sequence);
+ *       cores.deepen(4);
+ *       cores.write(output, name);
+ *   }
+ *   output.finish();
+ * @endcode
+ *
+ * @see lcpt.h
+ *
+ * @namespace lcp
+ * @struct writer
+ *
+ */
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include "constant.h"
+#include "lcpt.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lcp {
+
+	struct writer {
+	  public:
+		/**
+		 * @brief Function transforming a full buffer into the bytes written to the stream.
+		 *
+		 * Called from the background thread with the buffer and an output string that is
+		 * empty, and reused from call to call.
+		 */
+		typedef std::function<void(const std::string &, std::string &)> filter;
+
+		/**
+		 * @brief Starts the background thread writing to a stream.
+		 *
+		 * @param out The output stream, which must outlive the writer.
+		 * @param buffer_size The number of bytes collected before a buffer is written, at least 1.
+		 * @param buffer_count The number of buffers, at least 2.
+		 * @param fn (Optional) The filter applied to every buffer before it is written.
+		 */
+		writer(std::ostream &out, size_t buffer_size = WRITER_BUFFER_SIZE, size_t buffer_count = WRITER_BUFFER_COUNT, filter fn = nullptr);
+
+		/**
+		 * @brief Writes the remaining bytes and stops the background thread.
+		 */
+		~writer();
+
+		writer(const struct writer &other) = delete;
+		struct writer &operator=(const struct writer &other) = delete;
+
+		/**
+		 * @brief Appends bytes, handing the buffer to the background thread once it is full.
+		 *
+		 * @param data The bytes.
+		 * @param length The number of bytes.
+		 */
+		void write(const char *data, size_t length);
+
+		/**
+		 * @brief Appends bytes, see above.
+		 *
+		 * @param data The bytes.
+		 */
+		void write(const std::string &data);
+
+		/**
+		 * @brief Appends bytes, handing a string of `buffer_size` or more bytes to the background
+		 * thread without copying it.
+		 *
+		 * @param data The bytes, left in an unspecified state.
+		 */
+		void write(std::string &&data);
+
+		/**
+		 * @brief Serializes a record directly into the buffer, or into a string of its own handed to
+		 * the background thread if it takes `buffer_size` or more bytes.
+		 *
+		 * @param rec The record.
+		 */
+		void write(const struct lcpt::record &rec);
+
+		/**
+		 * @brief Waits until every byte written so far has reached the stream.
+		 *
+		 * @return False if the stream failed.
+		 */
+		bool flush();
+
+		/**
+		 * @brief Writes the remaining bytes and stops the background thread.
+		 *
+		 * Nothing can be written afterwards. Called by the destructor if it was not called before.
+		 *
+		 * @return False if the stream failed.
+		 */
+		bool finish();
+
+		/**
+		 * @brief Returns the number of bytes written to the writer.
+		 */
+		size_t size() const;
+
+	  private:
+		std::ostream &out;
+		filter fn;
+		size_t buffer_size;
+		size_t written;
+		std::vector<std::string> buffers;
+		std::string *current;
+		std::deque<std::string *> free;
+		std::deque<std::string *> full;
+		size_t pending;
+		bool stopped;
+		bool failed;
+		std::mutex mutex;
+		std::condition_variable ready;
+		std::condition_variable released;
+		std::thread thread;
+
+		void hand_off();
+
+		void run();
+	};
+
+}; // namespace lcp
+
+#endif